@@ -56,6 +56,67 @@ namespace zypp::proto::target
       return fData;
     };
 
+    // Serializes the transaction steps into the body of a Commit or CommitSteps message
+    void serializeSteps ( ByteArray &body, const std::vector<TransactionStep> &steps ) {
+      for ( const auto &step : steps ) {
+        if ( std::holds_alternative<InstallStep>(step) ) {
+          const InstallStep &value = std::get<InstallStep>(step);
+          body.push_back( Commit::InstallStepType );
+          serializeStepField( body, value.stepId );
+          serializeStepField( body, value.pathname );
+          serializeStepField( body, value.multiversion );
+
+        } else if ( std::holds_alternative<RemoveStep>(step) ) {
+          const RemoveStep &value = std::get<RemoveStep>(step);
+          body.push_back( Commit::RemoveStepType );
+          serializeStepField( body, value.stepId  );
+          serializeStepField( body, value.name    );
+          serializeStepField( body, value.version );
+          serializeStepField( body, value.release );
+          serializeStepField( body, value.arch    );
+        } else {
+          ZYPP_THROW( zypp::PluginFrameException("Unknown Step type in message") );
+        }
+      }
+      body.shrink_to_fit();
+    }
+
+    // Parses the transaction steps from the body of a Commit or CommitSteps message
+    // steps are serialized into a very simple form, starting with one byte that tells us what step type we look at
+    // <stepType><step fields seperated by \0>
+    void parseSteps ( const ByteArray &data, std::vector<TransactionStep> &steps ) {
+      for ( auto i = data.begin(); i != data.end(); ) {
+        uint8_t stepType = *i;
+        i++;
+
+        if ( i == data.end() )
+          ZYPP_THROW( zypp::PluginFrameException("Invalid data in commit message") );
+
+        switch ( stepType ) {
+          case Commit::InstallStepType: {
+            InstallStep s;
+            zyppng::rpc::parseDataIntoField( fetchTerminatedField(i, data.end() ), s.stepId       );
+            zyppng::rpc::parseDataIntoField( fetchTerminatedField(i, data.end() ), s.pathname     );
+            zyppng::rpc::parseDataIntoField( fetchTerminatedField(i, data.end() ), s.multiversion );
+            steps.push_back(s);
+            break;
+          }
+          case Commit::RemoveStepType: {
+            RemoveStep s;
+            zyppng::rpc::parseDataIntoField( fetchTerminatedField(i, data.end() ), s.stepId  );
+            zyppng::rpc::parseDataIntoField( fetchTerminatedField(i, data.end() ), s.name    );
+            zyppng::rpc::parseDataIntoField( fetchTerminatedField(i, data.end() ), s.version );
+            zyppng::rpc::parseDataIntoField( fetchTerminatedField(i, data.end() ), s.release );
+            zyppng::rpc::parseDataIntoField( fetchTerminatedField(i, data.end() ), s.arch    );
+            steps.push_back(s);
+            break;
+          }
+          default:
+            ZYPP_THROW( zypp::PluginFrameException("Invalid step type in commit message") );
+        }
+      }
+    }
+
     template <typename T>
     using has_stepid = decltype(std::declval<T>().stepId);
 
@@ -109,28 +170,21 @@ namespace zypp::proto::target
     f.addHeader ("lockFilePath", lockFilePath );
     f.addHeader ("ignoreArch", ignoreArch ? "1" : "0" );
 
+    if ( streamed ) {
+      f.addHeader ("streamed", "1" );
+      f.addHeader ("stepCount", asString (stepCount) );
+    }
+
+    if ( progressRing )
+      f.addHeader ("progressRing", "1" );
+
     ByteArray &body = f.bodyRef();
-    for ( const auto &step : transactionSteps ) {
-      if ( std::holds_alternative<InstallStep>(step) ) {
-        const InstallStep &value = std::get<InstallStep>(step);
-        body.push_back( InstallStepType );
-        serializeStepField( body, value.stepId );
-        serializeStepField( body, value.pathname );
-        serializeStepField( body, value.multiversion );
-
-      } else if ( std::holds_alternative<RemoveStep>(step) ) {
-        const RemoveStep &value = std::get<RemoveStep>(step);
-        body.push_back( RemoveStepType );
-        serializeStepField( body, value.stepId  );
-        serializeStepField( body, value.name    );
-        serializeStepField( body, value.version );
-        serializeStepField( body, value.release );
-        serializeStepField( body, value.arch    );
-      } else {
-        return zyppng::expected<PluginFrame>::error( ZYPP_EXCPT_PTR( zypp::PluginFrameException("Unknown Step type in message") ) );
-      }
+    try {
+      serializeSteps( body, transactionSteps );
+    } catch ( const zypp::Exception &e ) {
+      ZYPP_CAUGHT (e);
+      return zyppng::expected<PluginFrame>::error( ZYPP_EXCPT_PTR(e) );
     }
-    body.shrink_to_fit();
     return zyppng::expected<PluginFrame>::success ( std::move(f) );
   }
 
@@ -149,45 +203,16 @@ namespace zypp::proto::target
       zyppng::rpc::parseHeaderIntoField ( msg, "lockFilePath", c.lockFilePath );
       zyppng::rpc::parseHeaderIntoField ( msg, "ignoreArch", c.ignoreArch );
 
-      // we got the fields, lets parse the steps
-      // steps are serialized into a very simple form, starting with one byte that tells us what step type we look at
-      // <stepType><step fields seperated by \0>
-      enum ParseState {
-        ReadingStepType,
-        Reading
-      };
-
-      const auto &data = msg.body ();
-      for ( auto i = data.begin(); i != data.end(); ) {
-        uint8_t stepType = *i;
-        i++;
+      if ( msg.hasKey( "streamed" ) ) {
+        zyppng::rpc::parseHeaderIntoField ( msg, "streamed", c.streamed );
+        zyppng::rpc::parseHeaderIntoField ( msg, "stepCount", c.stepCount );
+      }
 
-        if ( i == data.end() )
-          return zyppng::expected<Commit>::error( ZYPP_EXCPT_PTR( zypp::PluginFrameException("Invalid data in commit message") ) );
+      if ( msg.hasKey( "progressRing" ) )
+        zyppng::rpc::parseHeaderIntoField ( msg, "progressRing", c.progressRing );
 
-        switch ( stepType ) {
-          case InstallStepType: {
-            InstallStep s;
-            zyppng::rpc::parseDataIntoField( fetchTerminatedField(i, data.end() ), s.stepId       );
-            zyppng::rpc::parseDataIntoField( fetchTerminatedField(i, data.end() ), s.pathname     );
-            zyppng::rpc::parseDataIntoField( fetchTerminatedField(i, data.end() ), s.multiversion );
-            c.transactionSteps.push_back(s);
-            break;
-          }
-          case RemoveStepType: {
-            RemoveStep s;
-            zyppng::rpc::parseDataIntoField( fetchTerminatedField(i, data.end() ), s.stepId  );
-            zyppng::rpc::parseDataIntoField( fetchTerminatedField(i, data.end() ), s.name    );
-            zyppng::rpc::parseDataIntoField( fetchTerminatedField(i, data.end() ), s.version );
-            zyppng::rpc::parseDataIntoField( fetchTerminatedField(i, data.end() ), s.release );
-            zyppng::rpc::parseDataIntoField( fetchTerminatedField(i, data.end() ), s.arch    );
-            c.transactionSteps.push_back(s);
-            break;
-          }
-          default:
-            return zyppng::expected<Commit>::error( ZYPP_EXCPT_PTR( zypp::PluginFrameException("Invalid step type in commit message") ) );
-        }
-      }
+      // we got the fields, lets parse the steps
+      parseSteps( msg.body(), c.transactionSteps );
 
       return zyppng::expected<Commit>::success ( std::move(c) );
 
@@ -197,6 +222,36 @@ namespace zypp::proto::target
     }
   }
 
+  zyppng::expected<PluginFrame> CommitSteps::toStompMessage() const
+  {
+    try {
+      PluginFrame f = zyppng::rpc::prepareFrame<CommitSteps>();
+      serializeSteps( f.bodyRef(), transactionSteps );
+      return zyppng::expected<PluginFrame>::success ( std::move(f) );
+    } catch ( const zypp::Exception &e ) {
+      ZYPP_CAUGHT (e);
+      return zyppng::expected<PluginFrame>::error( ZYPP_EXCPT_PTR(e) );
+    }
+  }
+
+  zyppng::expected<CommitSteps> CommitSteps::fromStompMessage( const zypp::PluginFrame &msg )
+  {
+    try {
+      CommitSteps c;
+      if ( msg.command() != CommitSteps::typeName )
+        return zyppng::expected<CommitSteps>::error( ZYPP_EXCPT_PTR( zypp::PluginFrameException("Message is not a CommitSteps") ) );
+
+      parseSteps( msg.body(), c.transactionSteps );
+      return zyppng::expected<CommitSteps>::success( std::move(c) );
+
+    } catch ( const zypp::Exception &e ) {
+      ZYPP_CAUGHT (e);
+      return zyppng::expected<CommitSteps>::error( ZYPP_EXCPT_PTR(e) );
+    }
+  }
+
+  IMPL_TRIVIAL_MESSAGE(CommitStepsDone)
+
   zyppng::expected<PluginFrame> TransactionError::toStompMessage() const
   {
     PluginFrame f = zyppng::rpc::prepareFrame<TransactionError>();
@@ -253,6 +308,34 @@ namespace zypp::proto::target
     }
   }
 
+  zyppng::expected<PluginFrame> HeaderPreread::toStompMessage() const
+  {
+    PluginFrame f = zyppng::rpc::prepareFrame<HeaderPreread>();
+    f.addHeader ("headers", asString (headers) );
+    f.addHeader ("threads", asString (threads) );
+    f.addHeader ("milliseconds", asString (milliseconds) );
+    return zyppng::expected<PluginFrame>::success ( std::move(f) );
+  }
+
+  zyppng::expected<HeaderPreread> HeaderPreread::fromStompMessage(const PluginFrame &msg)
+  {
+    try {
+      HeaderPreread c;
+      if ( msg.command() != HeaderPreread::typeName )
+        return zyppng::expected<HeaderPreread>::error( ZYPP_EXCPT_PTR( zypp::PluginFrameException("Message is not a HeaderPreread") ) );
+
+      zyppng::rpc::parseHeaderIntoField ( msg, "headers", c.headers );
+      zyppng::rpc::parseHeaderIntoField ( msg, "threads", c.threads );
+      zyppng::rpc::parseHeaderIntoField ( msg, "milliseconds", c.milliseconds );
+
+      return zyppng::expected<HeaderPreread>::success( std::move(c) );
+
+    } catch ( const zypp::Exception &e ) {
+      ZYPP_CAUGHT (e);
+      return zyppng::expected<HeaderPreread>::error( ZYPP_EXCPT_PTR(e) );
+    }
+  }
+
   IMPL_TRIVIAL_MESSAGE(PackageBegin)
   IMPL_TRIVIAL_MESSAGE(PackageFinished)
   IMPL_TRIVIAL_MESSAGE(PackageError)
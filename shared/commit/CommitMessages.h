@@ -47,6 +47,15 @@ namespace zypp::proto::target
 
   // first message that is sent to zypp-rpm
   // to setup the commit basics.
+  //
+  // If streamed is set, the transactionSteps are not part of the Commit message but
+  // follow in one or more CommitSteps messages while libzypp is still downloading the
+  // packages. zypp-rpm adds them to the transaction as they arrive. The last CommitSteps
+  // message is followed by a CommitStepsDone message, then the transaction is executed.
+  // stepCount is the maximum number of steps that will be sent.
+  //
+  // If progressRing is set, a 3rd FD refers to the shared memory of a ProgressRing
+  // that zypp-rpm should use for high frequency events.
   struct Commit
   {
     Commit() = default;
@@ -67,12 +76,34 @@ namespace zypp::proto::target
     std::string dbPath;
     std::string lockFilePath;
     bool   ignoreArch;
+    bool   streamed = false;
+    uint32_t stepCount = 0;
+    bool   progressRing = false;
     std::vector<TransactionStep> transactionSteps;
 
     zyppng::expected<zypp::PluginFrame> toStompMessage() const;
     static zyppng::expected<Commit> fromStompMessage( const zypp::PluginFrame &msg );
   };
 
+  // more transaction steps of a streamed Commit
+  struct CommitSteps
+  {
+    static constexpr std::string_view typeName = "CommitSteps";
+    std::vector<TransactionStep> transactionSteps;
+
+    zyppng::expected<zypp::PluginFrame> toStompMessage() const;
+    static zyppng::expected<CommitSteps> fromStompMessage( const zypp::PluginFrame &msg );
+  };
+
+  // all steps of a streamed Commit were sent
+  struct CommitStepsDone
+  {
+    static constexpr std::string_view typeName = "CommitStepsDone";
+
+    zyppng::expected<zypp::PluginFrame> toStompMessage() const;
+    static zyppng::expected<CommitStepsDone> fromStompMessage( const zypp::PluginFrame &msg );
+  };
+
 
   // message written to zypper when the transaction has failed
   struct TransactionError {
@@ -94,6 +125,18 @@ namespace zypp::proto::target
 
   };
 
+  // statistics about reading the package headers in parallel before the transaction
+  // elements are added, only sent if the headers were actually read in parallel
+  struct HeaderPreread {
+    static constexpr std::string_view typeName = "HeaderPreread";
+    uint32_t headers = 0;
+    uint32_t threads = 0;
+    uint32_t milliseconds = 0;
+
+    zyppng::expected<zypp::PluginFrame> toStompMessage() const;
+    static zyppng::expected<HeaderPreread> fromStompMessage( const zypp::PluginFrame &msg );
+  };
+
   // Per package information which directly correspond to a TransactionStep !!!!
   struct PackageBegin {
     static constexpr std::string_view typeName = "PackageBegin";
@@ -0,0 +1,249 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+#include "ProgressRing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <new>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace zypp::proto::target
+{
+  namespace {
+    constexpr uint32_t ringMagic = 0x5a525047; // "ZRPG"
+
+    // on ring layout of an event, followed by the text and padded to 8 bytes
+    struct RecordHead {
+      uint32_t len;   // size of the whole record
+      uint8_t type;
+      uint8_t pad[3];
+      uint32_t msgSeq;
+      uint32_t stepId;
+      uint32_t amount;
+      uint32_t level;
+      uint32_t textlen;
+    };
+
+    inline uint32_t roundUpPow2( uint32_t val )
+    {
+      uint32_t ret = 4096;
+      while ( ret < val )
+        ret <<= 1;
+      return ret;
+    }
+  }
+
+  ProgressEvent::ProgressEvent( const PackageProgress &msg )
+    : type( PackageProgressType ), stepId( msg.stepId ), amount( msg.amount )
+  {}
+
+  ProgressEvent::ProgressEvent( const CleanupProgress &msg )
+    : type( CleanupProgressType ), amount( msg.amount ), text( msg.nvra )
+  {}
+
+  ProgressEvent::ProgressEvent( const TransProgress &msg )
+    : type( TransProgressType ), amount( msg.amount )
+  {}
+
+  ProgressEvent::ProgressEvent( const RpmLog &msg )
+    : type( RpmLogType ), level( msg.level ), text( msg.line )
+  {}
+
+  ProgressEvent::Message ProgressEvent::toMessage() const
+  {
+    switch ( type ) {
+      case PackageProgressType:
+        return PackageProgress { stepId, amount };
+      case CleanupProgressType:
+        return CleanupProgress { text, amount };
+      case TransProgressType:
+        return TransProgress { amount };
+      case RpmLogType:
+        break;
+    }
+    return RpmLog { level, text };
+  }
+
+  // shared between both processes, the data follows on the next page
+  struct ProgressRing::Header {
+    uint32_t magic;
+    uint32_t capacity;                        // size of the data area, a power of 2
+    alignas(64) std::atomic<uint64_t> head;   // bytes written, advanced by the producer
+    alignas(64) std::atomic<uint64_t> tail;   // bytes consumed, advanced by the consumer
+  };
+  static_assert( std::atomic<uint64_t>::is_always_lock_free, "ProgressRing needs lock-free 64bit atomics" );
+
+  namespace {
+    constexpr size_t dataOffset = 4096;
+  }
+
+  ProgressRing::ProgressRing( ProgressRing &&other ) noexcept
+  { swap( other ); }
+
+  ProgressRing &ProgressRing::operator=( ProgressRing &&other ) noexcept
+  {
+    ProgressRing tmp( std::move(other) );
+    swap( tmp );
+    return *this;
+  }
+
+  ProgressRing::~ProgressRing()
+  {
+    if ( _hdr )
+      ::munmap( _hdr, _mapsize );
+    if ( _fd != -1 )
+      ::close( _fd );
+  }
+
+  void ProgressRing::swap( ProgressRing &other ) noexcept
+  {
+    std::swap( _hdr, other._hdr );
+    std::swap( _data, other._data );
+    std::swap( _mapsize, other._mapsize );
+    std::swap( _fd, other._fd );
+  }
+
+  ProgressRing ProgressRing::create( uint32_t capacity )
+  {
+    ProgressRing ret;
+    capacity = roundUpPow2( capacity );
+
+    // no MFD_CLOEXEC, the fd is passed to zypp-rpm
+    ret._fd = ::memfd_create( "zypp-rpm-progress", 0 );
+    if ( ret._fd == -1 )
+      return ret;
+
+    ret._mapsize = dataOffset + capacity;
+    if ( ::ftruncate( ret._fd, ret._mapsize ) != 0 )
+      return ProgressRing();
+
+    void *map = ::mmap( nullptr, ret._mapsize, PROT_READ|PROT_WRITE, MAP_SHARED, ret._fd, 0 );
+    if ( map == MAP_FAILED )
+      return ProgressRing();
+
+    static_assert( sizeof(Header) <= dataOffset );
+    ret._hdr = new ( map ) Header;
+    ret._hdr->magic = ringMagic;
+    ret._hdr->capacity = capacity;
+    ret._hdr->head.store( 0 );
+    ret._hdr->tail.store( 0 );
+    ret._data = static_cast<char *>( map ) + dataOffset;
+    return ret;
+  }
+
+  ProgressRing ProgressRing::attach( int fd )
+  {
+    struct stat sb {};
+    if ( ::fstat( fd, &sb ) == -1 )
+      return ProgressRing();
+    if ( size_t(sb.st_size) <= dataOffset ) {
+      errno = EINVAL;
+      return ProgressRing();
+    }
+
+    void *map = ::mmap( nullptr, sb.st_size, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0 );
+    if ( map == MAP_FAILED )
+      return ProgressRing();
+
+    ProgressRing ret;
+    ret._fd = fd;
+    ret._mapsize = sb.st_size;
+    ret._hdr = static_cast<Header *>( map );
+    ret._data = static_cast<char *>( map ) + dataOffset;
+    if ( ret._hdr->magic != ringMagic || dataOffset + ret._hdr->capacity != ret._mapsize ) {
+      ret._fd = -1; // not ours to close
+      errno = EINVAL;
+      return ProgressRing();
+    }
+    return ret;
+  }
+
+  void ProgressRing::write( uint64_t pos, const void *src, size_t n )
+  {
+    const size_t off = pos & ( _hdr->capacity - 1 );
+    const size_t first = std::min<size_t>( n, _hdr->capacity - off );
+    ::memcpy( _data + off, src, first );
+    ::memcpy( _data, static_cast<const char *>( src ) + first, n - first );
+  }
+
+  void ProgressRing::read( uint64_t pos, void *dst, size_t n ) const
+  {
+    const size_t off = pos & ( _hdr->capacity - 1 );
+    const size_t first = std::min<size_t>( n, _hdr->capacity - off );
+    ::memcpy( dst, _data + off, first );
+    ::memcpy( static_cast<char *>( dst ) + first, _data, n - first );
+  }
+
+  bool ProgressRing::push( const ProgressEvent &ev )
+  {
+    if ( !_hdr )
+      return false;
+
+    // overlong log lines are truncated, a record never exceeds 1/4 of the ring
+    const size_t textlen = std::min<size_t>( ev.text.size(), _hdr->capacity / 4 - sizeof(RecordHead) - 8 );
+    const uint32_t reclen = ( sizeof(RecordHead) + textlen + 7 ) & ~size_t(7);
+
+    const uint64_t head = _hdr->head.load( std::memory_order_relaxed );
+    const uint64_t tail = _hdr->tail.load( std::memory_order_acquire );
+    if ( _hdr->capacity - ( head - tail ) < reclen )
+      return false;
+
+    RecordHead rh {};
+    rh.len    = reclen;
+    rh.type   = ev.type;
+    rh.msgSeq = ev.msgSeq;
+    rh.stepId = ev.stepId;
+    rh.amount = ev.amount;
+    rh.level  = ev.level;
+    rh.textlen = textlen;
+    write( head, &rh, sizeof(rh) );
+    write( head + sizeof(rh), ev.text.data(), textlen );
+
+    _hdr->head.store( head + reclen, std::memory_order_release );
+    return true;
+  }
+
+  bool ProgressRing::pop( ProgressEvent &ev, uint32_t maxSeq )
+  {
+    if ( !_hdr )
+      return false;
+
+    const uint64_t tail = _hdr->tail.load( std::memory_order_relaxed );
+    const uint64_t head = _hdr->head.load( std::memory_order_acquire );
+    if ( tail == head )
+      return false;
+
+    RecordHead rh;
+    read( tail, &rh, sizeof(rh) );
+    if ( rh.len < sizeof(rh) + rh.textlen || rh.len > head - tail || rh.type > ProgressEvent::RpmLogType ) {
+      // corrupted, drop everything
+      _hdr->tail.store( head, std::memory_order_release );
+      return false;
+    }
+    if ( rh.msgSeq > maxSeq )
+      return false;
+
+    ev.type   = static_cast<ProgressEvent::Type>( rh.type );
+    ev.msgSeq = rh.msgSeq;
+    ev.stepId = rh.stepId;
+    ev.amount = rh.amount;
+    ev.level  = rh.level;
+    ev.text.resize( rh.textlen );
+    read( tail + sizeof(rh), ev.text.data(), ev.text.size() );
+
+    _hdr->tail.store( tail + rh.len, std::memory_order_release );
+    return true;
+  }
+
+}
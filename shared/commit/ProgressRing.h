@@ -0,0 +1,112 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+
+#ifndef ZYPP_SHARED_COMMIT_PROGRESSRING_H_INCLUDED
+#define ZYPP_SHARED_COMMIT_PROGRESSRING_H_INCLUDED
+
+#include <shared/commit/CommitMessages.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <variant>
+
+/*!
+ * High frequency events (progress and rpm log lines) are passed from zypp-rpm to
+ * TargetImpl via a ring buffer in shared memory instead of a STOMP message on the
+ * message pipe. The STOMP channel is still used for all other (control) messages.
+ *
+ * To keep the order of events and control messages, each event remembers the number
+ * of STOMP messages zypp-rpm sent before it. TargetImpl consumes the events up to
+ * that number before it processes the next STOMP message.
+ *
+ * If the shared memory can not be created or mapped, or if the ring is full, the
+ * events are sent as STOMP message as before.
+ */
+namespace zypp::proto::target
+{
+
+  // a high frequency event passed via the ProgressRing
+  struct ProgressEvent
+  {
+    enum Type : uint8_t {
+      PackageProgressType,
+      CleanupProgressType,
+      TransProgressType,
+      RpmLogType
+    };
+
+    using Message = std::variant<PackageProgress,CleanupProgress,TransProgress,RpmLog>;
+
+    ProgressEvent() = default;
+    ProgressEvent( const PackageProgress &msg );
+    ProgressEvent( const CleanupProgress &msg );
+    ProgressEvent( const TransProgress &msg );
+    ProgressEvent( const RpmLog &msg );
+
+    // the message this event stands for
+    Message toMessage() const;
+
+    Type type = PackageProgressType;
+    uint32_t msgSeq = 0;  // number of STOMP messages sent before this event
+    uint32_t stepId = 0;  // PackageProgress
+    uint32_t amount = 0;  // PackageProgress, CleanupProgress, TransProgress
+    uint32_t level = 0;   // RpmLog
+    std::string text;     // CleanupProgress: nvra, RpmLog: line
+  };
+
+  // Lock-free single producer single consumer ring buffer of ProgressEvent in shared memory.
+  // TargetImpl creates the ring and passes its fd to zypp-rpm, which attaches to it.
+  class ProgressRing
+  {
+  public:
+    static constexpr uint32_t defaultCapacity = 1024 * 1024;
+
+    ProgressRing() = default;
+    ProgressRing( const ProgressRing & ) = delete;
+    ProgressRing( ProgressRing &&other ) noexcept;
+    ProgressRing &operator=( const ProgressRing & ) = delete;
+    ProgressRing &operator=( ProgressRing &&other ) noexcept;
+    ~ProgressRing();
+
+    // create a new ring in a memfd, invalid on error (errno is set)
+    // capacity is rounded up to a power of 2
+    static ProgressRing create( uint32_t capacity = defaultCapacity );
+
+    // map the ring created in fd, invalid on error (errno is set)
+    static ProgressRing attach( int fd );
+
+    explicit operator bool() const
+    { return _hdr; }
+
+    // the memfd the ring lives in
+    int fd() const
+    { return _fd; }
+
+    // producer: append ev, false if the ring is full
+    bool push( const ProgressEvent &ev );
+
+    // consumer: take the next event, unless the ring is empty or the events msgSeq is greater than maxSeq
+    bool pop( ProgressEvent &ev, uint32_t maxSeq );
+
+  private:
+    struct Header;
+    void swap( ProgressRing &other ) noexcept;
+    void write( uint64_t pos, const void *src, size_t n );
+    void read( uint64_t pos, void *dst, size_t n ) const;
+
+    Header *_hdr = nullptr;
+    char *_data = nullptr;
+    size_t _mapsize = 0;
+    int _fd = -1;
+  };
+
+}
+
+#endif // ZYPP_SHARED_COMMIT_PROGRESSRING_H_INCLUDED
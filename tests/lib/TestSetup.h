@@ -197,7 +197,7 @@ public:
   }
 
   // Load repos included in a solver testcase.
-  void loadTestcaseRepos( const Pathname & path_r, misc::testcase::LoadTestcase::TestcaseTrials * trialsP_r = nullptr )
+  void loadTestcaseRepos( const Pathname & path_r, misc::testcase::LoadTestcase::TestcaseTrials * trialsP_r = nullptr, misc::testcase::TestcaseSetup * setupP_r = nullptr )
   {
     zypp::misc::testcase::LoadTestcase loader;
     std::string err;
@@ -222,6 +222,8 @@ public:
     poolProxy(); // prepare
     if ( trialsP_r )
       *trialsP_r = loader.trialInfo();
+    if ( setupP_r )
+      *setupP_r = loader.setupInfo();
   }
 
 public:
@@ -53,6 +53,13 @@ inline ByteSet getSize( const DiskUsageCounter & duc_r, const PoolItem & pi_r )
 inline ByteSet getSize( const DiskUsageCounter & duc_r, const ResPool & pool_r )
 { return mkByteSet( duc_r.disk_usage( pool_r ) ); }
 
+/** \ref getSize computed from scratch: the incremental data are dropped if the mountpoints change. */
+inline ByteSet getFreshSize( const DiskUsageCounter & duc_r, const ResPool & pool_r )
+{
+  DiskUsageCounter( { DiskUsageCounter::MountPoint( "/other" ) } ).disk_usage( pool_r );
+  return getSize( duc_r, pool_r );
+}
+
 inline void XLOG( const DiskUsageCounter & duc_r, const ResPool & pool_r )
 {
   for( const auto & pi : pool_r )
@@ -109,4 +116,25 @@ BOOST_AUTO_TEST_CASE(dudata)
   BOOST_CHECK_EQUAL( getSize( duc, pool ), mkByteSet(  5,  0 ) );	// update (old goes)
   ins.status().setTransact( false, ResStatus::USER );
   up3.status().setTransact( false, ResStatus::USER );
+
+  // incremental result equals a fresh computation
+  up2.status().setTransact( true, ResStatus::USER );
+  ins.status().setTransact( true, ResStatus::USER );
+  BOOST_CHECK_EQUAL( getSize( duc, pool ), mkByteSet( 45, 40 ) );
+  ins.status().setTransact( false, ResStatus::USER );
+  {
+    ByteSet incremental { getSize( duc, pool ) };
+    BOOST_CHECK_EQUAL( incremental, getFreshSize( duc, pool ) );
+  }
+  // a package without disk usage data replacing an installed one
+  up3.status().setTransact( true, ResStatus::USER );
+  ins.status().setTransact( true, ResStatus::USER );
+  {
+    ByteSet incremental { getSize( duc, pool ) };
+    BOOST_CHECK_EQUAL( incremental, getFreshSize( duc, pool ) );
+  }
+  up3.status().setTransact( false, ResStatus::USER );
+  ins.status().setTransact( false, ResStatus::USER );
+  up2.status().setTransact( false, ResStatus::USER );
+  BOOST_CHECK_EQUAL( getSize( duc, pool ), mkByteSet(  0,  0 ) );
 }
@@ -0,0 +1,62 @@
+#include <iostream>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+
+#include <zypp/base/Logger.h>
+#include <zypp/Edition.h>
+#include <zypp/sat/EvrKeyCache.h>
+
+using std::cout;
+using std::endl;
+using namespace zypp;
+using namespace boost::unit_test;
+
+namespace
+{
+  const std::vector<std::string> evrs {
+    "", "0", "1", "01", "1.0", "1_0", "1.0.", "1.a", "1.0a", "1.0.1", "1.00.1",
+    "1.10", "1.9", "1.0~rc1", "1.0~rc2", "1.0~~", "1.0^", "1.0^git1", "1.0^~",
+    "a", "A", "aa", "ab", "abc", "1.abc", "1.abd", "1.ab", "1.0-", "1.0-0",
+    "1.0-1", "1.0-1.1", "1.0-1.a", "1.0-1~", "1.0-1^", "0:1.0-1", "00:1.0-1",
+    "1:1.0", "1:0.9-9", "2:0", "10:1", "9:1", ":1.0", "1.0-1-2",
+    "12345678901234567890", "12345678901234567891", "9999999999999999999",
+  };
+}
+
+BOOST_AUTO_TEST_CASE(evr_compare)
+{
+  // The cached keys must order exactly like libsolv does.
+  sat::EvrKeyCache & cache( sat::EvrKeyCache::instance() );
+  for ( const std::string & lhs : evrs )
+  {
+    for ( const std::string & rhs : evrs )
+    {
+      int expected = Edition::compare( lhs.c_str(), rhs.c_str() );
+      BOOST_CHECK_MESSAGE( cache.compare( IdString(lhs), IdString(rhs) ) == expected,
+                           "compare( '" << lhs << "', '" << rhs << "' ) != " << expected );
+      BOOST_CHECK_EQUAL( Edition(lhs).compare( Edition(rhs) ), expected );
+    }
+  }
+  BOOST_CHECK( cache.size() >= evrs.size() );
+
+  // An empty string is not less than anything ('~' sorts before the end).
+  BOOST_CHECK_EQUAL( Edition::compare( "", "~1" ), 1 );
+  BOOST_CHECK_EQUAL( cache.compare( IdString(""), IdString("~1") ), 1 );
+  BOOST_CHECK_EQUAL( cache.compare( IdString("~1"), IdString() ), -1 );
+  BOOST_CHECK_EQUAL( cache.compare( IdString(), IdString("") ), 0 );
+}
+
+BOOST_AUTO_TEST_CASE(evr_sort)
+{
+  std::vector<Edition> eds { Edition("1.10"), Edition("1:0.1"), Edition("1.9"), Edition("1.9~rc1"), Edition("1.9-1") };
+  sat::sortByEdition( eds.begin(), eds.end() );
+  BOOST_CHECK_EQUAL( eds[0], Edition("1.9~rc1") );
+  BOOST_CHECK_EQUAL( eds[1], Edition("1.9") );
+  BOOST_CHECK_EQUAL( eds[2], Edition("1.9-1") );
+  BOOST_CHECK_EQUAL( eds[3], Edition("1.10") );
+  BOOST_CHECK_EQUAL( eds[4], Edition("1:0.1") );
+
+  std::vector<std::pair<std::string,Edition>> items { { "b", Edition("2") }, { "a", Edition("1") } };
+  sat::sortByEdition( items.begin(), items.end(), []( const auto & item_r ) { return item_r.second; } );
+  BOOST_CHECK_EQUAL( items[0].first, "a" );
+}
@@ -91,6 +91,51 @@ BOOST_AUTO_TEST_CASE(repolist)
   //test.loadRepo( TESTS_SRC_DIR "/data/openSUSE-11.1" );
 }
 
+BOOST_AUTO_TEST_CASE(whatDependsOn)
+{
+  sat::Pool satpool( test.satpool() );
+  if ( ! satpool.reposFind( ":openSUSE-11.1" ) )
+    test.loadRepo( TESTS_SRC_DIR "/data/openSUSE-11.1" );
+  BOOST_REQUIRE( ! satpool.solvablesEmpty() );
+
+  Capability probe;
+  unsigned checked = 0;
+  for ( const sat::Solvable & solv : satpool.solvables() )
+  {
+    for ( const Capability & cap : solv.requires() )
+    {
+      BOOST_CHECK( satpool.whatRequires( cap ).contains( solv.id() ) );
+      if ( ! probe && CapDetail( cap ).isNamed() && ! CapDetail( cap ).hasArch() )
+        probe = cap;
+    }
+    if ( ++checked == 200 )
+      break;
+  }
+  BOOST_REQUIRE( probe );
+
+  // Compare with a full scan for a plain name
+  sat::Queue expected;
+  for ( const sat::Solvable & solv : satpool.solvables() )
+  {
+    for ( const Capability & cap : solv.requires() )
+    {
+      CapDetail detail( cap );
+      if ( cap == probe || ( detail.isVersioned() && ! detail.hasArch() && detail.name() == probe.detail().name() ) )
+      {
+        expected.push( solv.id() );
+        break;
+      }
+    }
+  }
+  sat::Queue result( satpool.whatRequires( probe ) );
+  BOOST_CHECK_EQUAL( result.size(), expected.size() );
+  for ( sat::Queue::value_type id : expected )
+    BOOST_CHECK( result.contains( id ) );
+
+  // not indexed
+  BOOST_CHECK( satpool.whatDependsOn( Dep::PROVIDES, probe ).empty() );
+}
+
 #if 0
 BOOST_AUTO_TEST_CASE(LookupAttr_)
 {
@@ -72,6 +72,12 @@ BOOST_AUTO_TEST_CASE(attributes)
             BOOST_CHECK_EQUAL(p->vendor(), "SUSE LINUX Products GmbH, Nuernberg, Germany");
             BOOST_CHECK_EQUAL(p->category(), "Base Technologies");
             BOOST_CHECK_EQUAL(p->summary(), "Novell AppArmor");
+            BOOST_CHECK_EQUAL(p->summaryView(), "Novell AppArmor");
+            // take a copy: the view may be invalidated by the other lookup
+            std::string summaryView( s.summaryView() );
+            BOOST_CHECK_EQUAL(summaryView, s.summary());
+            std::string descriptionView( s.descriptionView() );
+            BOOST_CHECK_EQUAL(descriptionView, s.description());
             BOOST_CHECK_EQUAL(p->icon(), "pattern-apparmor");
             BOOST_CHECK_EQUAL(p->userVisible(), true);
             BOOST_CHECK_EQUAL(p->isDefault(), false);
@@ -97,6 +103,7 @@ BOOST_AUTO_TEST_CASE(asStringTest)
   BOOST_CHECK_EQUAL( sat::Solvable(2).asString(), "product:openSUSE-11.1.x86_64" );
   BOOST_CHECK_EQUAL( sat::Solvable(3693).asString(), "autoyast2-2.16.19-0.1.src" );
   BOOST_CHECK_EQUAL( sat::Solvable(19222).asString(), "noSolvable" );
+  BOOST_CHECK( sat::Solvable(0).summaryView().empty() );
 #if 0
   Repository r = sat::Pool::instance().reposFind("update");
   for_( it, r.solvablesBegin(), r.solvablesEnd() )
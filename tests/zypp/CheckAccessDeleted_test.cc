@@ -0,0 +1,103 @@
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <zypp/base/String.h>
+#include <zypp/PathInfo.h>
+#include <zypp/TmpPath.h>
+#include <zypp/misc/CheckAccessDeleted.h>
+
+using std::cout;
+using std::endl;
+using namespace zypp;
+
+namespace
+{
+  const CheckAccessDeleted::ProcInfo * findPid( const CheckAccessDeleted & check_r, const std::string & pid_r )
+  {
+    auto it = std::find_if( check_r.begin(), check_r.end(), [&]( const CheckAccessDeleted::ProcInfo & pinfo ) { return pinfo.pid == pid_r; } );
+    return it == check_r.end() ? nullptr : &*it;
+  }
+
+  /** A lsof -F0 line. */
+  std::string lsofLine( std::initializer_list<std::string> fields_r )
+  {
+    std::string ret;
+    for ( const std::string & field : fields_r )
+      ( ret += field ) += '\0';
+    return ret += '\n';
+  }
+}
+
+BOOST_AUTO_TEST_CASE(from_lsof_file)
+{
+  filesystem::TmpFile file;
+  {
+    std::ofstream out( file.path().c_str() );
+    // a deleted library
+    out << lsofLine( { "p100", "cfoo", "u0", "Lroot", "R1" } );
+    out << lsofLine( { "fmem", "tREG", "k0", "n/usr/lib64/libfoo.so.1" } );
+    out << lsofLine( { "fmem", "tREG", "k1", "n/usr/lib64/libbar.so.1" } );
+    // nothing deleted
+    out << lsofLine( { "p200", "cbar", "u0", "Lroot", "R1" } );
+    out << lsofLine( { "fmem", "tREG", "k1", "n/usr/lib64/libbar.so.1" } );
+    // deleted, but blacklisted or no library
+    out << lsofLine( { "p300", "cbaz", "u0", "Lroot", "R1" } );
+    out << lsofLine( { "fDEL", "tDEL", "n/dev/shm/baz" } );
+    out << lsofLine( { "fDEL", "tDEL", "n/home/data" } );
+  }
+
+  CheckAccessDeleted check( false );
+  BOOST_CHECK_EQUAL( check.check( file.path() ), 1 );
+  const CheckAccessDeleted::ProcInfo * pinfo = findPid( check, "100" );
+  BOOST_REQUIRE( pinfo );
+  BOOST_CHECK_EQUAL( pinfo->command, "foo" );
+  BOOST_CHECK_EQUAL( pinfo->ppid, "1" );
+  BOOST_CHECK_EQUAL( pinfo->login, "root" );
+  BOOST_REQUIRE_EQUAL( pinfo->files.size(), 1 );
+  BOOST_CHECK_EQUAL( pinfo->files[0], "/usr/lib64/libfoo.so.1" );
+
+  // verbose reports any deleted file
+  BOOST_CHECK_EQUAL( check.check( file.path(), /*verbose*/true ), 2 );
+  pinfo = findPid( check, "300" );
+  BOOST_REQUIRE( pinfo );
+  BOOST_REQUIRE_EQUAL( pinfo->files.size(), 1 );
+  BOOST_CHECK_EQUAL( pinfo->files[0], "/home/data" );
+}
+
+BOOST_AUTO_TEST_CASE(from_proc)
+{
+  if ( ! PathInfo( "/proc/self/maps" ).isFile() )
+    return;	// no /proc
+
+  // map a file and delete it (not below a blacklisted dir like /tmp)
+  filesystem::TmpDir tmp( TESTS_BUILD_DIR );
+  Pathname file( tmp.path() / "libdeleted.so" );
+  {
+    std::ofstream out( file.c_str() );
+    out << std::string( 4096, 'x' );
+  }
+  int fd = ::open( file.c_str(), O_RDONLY );
+  BOOST_REQUIRE( fd >= 0 );
+  void * addr = ::mmap( nullptr, 4096, PROT_READ, MAP_PRIVATE, fd, 0 );
+  ::close( fd );
+  BOOST_REQUIRE( addr != MAP_FAILED );
+  filesystem::unlink( file );
+
+  CheckAccessDeleted check( false );
+  check.check( /*verbose*/true );
+  const CheckAccessDeleted::ProcInfo * pinfo = findPid( check, str::numstring( ::getpid() ) );
+  BOOST_REQUIRE( pinfo );
+  BOOST_CHECK( std::find( pinfo->files.begin(), pinfo->files.end(), file.asString() ) != pinfo->files.end() );
+  BOOST_CHECK( ! pinfo->command.empty() );
+
+  ::munmap( addr, 4096 );
+  check.check( /*verbose*/true );
+  pinfo = findPid( check, str::numstring( ::getpid() ) );
+  BOOST_CHECK( ! pinfo || std::find( pinfo->files.begin(), pinfo->files.end(), file.asString() ) == pinfo->files.end() );
+}
@@ -0,0 +1,61 @@
+#include <iostream>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <zypp/target/CommitHeaps.h>
+
+using std::cout;
+using std::endl;
+using namespace zypp;
+using target::computeCommitHeaps;
+
+namespace
+{
+  using Sizes = std::vector<ByteCount::SizeType>;
+  using Cycles = std::vector<std::pair<std::size_t,std::size_t>>;
+  using Heaps = std::vector<std::size_t>;
+}
+
+BOOST_AUTO_TEST_CASE(no_budget)
+{
+  Sizes sizes { 4, 4, 4, 4, 4, 0 };
+  BOOST_CHECK( computeCommitHeaps( sizes, {}, 0 ) == Heaps({ 6 }) );
+  BOOST_CHECK( computeCommitHeaps( sizes, {}, 100 ) == Heaps({ 6 }) );
+  BOOST_CHECK( computeCommitHeaps( Sizes(), {}, 8 ) == Heaps({ 0 }) );
+}
+
+BOOST_AUTO_TEST_CASE(budget_split)
+{
+  Sizes sizes { 4, 4, 4, 4, 4, 0 };
+  BOOST_CHECK( computeCommitHeaps( sizes, {}, 8 ) == Heaps({ 2, 4, 6 }) );
+  BOOST_CHECK( computeCommitHeaps( sizes, {}, 11 ) == Heaps({ 2, 4, 6 }) );
+  BOOST_CHECK( computeCommitHeaps( sizes, {}, 12 ) == Heaps({ 3, 6 }) );
+  BOOST_CHECK( computeCommitHeaps( sizes, {}, 3 ) == Heaps({ 1, 2, 3, 4, 6 }) );
+}
+
+BOOST_AUTO_TEST_CASE(order_cycles)
+{
+  Sizes sizes { 4, 4, 4, 4, 4, 0 };
+  // no cut between steps 1 and 2
+  BOOST_CHECK( computeCommitHeaps( sizes, Cycles({ {1,2} }), 8 ) == Heaps({ 1, 3, 6 }) );
+  // a heap exceeding the budget rather than splitting the cycle
+  BOOST_CHECK( computeCommitHeaps( sizes, Cycles({ {0,2} }), 8 ) == Heaps({ 3, 6 }) );
+  BOOST_CHECK( computeCommitHeaps( sizes, Cycles({ {0,5} }), 8 ) == Heaps({ 6 }) );
+}
+
+BOOST_AUTO_TEST_CASE(package_over_budget)
+{
+  // a single package exceeding the budget gets a heap of its own
+  BOOST_CHECK( computeCommitHeaps( Sizes({ 2, 100, 2 }), {}, 10 ) == Heaps({ 1, 2, 3 }) );
+  BOOST_CHECK( computeCommitHeaps( Sizes({ 100 }), {}, 10 ) == Heaps({ 1 }) );
+  BOOST_CHECK( computeCommitHeaps( Sizes({ 100, 2, 2 }), {}, 10 ) == Heaps({ 1, 3 }) );
+}
+
+BOOST_AUTO_TEST_CASE(delete_only)
+{
+  // steps downloading nothing never exceed the budget
+  BOOST_CHECK( computeCommitHeaps( Sizes({ 0, 0, 0, 0 }), {}, 1 ) == Heaps({ 4 }) );
+  // deletes stay in the heap in front of them
+  BOOST_CHECK( computeCommitHeaps( Sizes({ 0, 0, 5, 0, 5, 0 }), {}, 5 ) == Heaps({ 4, 6 }) );
+}
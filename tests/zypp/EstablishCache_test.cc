@@ -0,0 +1,87 @@
+#include <boost/test/unit_test.hpp>
+
+#include "TestSetup.h"
+#include <zypp/ResPool.h>
+#include <zypp/TmpPath.h>
+#include <zypp/PathInfo.h>
+#include <zypp/pool/EstablishCache.h>
+
+using namespace zypp;
+
+static TestSetup test( TestSetup::initLater );
+struct TestInit {
+  TestInit() {
+    test = TestSetup( Arch_x86_64 );
+    test.loadTestcaseRepos( TESTS_SRC_DIR"/data/TCEstablish" );
+  }
+  ~TestInit() { test.reset(); }
+};
+BOOST_GLOBAL_FIXTURE( TestInit );
+
+inline PoolItem getPatch( const std::string & name_r )
+{ return *test.pool().byIdent( ResKind::patch, name_r ).begin(); }
+
+/** Replace the installed system by the content of \a file_r (and trigger establish). */
+inline void reloadSystem( const std::string & file_r )
+{
+  sat::Pool::instance().systemRepo().eraseFromPool();
+  sat::Pool::instance().systemRepo().addTesttags( Pathname(TESTS_SRC_DIR"/data/TCEstablish") / file_r );
+  test.pool().establishedStates();
+}
+
+BOOST_AUTO_TEST_CASE(incremental)
+{
+  pool::EstablishCache & cache( pool::EstablishCache::forPool( test.pool() ) );
+  PoolItem pfoo( getPatch( "p-foo" ) );
+  PoolItem pbar( getPatch( "p-bar" ) );
+  BOOST_CHECK( pfoo.isBroken() );
+  BOOST_CHECK( pbar.isBroken() );
+  BOOST_CHECK_EQUAL( cache.size(), 2 );
+
+  // foo updated: just p-foo is recomputed
+  reloadSystem( "@System-foo2.repo" );
+  BOOST_CHECK( ! pfoo.isBroken() );
+  BOOST_CHECK( pbar.isBroken() );
+  BOOST_CHECK_EQUAL( cache.size(), 2 );
+  BOOST_CHECK_EQUAL( cache.lastComputed(), 1 );
+
+  // same content: nothing to compute
+  reloadSystem( "@System-foo2.repo" );
+  BOOST_CHECK( ! pfoo.isBroken() );
+  BOOST_CHECK( pbar.isBroken() );
+  BOOST_CHECK_EQUAL( cache.lastComputed(), 0 );
+}
+
+BOOST_AUTO_TEST_CASE(persistent)
+{
+  pool::EstablishCache & cache( pool::EstablishCache::forPool( test.pool() ) );
+  filesystem::TmpDir tmp;
+  Pathname file( tmp.path() / "established" );
+  RepoStatus status( "cookie", Date::now() );
+
+  cache.setPersistent( file, status );
+  reloadSystem( "@System-foo2.repo" );
+  BOOST_CHECK( ! PathInfo( file ).isExist() );	// written on save only
+  cache.save();
+  BOOST_CHECK( PathInfo( file ).isFile() );
+
+  // reused if the system status matches...
+  cache.clear();
+  cache.setPersistent( file, status );
+  BOOST_CHECK_EQUAL( cache.size(), 2 );
+  reloadSystem( "@System-foo2.repo" );
+  BOOST_CHECK_EQUAL( cache.lastComputed(), 0 );
+  BOOST_CHECK( getPatch( "p-bar" ).isBroken() );
+
+  // ...and recomputed if installed packages changed
+  reloadSystem( "@System.repo" );
+  BOOST_CHECK_EQUAL( cache.lastComputed(), 2 );	// refs are not persisted
+  BOOST_CHECK( getPatch( "p-foo" ).isBroken() );
+
+  // ignored if the system status differs
+  cache.clear();
+  cache.setPersistent( file, RepoStatus( "othercookie", Date::now() ) );
+  BOOST_CHECK_EQUAL( cache.size(), 0 );
+
+  cache.setPersistent( Pathname(), RepoStatus() );
+}
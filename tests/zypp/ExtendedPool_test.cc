@@ -7,6 +7,8 @@
 
 #include <zypp/ResObjects.h>
 #include <zypp/ResPool.h>
+#include <zypp/ResPoolProxy.h>
+#include <zypp/ZConfig.h>
 
 using boost::unit_test::test_case;
 using std::cin;
@@ -66,6 +68,27 @@ void repocheck()
 //   cout << "---[repocheck]======================" << endl;
 }
 
+void identcheck()
+{
+  // every item must be found in its ident range, and nothing else is in there
+  ResPool pool( ResPool::instance() );
+  unsigned indexed = 0;
+  for ( auto && pi : pool )
+  {
+    ResPool::ByIdent ident( pi.satSolvable() );
+    bool found = false;
+    for ( auto && it : pool.byIdent( ident ) )
+    {
+      BOOST_CHECK_EQUAL( ResPool::ByIdent( it.satSolvable() ).get(), ident.get() );
+      if ( it == pi )
+        found = true;
+    }
+    BOOST_CHECK_MESSAGE( found, pi );
+    ++indexed;
+  }
+  BOOST_CHECK_EQUAL( indexed, pool.size() );
+}
+
 ///////////////////////////////////////////////////////////////////
 // Check that after ERASING ALL REPOS and loading a new one, ResPool
 // actually creates new PoolItems rather than reusing already existing
@@ -99,3 +122,70 @@ BOOST_AUTO_TEST_CASE(t_1) {
     repocheck();
   }
 }
+
+///////////////////////////////////////////////////////////////////
+// Check the byIdent index stays in sync if repos are added and
+// removed (incremental update) or all repos are erased (rebuild).
+///////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE(byIdent) {
+
+  BOOST_TEST_CONTEXT("Rebuild") {
+    testcase_init2();
+    identcheck();
+  }
+
+  BOOST_TEST_CONTEXT("Add repo") {
+    test.loadTestcaseRepos( TESTS_SRC_DIR"/data/PoolReuseIds/SeqA" );
+    identcheck();
+  }
+
+  BOOST_TEST_CONTEXT("Remove repo") {
+    sat::Pool::instance().reposFind( "SeqB" ).eraseFromPool();
+    identcheck();
+    repocheck();
+  }
+}
+
+///////////////////////////////////////////////////////////////////
+// Check ResPoolProxy is patched rather than rebuilt if repos are
+// added or removed: Selectables of unchanged idents keep their
+// identity, the others are updated in place. Any other change
+// rebuilds it.
+///////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE(proxy) {
+  testcase_init2();
+  ui::Selectable::Ptr pkg( ResPool::instance().proxy().lookup( ResKind::package, "package" ) );
+  BOOST_REQUIRE( pkg );
+  BOOST_CHECK_EQUAL( pkg->availableSize(), 1 );
+
+  BOOST_TEST_CONTEXT("Add repo") {
+    test.loadTestcaseRepos( TESTS_SRC_DIR"/data/PoolReuseIds/SeqA" );
+    ResPoolProxy proxy( ResPool::instance().proxy() );
+    BOOST_CHECK_EQUAL( proxy.lookup( ResKind::package, "package" ), pkg );
+    BOOST_CHECK_EQUAL( pkg->availableSize(), 2 );
+    BOOST_CHECK_EQUAL( proxy.size(), 6 );
+  }
+
+  BOOST_TEST_CONTEXT("Remove repo") {
+    sat::Pool::instance().reposFind( "SeqB" ).eraseFromPool();
+    ResPoolProxy proxy( ResPool::instance().proxy() );
+    BOOST_CHECK_EQUAL( proxy.lookup( ResKind::package, "package" ), pkg );
+    BOOST_CHECK_EQUAL( pkg->availableSize(), 1 );
+    BOOST_CHECK_EQUAL( pkg->candidateObj().repoInfo().alias(), "SEQA" );
+    BOOST_CHECK_EQUAL( proxy.size(), 6 );
+  }
+
+  // Other changes may affect all Selectables: rebuilt
+  BOOST_TEST_CONTEXT("Multiversion spec changed") {
+    ZConfig::instance().addMultiversionSpec( "package" );
+    ResPoolProxy proxy( ResPool::instance().proxy() );
+    ui::Selectable::Ptr rebuilt( proxy.lookup( ResKind::package, "package" ) );
+    BOOST_REQUIRE( rebuilt );
+    BOOST_CHECK( rebuilt != pkg );
+    BOOST_CHECK_EQUAL( rebuilt->availableSize(), 1 );
+    BOOST_CHECK_EQUAL( proxy.size(), 6 );
+    ZConfig::instance().removeMultiversionSpec( "package" );
+  }
+}
@@ -0,0 +1,440 @@
+extern "C"
+{
+#include <solv/pool.h>
+#include <solv/repo_rpmdb.h>
+#include <solv/pool_fileconflicts.h>
+}
+#include <sys/stat.h>
+
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <map>
+#include <set>
+#include <tuple>
+
+#include <boost/test/unit_test.hpp>
+
+#include <zypp-core/AutoDispose.h>
+#include <zypp/PathInfo.h>
+#include <zypp/TmpPath.h>
+#include <zypp/Repository.h>
+#include <zypp/sat/Pool.h>
+#include <zypp/sat/Solvable.h>
+#include <zypp/target/InstalledFilesIndex.h>
+#include <zypp/target/IndexedFileConflicts.h>
+
+using std::cout;
+using std::endl;
+using namespace zypp;
+using target::InstalledFilesIndex;
+using target::IndexedFileConflicts;
+
+namespace
+{
+  /** A file in a test package (for symlinks \c digest is the link target). */
+  struct File
+  {
+    std::string path;
+    unsigned mode;
+    std::string digest;
+    unsigned color = 0;
+  };
+
+  /** An rpm header blob as stored in a package file (with region tag). */
+  class Header
+  {
+  public:
+    void addString( uint32_t tag_r, const std::string & val_r )
+    {
+      addEntry( tag_r, 6/*STRING*/, 1 );
+      ( _data += val_r ) += '\0';
+    }
+
+    void addStringArray( uint32_t tag_r, const std::vector<std::string> & val_r )
+    {
+      addEntry( tag_r, 8/*STRING_ARRAY*/, val_r.size() );
+      for ( const std::string & val : val_r )
+        ( _data += val ) += '\0';
+    }
+
+    void addInt16( uint32_t tag_r, const std::vector<uint32_t> & val_r )
+    {
+      align( 2 );
+      addEntry( tag_r, 3/*INT16*/, val_r.size() );
+      for ( uint32_t val : val_r )
+        put( _data, val, 2 );
+    }
+
+    void addInt32( uint32_t tag_r, const std::vector<uint32_t> & val_r )
+    {
+      align( 4 );
+      addEntry( tag_r, 4/*INT32*/, val_r.size() );
+      for ( uint32_t val : val_r )
+        put( _data, val, 4 );
+    }
+
+    std::string blob( uint32_t regionTag_r ) const
+    {
+      uint32_t il = _count + 1;
+      std::string index;
+      put( index, regionTag_r, 4 ); put( index, 7/*BIN*/, 4 ); put( index, _data.size(), 4 ); put( index, 16, 4 );
+      index += _index;
+      std::string data { _data };
+      put( data, regionTag_r, 4 ); put( data, 7/*BIN*/, 4 ); put( data, -il*16, 4 ); put( data, 16, 4 );
+      std::string ret;
+      put( ret, 0x8eade801, 4 ); put( ret, 0, 4 ); put( ret, il, 4 ); put( ret, data.size(), 4 );
+      return ret + index + data;
+    }
+
+  private:
+    static void put( std::string & str_r, uint32_t val_r, unsigned bytes_r )
+    {
+      while ( bytes_r-- )
+        str_r += char( ( val_r >> ( 8 * bytes_r ) ) & 0xff );
+    }
+
+    void align( unsigned size_r )
+    {
+      while ( _data.size() % size_r )
+        _data += '\0';
+    }
+
+    void addEntry( uint32_t tag_r, uint32_t type_r, uint32_t count_r )
+    {
+      put( _index, tag_r, 4 ); put( _index, type_r, 4 ); put( _index, _data.size(), 4 ); put( _index, count_r, 4 );
+      ++_count;
+    }
+
+  private:
+    std::string _index;
+    std::string _data;
+    uint32_t _count = 0;
+  };
+
+  /** Write a package file without payload, providing just the file list. */
+  void writeRpm( const Pathname & file_r, const std::string & name_r, const std::vector<File> & files_r )
+  {
+    std::vector<std::string> dirnames, basenames, digests, linktos;
+    std::vector<uint32_t> modes, flags, dirindexes, colors;
+    for ( const File & file : files_r )
+    {
+      std::string::size_type pos = file.path.rfind( '/' );
+      std::string dirname { file.path.substr( 0, pos+1 ) };
+      auto it = std::find( dirnames.begin(), dirnames.end(), dirname );
+      if ( it == dirnames.end() )
+        it = dirnames.insert( it, dirname );
+      dirindexes.push_back( it - dirnames.begin() );
+      basenames.push_back( file.path.substr( pos+1 ) );
+      modes.push_back( file.mode );
+      digests.push_back( S_ISREG( file.mode ) ? file.digest : "" );
+      linktos.push_back( S_ISLNK( file.mode ) ? file.digest : "" );
+      flags.push_back( 0 );
+      colors.push_back( file.color );
+    }
+
+    Header hdr;
+    hdr.addString( 1000, name_r );		// NAME
+    hdr.addString( 1001, "1" );			// VERSION
+    hdr.addString( 1002, "1" );			// RELEASE
+    hdr.addString( 1022, "noarch" );		// ARCH
+    hdr.addInt16( 1030, modes );		// FILEMODES
+    hdr.addStringArray( 1035, digests );	// FILEDIGESTS
+    hdr.addStringArray( 1036, linktos );	// FILELINKTOS
+    hdr.addInt32( 1037, flags );		// FILEFLAGS
+    hdr.addInt32( 1116, dirindexes );		// DIRINDEXES
+    hdr.addStringArray( 1117, basenames );	// BASENAMES
+    hdr.addStringArray( 1118, dirnames );	// DIRNAMES
+    hdr.addInt32( 1140, colors );		// FILECOLORS
+
+    std::string lead( 96, '\0' );
+    lead.replace( 0, 4, "\xed\xab\xee\xdb" );	// magic
+    lead[4] = 3;				// major
+    lead[9] = 1;				// archnum
+    lead.replace( 10, std::min<size_t>( name_r.size(), 65 ), name_r );
+    lead[77] = 1;				// osnum
+    lead[79] = 5;				// signature type: header
+
+    std::ofstream out( file_r.c_str(), std::ios::binary );
+    out << lead << Header().blob( 62/*HEADERSIGNATURES*/ ) << hdr.blob( 63/*HEADERIMMUTABLE*/ );
+  }
+
+  /** Read the file list of \a file_r like \ref InstalledFilesIndex::update does. */
+  struct Filelist
+  {
+    Filelist( const Pathname & file_r )
+    {
+      AutoDispose<::Pool*> pool { ::pool_create(), ::pool_free };
+      AutoDispose<void*> state { ::rpm_state_create( pool, nullptr ), ::rpm_state_free };
+      AutoFILE fp { ::fopen( file_r.c_str(), "re" ) };
+      BOOST_REQUIRE( fp );
+      void * rpmhandle = ::rpm_byfp( state, fp, file_r.c_str() );
+      BOOST_REQUIRE( rpmhandle );
+      ::rpm_iterate_filelist( rpmhandle, RPM_ITERATE_FILELIST_WITHMD5|RPM_ITERATE_FILELIST_WITHCOL|RPM_ITERATE_FILELIST_NOGHOSTS, &Filelist::invoke, this );
+    }
+
+    static void invoke( void * cbdata_r, const char * filename_r, struct ::filelistinfo * info_r )
+    { static_cast<Filelist *>( cbdata_r )->_files.push_back( File{ filename_r, info_r->mode, info_r->digest ? info_r->digest : "", info_r->color } ); }
+
+    std::vector<File> _files;
+  };
+
+  /** Test precondition: libsolv reads the generated package files.
+   * A libsolv using librpm to read package files may refuse the unsigned headers.
+   */
+  struct ReadsGeneratedRpm
+  {
+    boost::test_tools::assertion_result operator()( boost::unit_test::test_unit_id )
+    {
+      filesystem::TmpDir tmp;
+      Pathname file { tmp.path() / "probe.rpm" };
+      writeRpm( file, "probe", { { "/usr/bin/probe", S_IFREG|0755, "pppp" } } );
+
+      AutoDispose<::Pool*> pool { ::pool_create(), ::pool_free };
+      AutoDispose<void*> state { ::rpm_state_create( pool, nullptr ), ::rpm_state_free };
+      AutoFILE fp { ::fopen( file.c_str(), "re" ) };
+      boost::test_tools::assertion_result ret { fp && ::rpm_byfp( state, fp, file.c_str() ) };
+      if ( ! ret )
+        ret.message() << "libsolv can't read the generated package files: " << ::pool_errstr( pool );
+      return ret;
+    }
+  };
+
+  /** The conflicts as (path, solvable, solvable) ignoring the order. */
+  std::set<std::tuple<std::string,sat::detail::IdType,sat::detail::IdType>> normalized( const sat::FileConflicts & conflicts_r )
+  {
+    std::set<std::tuple<std::string,sat::detail::IdType,sat::detail::IdType>> ret;
+    for ( const sat::FileConflicts::Conflict & conflict : conflicts_r )
+    {
+      sat::detail::IdType lhs = conflict.lhsSolvable().id();
+      sat::detail::IdType rhs = conflict.rhsSolvable().id();
+      ret.insert( { conflict.lhsFilename().asString(), std::min( lhs, rhs ), std::max( lhs, rhs ) } );
+    }
+    return ret;
+  }
+
+  /** libsolv::pool_findfileconflicts callback reading the test packages. */
+  struct FileConflictsCB
+  {
+    static void * invoke( sat::detail::CPool *, sat::detail::IdType id_r, void * cbdata_r )
+    {
+      FileConflictsCB & self { *static_cast<FileConflictsCB *>( cbdata_r ) };
+      AutoFILE fp { ::fopen( self._files[id_r].c_str(), "re" ) };
+      return fp ? ::rpm_byfp( self._state, fp, self._files[id_r].c_str() ) : nullptr;
+    }
+
+    std::map<sat::detail::IdType,Pathname> _files;
+    AutoDispose<void*> _state { ::rpm_state_create( sat::Pool::instance().get(), nullptr ), ::rpm_state_free };
+  };
+}
+
+BOOST_AUTO_TEST_CASE(round_trip)
+{
+  filesystem::TmpDir tmp;
+  Pathname file { tmp.path() / "index" };
+  InstalledFilesIndex::write( {
+    { "/usr/bin/a",		"aaaa",	2, S_IFREG|0755, 0 },
+    { "/usr/bin/a",		"a1a1",	1, S_IFREG|0755, 1 },
+    { "/usr/share/doc/readme",	"rrrr",	1, S_IFREG|0644, 0 },
+    { "/usr/share/doc",		"",	1, S_IFDIR|0755, 0 },
+  }, "cookie", file );
+
+  BOOST_CHECK( InstalledFilesIndex( file, "cookie" ) );
+  BOOST_CHECK( InstalledFilesIndex( file, "" ) );		// any cookie
+  BOOST_CHECK( ! InstalledFilesIndex( file, "other" ) );
+  BOOST_CHECK( ! InstalledFilesIndex( tmp.path() / "nonexisting", "" ) );
+
+  InstalledFilesIndex index( file, "cookie" );
+  BOOST_CHECK_EQUAL( index.size(), 4 );
+  BOOST_CHECK_EQUAL( index.cookie(), "cookie" );
+  BOOST_CHECK_EQUAL( index.aliasedDirs(), 0 );
+
+  // lookup
+  std::vector<InstalledFilesIndex::Entry> entries { index.lookup( "/usr/bin/a" ) };
+  BOOST_REQUIRE_EQUAL( entries.size(), 2 );
+  BOOST_CHECK_EQUAL( entries[0].path, "/usr/bin/a" );
+  BOOST_CHECK_EQUAL( entries[0].rpmdbid, 1 );
+  BOOST_CHECK_EQUAL( entries[0].digest, "a1a1" );
+  BOOST_CHECK_EQUAL( entries[0].color, 1 );
+  BOOST_CHECK_EQUAL( entries[1].rpmdbid, 2 );
+  BOOST_CHECK_EQUAL( entries[1].digest, "aaaa" );
+  BOOST_CHECK_EQUAL( entries[1].mode, S_IFREG|0755 );
+
+  entries = index.lookup( "/usr/share/doc" );
+  BOOST_REQUIRE_EQUAL( entries.size(), 1 );
+  BOOST_CHECK( S_ISDIR( entries[0].mode ) );
+  BOOST_CHECK_EQUAL( entries[0].digest, "" );
+
+  BOOST_CHECK( index.lookup( "/usr/bin" ).empty() );
+  BOOST_CHECK( index.lookup( "/usr/bin/b" ).empty() );
+
+  // isDir
+  BOOST_CHECK( index.isDir( "/usr" ) );
+  BOOST_CHECK( index.isDir( "/usr/bin" ) );
+  BOOST_CHECK( index.isDir( "/usr/share/doc" ) );
+  BOOST_CHECK( ! index.isDir( "/usr/bin/a" ) );
+  BOOST_CHECK( ! index.isDir( "/us" ) );
+  BOOST_CHECK( ! index.isDir( "/usr/" ) );
+}
+
+BOOST_AUTO_TEST_CASE(aliased_dirs)
+{
+  filesystem::TmpDir tmp;
+  Pathname file { tmp.path() / "index" };
+  InstalledFilesIndex::write( {
+    { "/lib",		"usr/lib",	1, S_IFLNK|0777, 0 },
+    { "/lib/libx.so",	"xxxx",		2, S_IFREG|0755, 0 },
+    { "/bin",		"usr/bin",	1, S_IFLNK|0777, 0 },
+  }, "cookie", file );
+
+  InstalledFilesIndex index( file, "cookie" );
+  BOOST_CHECK( index );
+  BOOST_CHECK_EQUAL( index.aliasedDirs(), 1 );
+}
+
+BOOST_AUTO_TEST_CASE(malformed)
+{
+  filesystem::TmpDir tmp;
+  Pathname file { tmp.path() / "index" };
+  InstalledFilesIndex::write( {
+    { "/usr/bin/a",	"aaaa",	1, S_IFREG|0755, 0 },
+  }, "cookie", file );
+  std::string content;
+  {
+    std::ifstream in( file.c_str(), std::ios::binary );
+    content.assign( std::istreambuf_iterator<char>( in ), std::istreambuf_iterator<char>() );
+  }
+  BOOST_REQUIRE( InstalledFilesIndex( file, "cookie" ) );
+
+  auto check = [&]( const std::string & content_r ) {
+    Pathname broken { tmp.path() / "broken" };
+    std::ofstream( broken.c_str(), std::ios::binary ) << content_r;
+    InstalledFilesIndex index( broken, "" );
+    BOOST_CHECK( ! index );
+    BOOST_CHECK_EQUAL( index.size(), 0 );
+    BOOST_CHECK( index.lookup( "/usr/bin/a" ).empty() );
+    BOOST_CHECK( ! index.isDir( "/usr/bin" ) );
+  };
+
+  // FileHeader(40) + cookie padded(8)
+  static const std::size_t fileEntry = 48;
+  static const std::size_t dirEntry = fileEntry + 40;
+
+  check( content.substr( 0, 20 ) );				// truncated header
+  check( content.substr( 0, content.size()-1 ) );		// truncated strings
+  check( content + "x" );					// trailing garbage
+  check( std::string( content ).replace( 0, 1, "X" ) );		// magic
+  check( std::string( content ).replace( fileEntry + 8, 4, "\xff\xff\xff\xff" ) );	// path offset
+  check( std::string( content ).replace( fileEntry + 12, 4, "\xff\xff\x00\x00", 4 ) );	// pathlen
+  check( std::string( content ).replace( fileEntry + 16, 4, "\xff\xff\x00\x00", 4 ) );	// digest offset
+  check( std::string( content ).replace( dirEntry + 8, 4, "\xff\xff\xff\xff" ) );	// dir path offset
+}
+
+BOOST_AUTO_TEST_CASE(indexed_file_conflicts, * boost::unit_test::precondition( ReadsGeneratedRpm() ))
+{
+  filesystem::TmpDir tmp;
+  Repository repo { sat::Pool::instance().reposInsert( "fileconflicts" ) };
+  FileConflictsCB cb;
+
+  auto addPackage = [&]( const std::string & name_r, const std::vector<File> & files_r ) -> sat::detail::IdType {
+    sat::detail::IdType id = repo.addSolvable();
+    ::Solvable * s = sat::Solvable( id ).get();
+    s->name = IdString( name_r ).id();
+    s->evr  = IdString( "1-1" ).id();
+    s->arch = IdString( "noarch" ).id();
+    Pathname rpm { tmp.path() / ( name_r + ".rpm" ) };
+    writeRpm( rpm, name_r, files_r );
+    cb._files[id] = rpm;
+    return id;
+  };
+
+  // installed (rpmdbid: 1, 2, 3)
+  sat::detail::IdType a = addPackage( "a", {
+    { "/usr/bin/a",			S_IFREG|0755, "aaaa" },
+    { "/usr/share/common",		S_IFDIR|0755, "" },
+    { "/usr/share/common/readme",	S_IFREG|0644, "rrrr" },
+    { "/etc/shared.conf",		S_IFREG|0644, "ssss" },
+    { "/usr/lib/libx.so",		S_IFLNK|0777, "libx.so.1" },
+  } );
+  sat::detail::IdType b = addPackage( "b", {	// will be updated
+    { "/usr/bin/b",			S_IFREG|0755, "bbbb" },
+  } );
+  sat::detail::IdType g = addPackage( "g", {
+    { "/usr/lib/multi",			S_IFREG|0755, "m32m", 1 },
+  } );
+  // to install
+  sat::detail::IdType c = addPackage( "c", {
+    { "/usr/bin/a",			S_IFREG|0755, "cccc" },	// vs. a
+    { "/usr/share/common",		S_IFDIR|0700, "" },
+    { "/etc/shared.conf",		S_IFREG|0644, "ssss" },
+    { "/usr/bin/b",			S_IFREG|0755, "b2b2" },
+    { "/usr/lib/libx.so",		S_IFLNK|0777, "libx.so.1" },
+  } );
+  sat::detail::IdType d = addPackage( "d", {
+    { "/usr/bin/c",			S_IFREG|0755, "dddd" },
+    { "/usr/lib/libx.so",		S_IFLNK|0777, "libx.so.2" },	// vs. a and c
+  } );
+  sat::detail::IdType e = addPackage( "e", {
+    { "/usr/bin/c",			S_IFREG|0755, "eeee" },	// vs. d
+    { "/usr/lib/multi",			S_IFREG|0755, "m64m", 2 },
+  } );
+  sat::detail::IdType f = addPackage( "f", {
+    { "/usr/share/common/readme",	S_IFREG|0644, "rrrr" },
+  } );
+
+  // The index of the installed packages
+  Pathname indexfile { tmp.path() / "index" };
+  {
+    std::vector<Filelist> filelists;
+    std::vector<InstalledFilesIndex::Entry> entries;
+    unsigned rpmdbid = 0;
+    for ( sat::detail::IdType id : { a, b, g } )
+      filelists.emplace_back( cb._files[id] );
+    for ( const Filelist & filelist : filelists )
+    {
+      ++rpmdbid;
+      for ( const File & file : filelist._files )
+        entries.push_back( { file.path, file.digest, rpmdbid, file.mode, file.color } );
+    }
+    InstalledFilesIndex::write( entries, "cookie", indexfile );
+  }
+  InstalledFilesIndex index( indexfile, "cookie" );
+  BOOST_REQUIRE( index );
+
+  // libsolv
+  sat::Queue todo;
+  for ( sat::detail::IdType id : { c, d, e, f, a, g } )
+    todo.push( id );
+  sat::FileConflicts expected;
+  ::pool_findfileconflicts( sat::Pool::instance().get(), todo, 4, expected, 0, &FileConflictsCB::invoke, &cb );
+
+  // indexed
+  IndexedFileConflicts fileconflicts( index );
+  fileconflicts.addInstalled( 1, a );
+  fileconflicts.addInstalled( 3, g );
+  ProgressData progress( 4 );
+  sat::Queue noFilelist;
+  fileconflicts.readCandidates( { { c, cb._files[c] }, { d, cb._files[d] }, { e, cb._files[e] }, { f, cb._files[f] } }, progress, noFilelist );
+  BOOST_CHECK( noFilelist.empty() );
+  BOOST_CHECK( ! fileconflicts.aliasingInvolved() );
+  sat::FileConflicts conflicts;
+  fileconflicts.findConflicts( conflicts );
+
+  decltype(normalized( conflicts )) wanted {
+    { "/usr/bin/a", a, c },
+    { "/usr/bin/c", d, e },
+    { "/usr/lib/libx.so", a, d },
+    { "/usr/lib/libx.so", c, d },
+  };
+  BOOST_CHECK( normalized( expected ) == wanted );
+  BOOST_CHECK( normalized( conflicts ) == wanted );
+
+  // a missing package file is reported
+  IndexedFileConflicts missing( index );
+  noFilelist.clear();
+  missing.readCandidates( { { c, tmp.path() / "nonexisting.rpm" } }, progress, noFilelist );
+  BOOST_REQUIRE_EQUAL( noFilelist.size(), 1 );
+  BOOST_CHECK_EQUAL( noFilelist[0], c );
+
+  repo.eraseFromPool();
+}
@@ -8,6 +8,7 @@
 #include <zypp/PoolQueryUtil.tcc>
 #include <zypp/TmpPath.h>
 #include <zypp/Locks.h>
+#include <zypp/pool/HardLockMatcher.h>
 #include "TestSetup.h"
 
 #define BOOST_TEST_MODULE Locks
@@ -116,3 +117,59 @@ BOOST_AUTO_TEST_CASE( locks_empty )
   locks.removeEmpty();
   BOOST_CHECK( locks.size() == 0 );
 }
+
+BOOST_AUTO_TEST_CASE( locks_compiled )
+{
+  cout << "****compiled hard locks****"  << endl;
+  std::list<PoolQuery> queries;
+  {
+    PoolQuery q;	// plain name lock (like zypp writes them)
+    q.addAttribute( sat::SolvAttr::name, "zypper" );
+    q.addKind( ResKind::package );
+    q.setMatchExact();
+    q.setCaseSensitive( true );
+    queries.push_back( q );
+  }
+  {
+    PoolQuery q;	// plain name lock (like zypper writes them)
+    q.addAttribute( sat::SolvAttr::name, "LIBZYPP" );
+    q.addKind( ResKind::package );
+    q.setMatchGlob();
+    queries.push_back( q );
+  }
+  {
+    PoolQuery q;	// glob
+    q.addAttribute( sat::SolvAttr::name, "yast2-*" );
+    q.addKind( ResKind::package );
+    q.setMatchGlob();
+    queries.push_back( q );
+  }
+  {
+    PoolQuery q;	// repo restricted
+    q.addAttribute( sat::SolvAttr::name, "glibc" );
+    q.addKind( ResKind::package );
+    q.addRepo( "opensuse" );
+    q.setMatchExact();
+    queries.push_back( q );
+  }
+
+  pool::HardLockMatcher matcher( queries.begin(), queries.end() );
+  BOOST_CHECK_EQUAL( matcher.compiledSize(), 2 );
+  BOOST_CHECK_EQUAL( matcher.queriesSize(), 2 );
+
+  PoolQueryResult expected( queries.begin(), queries.end() );
+  PoolQueryResult result( matcher.matchAll() );
+  BOOST_CHECK( !expected.empty() );
+  BOOST_CHECK_EQUAL( result.size(), expected.size() );
+  for ( sat::Solvable slv : expected )
+    BOOST_CHECK( result.contains( slv ) );
+
+  // matching just some items
+  std::vector<PoolItem> items;
+  for ( const PoolItem & pi : ResPool::instance() )
+    if ( pi.repository().alias() == "opensuse" )
+      items.push_back( pi );
+  PoolQueryResult partial( matcher.match( items ) );
+  for ( const PoolItem & pi : items )
+    BOOST_CHECK_EQUAL( partial.contains( pi ), expected.contains( pi ) );
+}
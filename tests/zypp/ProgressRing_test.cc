@@ -0,0 +1,264 @@
+#include <iostream>
+#include <string>
+#include <variant>
+#include <cerrno>
+#include <cstring>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <shared/commit/ProgressRing.h>
+
+using std::cout;
+using std::endl;
+using namespace zypp::proto::target;
+
+namespace
+{
+  constexpr size_t dataOffset = 4096;	// the ring header page
+  constexpr size_t recordHead = 28;	// size of a records head (w/o text)
+
+  ProgressEvent logEvent( uint32_t level_r, std::string line_r, uint32_t msgSeq_r = 0 )
+  {
+    ProgressEvent ret { RpmLog{ level_r, std::move(line_r) } };
+    ret.msgSeq = msgSeq_r;
+    return ret;
+  }
+
+  /** Map the rings memfd to manipulate it. */
+  struct Mapped
+  {
+    Mapped( int fd_r, size_t size_r )
+    : _size( size_r )
+    , _map( static_cast<char *>( ::mmap( nullptr, size_r, PROT_READ|PROT_WRITE, MAP_SHARED, fd_r, 0 ) ) )
+    { BOOST_REQUIRE( _map != MAP_FAILED ); }
+
+    ~Mapped()
+    { ::munmap( _map, _size ); }
+
+    size_t _size;
+    char * _map;
+  };
+}
+
+BOOST_AUTO_TEST_CASE(push_pop)
+{
+  ProgressRing ring { ProgressRing::create( 4096 ) };
+  BOOST_REQUIRE( ring );
+
+  ProgressEvent ev;
+  BOOST_CHECK( ! ring.pop( ev, 100 ) );	// empty
+
+  {
+    ProgressEvent pkg { PackageProgress{ 7, 42 } };
+    pkg.msgSeq = 1;
+    BOOST_CHECK( ring.push( pkg ) );
+    ProgressEvent cleanup { CleanupProgress{ "foo-1-1.noarch", 50 } };
+    cleanup.msgSeq = 2;
+    BOOST_CHECK( ring.push( cleanup ) );
+    ProgressEvent trans { TransProgress{ 99 } };
+    trans.msgSeq = 2;
+    BOOST_CHECK( ring.push( trans ) );
+    BOOST_CHECK( ring.push( logEvent( 3, "a log line\n", 3 ) ) );
+  }
+
+  // events are not taken before their STOMP message count is reached
+  BOOST_CHECK( ! ring.pop( ev, 0 ) );
+  BOOST_REQUIRE( ring.pop( ev, 1 ) );
+  BOOST_CHECK_EQUAL( ev.type, ProgressEvent::PackageProgressType );
+  BOOST_CHECK_EQUAL( ev.msgSeq, 1 );
+  {
+    ProgressEvent::Message msg { ev.toMessage() };
+    BOOST_REQUIRE( std::holds_alternative<PackageProgress>( msg ) );
+    uint32_t stepId = std::get<PackageProgress>( msg ).stepId;
+    uint32_t amount = std::get<PackageProgress>( msg ).amount;
+    BOOST_CHECK_EQUAL( stepId, 7 );
+    BOOST_CHECK_EQUAL( amount, 42 );
+  }
+  BOOST_CHECK( ! ring.pop( ev, 1 ) );
+
+  BOOST_REQUIRE( ring.pop( ev, 2 ) );
+  {
+    ProgressEvent::Message msg { ev.toMessage() };
+    BOOST_REQUIRE( std::holds_alternative<CleanupProgress>( msg ) );
+    std::string nvra = std::get<CleanupProgress>( msg ).nvra;
+    uint32_t amount = std::get<CleanupProgress>( msg ).amount;
+    BOOST_CHECK_EQUAL( nvra, "foo-1-1.noarch" );
+    BOOST_CHECK_EQUAL( amount, 50 );
+  }
+  BOOST_REQUIRE( ring.pop( ev, 2 ) );
+  {
+    ProgressEvent::Message msg { ev.toMessage() };
+    BOOST_REQUIRE( std::holds_alternative<TransProgress>( msg ) );
+    uint32_t amount = std::get<TransProgress>( msg ).amount;
+    BOOST_CHECK_EQUAL( amount, 99 );
+  }
+  BOOST_CHECK( ! ring.pop( ev, 2 ) );
+
+  BOOST_REQUIRE( ring.pop( ev, 3 ) );
+  {
+    ProgressEvent::Message msg { ev.toMessage() };
+    BOOST_REQUIRE( std::holds_alternative<RpmLog>( msg ) );
+    uint32_t level = std::get<RpmLog>( msg ).level;
+    std::string line = std::get<RpmLog>( msg ).line;
+    BOOST_CHECK_EQUAL( level, 3 );
+    BOOST_CHECK_EQUAL( line, "a log line\n" );
+  }
+  BOOST_CHECK( ! ring.pop( ev, 100 ) );	// empty again
+}
+
+BOOST_AUTO_TEST_CASE(attach)
+{
+  ProgressRing consumer { ProgressRing::create( 4096 ) };
+  BOOST_REQUIRE( consumer );
+  ProgressRing producer { ProgressRing::attach( ::dup( consumer.fd() ) ) };
+  BOOST_REQUIRE( producer );
+
+  BOOST_CHECK( producer.push( logEvent( 1, "via shared memory" ) ) );
+  ProgressEvent ev;
+  BOOST_REQUIRE( consumer.pop( ev, 0 ) );
+  BOOST_CHECK_EQUAL( ev.text, "via shared memory" );
+  BOOST_CHECK( ! producer.pop( ev, 0 ) );	// consumed
+
+  // moved
+  ProgressRing moved { std::move(producer) };
+  BOOST_CHECK( ! producer );
+  BOOST_CHECK( moved.push( logEvent( 2, "moved" ) ) );
+  BOOST_REQUIRE( consumer.pop( ev, 0 ) );
+  BOOST_CHECK_EQUAL( ev.level, 2 );
+}
+
+BOOST_AUTO_TEST_CASE(wrap_around)
+{
+  ProgressRing ring { ProgressRing::create( 100 ) };	// rounded up to 4096
+  BOOST_REQUIRE( ring );
+
+  // ~60 bytes per record: the ring wraps many times, records are split at its end
+  unsigned popped = 0;
+  ProgressEvent ev;
+  for ( unsigned pushed = 0; pushed < 2000; ++pushed )
+  {
+    BOOST_REQUIRE( ring.push( logEvent( pushed, std::string( pushed % 61, 'a' + pushed % 26 ), pushed ) ) );
+    // keep about 20 events in the ring
+    if ( pushed >= 20 )
+    {
+      BOOST_REQUIRE( ring.pop( ev, pushed ) );
+      BOOST_REQUIRE_EQUAL( ev.level, popped );
+      BOOST_REQUIRE_EQUAL( ev.msgSeq, popped );
+      BOOST_REQUIRE_EQUAL( ev.text, std::string( popped % 61, 'a' + popped % 26 ) );
+      ++popped;
+    }
+  }
+  while ( ring.pop( ev, 2000 ) )
+  {
+    BOOST_REQUIRE_EQUAL( ev.level, popped );
+    BOOST_REQUIRE_EQUAL( ev.text, std::string( popped % 61, 'a' + popped % 26 ) );
+    ++popped;
+  }
+  BOOST_CHECK_EQUAL( popped, 2000 );
+}
+
+BOOST_AUTO_TEST_CASE(full_ring)
+{
+  ProgressRing ring { ProgressRing::create( 4096 ) };
+  BOOST_REQUIRE( ring );
+
+  // 4 byte text: 32 byte records fill the ring exactly
+  unsigned pushed = 0;
+  while ( ring.push( logEvent( pushed, "full" ) ) )
+    ++pushed;
+  BOOST_CHECK_EQUAL( pushed, 4096 / 32 );
+  BOOST_CHECK( ! ring.push( logEvent( pushed, "" ) ) );
+
+  // room for one more
+  ProgressEvent ev;
+  BOOST_REQUIRE( ring.pop( ev, 0 ) );
+  BOOST_CHECK_EQUAL( ev.level, 0 );
+  BOOST_CHECK( ring.push( logEvent( pushed, "full" ) ) );
+  BOOST_CHECK( ! ring.push( logEvent( pushed+1, "full" ) ) );
+
+  unsigned popped = 1;
+  while ( ring.pop( ev, 0 ) )
+  {
+    BOOST_REQUIRE_EQUAL( ev.level, popped );
+    ++popped;
+  }
+  BOOST_CHECK_EQUAL( popped, pushed+1 );
+
+  // overlong lines are truncated to 1/4 of the ring
+  BOOST_CHECK( ring.push( logEvent( 0, std::string( 10000, 'x' ) ) ) );
+  BOOST_REQUIRE( ring.pop( ev, 0 ) );
+  BOOST_CHECK_EQUAL( ev.text.size(), 4096/4 - recordHead - 8 );
+}
+
+BOOST_AUTO_TEST_CASE(corrupted_record)
+{
+  ProgressRing ring { ProgressRing::create( 4096 ) };
+  BOOST_REQUIRE( ring );
+  Mapped mapped( ring.fd(), dataOffset + 4096 );
+
+  BOOST_CHECK( ring.push( logEvent( 1, "one" ) ) );
+  BOOST_CHECK( ring.push( logEvent( 2, "two" ) ) );
+  // the 1st records length exceeds the data in the ring
+  uint32_t len = 4096;
+  ::memcpy( mapped._map + dataOffset, &len, sizeof(len) );
+
+  ProgressEvent ev;
+  BOOST_CHECK( ! ring.pop( ev, 100 ) );
+  BOOST_CHECK( ! ring.pop( ev, 100 ) );	// everything was dropped
+
+  // the ring is still usable
+  BOOST_CHECK( ring.push( logEvent( 3, "three" ) ) );
+  BOOST_REQUIRE( ring.pop( ev, 100 ) );
+  BOOST_CHECK_EQUAL( ev.level, 3 );
+  BOOST_CHECK_EQUAL( ev.text, "three" );
+
+  // unknown event type
+  BOOST_CHECK( ring.push( logEvent( 4, "four" ) ) );
+  mapped._map[dataOffset + 104 + 4] = 99;	// behind the records of 'one', 'two' and 'three' (32+32+40 bytes)
+  BOOST_CHECK( ! ring.pop( ev, 100 ) );
+}
+
+BOOST_AUTO_TEST_CASE(corrupted_header)
+{
+  ProgressRing ring { ProgressRing::create( 4096 ) };
+  BOOST_REQUIRE( ring );
+  Mapped mapped( ring.fd(), dataOffset + 4096 );
+
+  auto attachFails = [&]() -> bool {
+    int fd = ::dup( ring.fd() );
+    errno = 0;
+    ProgressRing other { ProgressRing::attach( fd ) };
+    if ( other )
+      return false;
+    ::close( fd );	// not taken on error
+    return errno == EINVAL;
+  };
+
+  BOOST_CHECK( ! attachFails() );
+
+  // magic
+  char magic[4];
+  ::memcpy( magic, mapped._map, 4 );
+  ::memcpy( mapped._map, "XXXX", 4 );
+  BOOST_CHECK( attachFails() );
+  ::memcpy( mapped._map, magic, 4 );
+  BOOST_CHECK( ! attachFails() );
+
+  // capacity not matching the size
+  uint32_t capacity = 8192;
+  ::memcpy( mapped._map + 4, &capacity, sizeof(capacity) );
+  BOOST_CHECK( attachFails() );
+
+  // too small to be a ring
+  {
+    int fd = ::memfd_create( "not-a-ring", 0 );
+    BOOST_REQUIRE( fd != -1 );
+    BOOST_REQUIRE( ::ftruncate( fd, dataOffset ) == 0 );
+    errno = 0;
+    BOOST_CHECK( ! ProgressRing::attach( fd ) );
+    BOOST_CHECK_EQUAL( errno, EINVAL );
+    ::close( fd );
+  }
+}
@@ -394,3 +394,36 @@ BOOST_DATA_TEST_CASE(purge_kernels, bdata::make( maketestdata() ), repoPath, una
 
   BOOST_REQUIRE_EQUAL( expectedRemovals.size(), removeCount );
 }
+
+BOOST_AUTO_TEST_CASE(purge_kernels_plan)
+{
+  TestSetup test( Arch_x86_64 );
+  test.loadTestcaseRepos( TESTS_SRC_DIR"/zypp/data/PurgeKernels/simple" );
+
+  PurgeKernels krnls;
+  krnls.setUnameR( "1-3-default" );
+  krnls.setKernelArch( Arch("x86_64") );
+  krnls.setKeepSpec( "oldest,running,latest" );
+
+  unsigned reported = 0;
+  std::set<std::string> planned;
+  PurgeKernels::Plan plan { krnls.computePlan( [&]( const PurgeKernels::Plan::Group & group_r ) {
+    ++reported;
+    for ( sat::Solvable slv : group_r.remove )
+      planned.insert( makeNVRA( PoolItem(slv) ) );
+  } ) };
+
+  BOOST_CHECK_EQUAL( reported, plan.groups.size() );
+  BOOST_CHECK( !plan.empty() );
+  BOOST_CHECK( planned.count( "kernel-default-1-2.x86_64" ) );
+  BOOST_CHECK( !planned.count( "kernel-default-1-3.x86_64" ) );
+
+  // computing the plan does not touch the pool
+  auto pool = ResPool::instance();
+  const filter::ByStatus toBeUninstalledFilter( &ResStatus::isToBeUninstalled );
+  BOOST_CHECK( pool.byStatusBegin( toBeUninstalledFilter ) == pool.byStatusEnd( toBeUninstalledFilter ) );
+
+  krnls.markObsoleteKernels( plan );
+  BOOST_REQUIRE( pool.resolver().resolvePool() );
+  BOOST_CHECK( pool.byStatusBegin( toBeUninstalledFilter ) != pool.byStatusEnd( toBeUninstalledFilter ) );
+}
@@ -98,3 +98,131 @@ BOOST_AUTO_TEST_CASE(inrOnlyRequires)
   // Fillup only namespace recommends
   BOOST_checkresult( resolve( inrMode|onlyRequires ), { Apde } );
 }
+
+BOOST_AUTO_TEST_CASE(warmStart)
+{
+  // Consecutive runs reuse the solver (and its last result if nothing changed)
+  auto reused = []() { return test.resolver().profile().reused; };
+  Ap.status().setTransact( true, ResStatus::USER );
+  BOOST_checkresult( resolve(), { Ap, Ip, Apde, Aprec } );
+  BOOST_CHECK( ! reused() );	// settings changed
+  BOOST_checkresult( resolve(), { Ap, Ip, Apde, Aprec } );
+  BOOST_CHECK( reused() );
+  Ap.status().setTransact( false, ResStatus::USER );
+  BOOST_checkresult( resolve( inrMode ), { Apde, Aprec } );
+  BOOST_CHECK( ! reused() );	// jobs changed
+  BOOST_checkresult( resolve( inrMode ), { Apde, Aprec } );
+  BOOST_CHECK( reused() );
+  Ap.status().setTransact( true, ResStatus::USER );
+  BOOST_checkresult( resolve(), { Ap, Ip, Apde, Aprec } );
+  BOOST_CHECK( ! reused() );
+  Ap.status().setTransact( false, ResStatus::USER );
+}
+
+BOOST_AUTO_TEST_CASE(evaluateSolutions)
+{
+  // locked installed aspell conflicts with updating aspell
+  Ip.status().setLock( true, ResStatus::USER );
+  Ap.status().setTransact( true, ResStatus::USER );
+  BOOST_CHECK( ! test.resolver().resolvePool() );
+
+  ResolverProblemList problems( test.resolver().problems() );
+  BOOST_REQUIRE( ! problems.empty() );
+  const ProblemSolutionList & solutions( problems.front()->solutions() );
+  ProblemSolutionEvaluationList evals( test.resolver().evaluateSolutions( solutions ) );
+  BOOST_CHECK_EQUAL( evals.size(), solutions.size() );
+  bool solved = false;
+  for ( const ProblemSolutionEvaluation & eval : evals )
+  {
+    BOOST_CHECK( eval.evaluated );
+    if ( eval.solved )
+      solved = true;
+  }
+  BOOST_CHECK( solved );
+
+  // the evaluation does not touch the pool
+  BOOST_CHECK( Ip.status().isLocked() );
+  BOOST_CHECK( Ap.status().isToBeInstalled() );
+
+  // solutions of a previous solver run are not evaluated
+  Ap.status().setTransact( false, ResStatus::USER );
+  Ip.status().setLock( false, ResStatus::USER );
+  BOOST_checkresult( resolve( inrMode ), { Apde, Aprec } );
+  evals = test.resolver().evaluateSolutions( solutions );
+  BOOST_REQUIRE_EQUAL( evals.size(), solutions.size() );
+  BOOST_CHECK( ! evals.front().evaluated );
+}
+
+BOOST_AUTO_TEST_CASE(whatIf)
+{
+  auto contains = []( const std::vector<sat::Solvable> & list_r, const PoolItem & pi_r )
+  { return std::find( list_r.begin(), list_r.end(), pi_r.satSolvable() ) != list_r.end(); };
+
+  BOOST_checkresult( resolve( inrMode ), { Apde, Aprec } );
+
+  PoolItem Iglibc( getIPi( "glibc" ) );
+  ResolverWhatIfRequestList requests( 3 );
+  requests[1].install.push_back( Ap );
+  requests[2].remove.push_back( Iglibc );
+  ResolverWhatIfResultList results( test.resolver().whatIf( requests ) );
+  BOOST_REQUIRE_EQUAL( results.size(), requests.size() );
+  for ( const ResolverWhatIfResult & result : results )
+    BOOST_CHECK( result.solved );
+
+  BOOST_CHECK( contains( results[0].installs, Apde ) );
+  BOOST_CHECK( ! contains( results[0].installs, Ap ) );
+  BOOST_CHECK( results[0].removes.empty() );
+  BOOST_CHECK( contains( results[1].installs, Ap ) );
+  BOOST_CHECK( contains( results[1].removes, Ip ) );
+  BOOST_CHECK( ! contains( results[1].removes, Iglibc ) );
+  BOOST_CHECK( contains( results[2].removes, Iglibc ) );
+  BOOST_CHECK( ! contains( results[2].installs, Ap ) );
+
+  // neither the pool nor the last result are touched
+  PoolItemSet transacts { make_filter_begin<resfilter::ByTransact>(test.pool()), make_filter_end<resfilter::ByTransact>(test.pool()) };
+  BOOST_checkresult( transacts, { Apde, Aprec } );
+  BOOST_CHECK( test.resolver().problems().empty() );
+}
+
+BOOST_AUTO_TEST_CASE(profile)
+{
+  Ap.status().setTransact( true, ResStatus::USER );
+  BOOST_checkresult( resolve(), { Ap, Ip, Apde, Aprec } );
+  {
+    const ResolverProfile & profile( test.resolver().profile() );
+    BOOST_CHECK( profile.jobCount > 0 );
+    BOOST_CHECK( profile.decisions > 0 );
+    BOOST_CHECK_EQUAL( profile.problemCount, 0 );
+    BOOST_CHECK( profile.rules.count( "pkg" ) );
+    BOOST_CHECK( profile.rules.count( "job" ) );
+    BOOST_CHECK( profile.ruleCount() >= profile.rules.at( "pkg" ) );
+
+    BOOST_CHECK_EQUAL( profile.transaction.count(), 0 );
+    test.resolver().getTransaction();
+    std::string json( profile.asJSON() );
+    BOOST_CHECK( json.find( "\"solve_us\"" ) != std::string::npos );
+    BOOST_CHECK( json.find( "\"rules\": {" ) != std::string::npos );
+  }
+  Ap.status().setTransact( false, ResStatus::USER );
+}
+
+BOOST_AUTO_TEST_CASE(compactTestcase)
+{
+  // repos are written as solv files and recognized as such when loading
+  filesystem::TmpDir tmp;
+  Pathname dumpPath( tmp.path() / "testcase" );
+  BOOST_REQUIRE( test.resolver().createCompactSolverTestcase( dumpPath.asString(), false ) );
+  BOOST_CHECK( PathInfo( dumpPath / "zypp-control.yaml" ).isFile() );
+  BOOST_CHECK( ! PathInfo( dumpPath / "testcase.t" ).isExist() );
+
+  misc::testcase::LoadTestcase loader;
+  std::string err;
+  BOOST_REQUIRE( loader.loadTestcaseAt( dumpPath, &err ) );
+  const auto & repos( loader.setupInfo().repos() );
+  BOOST_CHECK( ! repos.empty() );
+  for ( const auto & repo : repos )
+  {
+    BOOST_CHECK( repo.type() == misc::testcase::TestcaseRepoType::Solv );
+    BOOST_CHECK( PathInfo( dumpPath / repo.path() ).isFile() );
+  }
+}
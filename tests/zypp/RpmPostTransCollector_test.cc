@@ -0,0 +1,89 @@
+#include <iostream>
+#include <vector>
+#include <set>
+
+#include <boost/test/unit_test.hpp>
+
+#include <zypp/target/RpmPostTransCollector.h>
+
+using std::cout;
+using std::endl;
+using namespace zypp;
+using target::RpmPostTransCollector;
+
+namespace
+{
+  using ScriptJob = RpmPostTransCollector::ScriptJob;
+  using Batches = std::vector<std::pair<size_t,size_t>>;
+
+  ScriptJob job( const std::string & pkgname_r, const std::string & content_r, int npkgs_r = 1 )
+  {
+    ScriptJob ret;
+    ret._script = pkgname_r + "-1-1.noarch.XXXXXX";
+    ret._pkgident = pkgname_r + "-1-1.noarch";
+    ret._pkgname = pkgname_r;
+    ret._content = content_r;
+    ret._npkgs = npkgs_r;
+    return ret;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(plan_duplicates)
+{
+  std::vector<ScriptJob> jobs {
+    job( "a", "#! /bin/sh\nupdate-cache\n" ),
+    job( "b", "#! /bin/sh\nsomething else\n" ),
+    job( "c", "#! /bin/sh\nupdate-cache\n" ),		// same as a
+    job( "d", "#! /bin/sh\nupdate-cache\n", 2 ),	// different argument
+    job( "e", "#! /bin/sh\nupdate-cache\n", 2 ),	// same as d
+  };
+  RpmPostTransCollector::planScriptJobs( jobs, {} );
+
+  BOOST_CHECK_EQUAL( jobs[0]._duplicateOf, -1 );
+  BOOST_CHECK_EQUAL( jobs[1]._duplicateOf, -1 );
+  BOOST_CHECK_EQUAL( jobs[2]._duplicateOf, 0 );
+  BOOST_CHECK_EQUAL( jobs[3]._duplicateOf, -1 );
+  BOOST_CHECK_EQUAL( jobs[4]._duplicateOf, 3 );
+  for ( const ScriptJob & j : jobs )
+    BOOST_CHECK( ! j._parallel );
+
+  // each script is executed once: just serial batches
+  Batches batches { RpmPostTransCollector::scriptBatches( jobs ) };
+  BOOST_CHECK( batches == Batches({ {0,1}, {1,2}, {2,3}, {3,4}, {4,5} }) );
+}
+
+BOOST_AUTO_TEST_CASE(plan_parallel)
+{
+  std::vector<ScriptJob> jobs {
+    job( "icons", "icons" ),
+    job( "mime", "mime" ),
+    job( "serial", "serial" ),
+    job( "fonts", "fonts" ),
+    job( "other", "mime" ),	// duplicate of a parallel one
+    job( "desktop", "desktop" ),
+    job( "last", "last" ),
+  };
+  RpmPostTransCollector::planScriptJobs( jobs, { "icons", "mime", "fonts", "desktop" } );
+
+  std::vector<bool> parallel;
+  for ( const ScriptJob & j : jobs )
+    parallel.push_back( j._parallel );
+  BOOST_CHECK( parallel == std::vector<bool>({ true, true, false, true, false, true, false }) );
+  BOOST_CHECK_EQUAL( jobs[4]._duplicateOf, 1 );
+
+  // a serial script is a barrier, a duplicate does not break a batch
+  Batches batches { RpmPostTransCollector::scriptBatches( jobs ) };
+  BOOST_CHECK( batches == Batches({ {0,2}, {2,3}, {3,6}, {6,7} }) );
+}
+
+BOOST_AUTO_TEST_CASE(plan_empty)
+{
+  std::vector<ScriptJob> jobs;
+  RpmPostTransCollector::planScriptJobs( jobs, { "icons" } );
+  BOOST_CHECK( RpmPostTransCollector::scriptBatches( jobs ).empty() );
+
+  jobs.push_back( job( "serial", "serial" ) );
+  jobs.push_back( job( "dup", "serial" ) );
+  RpmPostTransCollector::planScriptJobs( jobs, {} );
+  BOOST_CHECK( RpmPostTransCollector::scriptBatches( jobs ) == Batches({ {0,1}, {1,2} }) );
+}
@@ -11,14 +11,18 @@
 
 #include <zypp-core/rpc/PluginFrame.h>
 #include <shared/commit/CommitMessages.h>
+#include <shared/commit/ProgressRing.h>
 
 #include <boost/interprocess/sync/file_lock.hpp>
+#include <chrono>
 #include <mutex>
+#include <optional>
 
 // we do not link against libzypp, but these are pure header only files, if that changes
 // a copy should be created directly in the zypp-rpm project
 #include <zypp/target/rpm/librpm.h>
 #include <zypp/target/rpm/RpmFlags.h>
+#include <zypp/base/ParallelFor.h>
 
 extern "C"
 {
@@ -29,6 +33,7 @@ extern "C"
 #include "BinHeader.h"
 #include "errorcodes.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <iostream>
 #include <signal.h>
@@ -57,9 +62,16 @@ namespace env
 // Usually relying on conventions is not exactly a good idea but in this case we make an exception ;)
 enum class ExpectedFds : int {
   MessageFd = STDERR_FILENO+1,
-  ScriptFd  = STDERR_FILENO+2
+  ScriptFd  = STDERR_FILENO+2,
+  ProgressFd = STDERR_FILENO+3  // only if the Commit message has progressRing set
 };
 
+// number of STOMP messages sent, events in the progress ring refer to it to keep the order
+uint32_t sentMessages = 0;
+
+// shared memory ring for high frequency events, if libzypp provided one
+zypp::proto::target::ProgressRing progressRing;
+
 using zypp::target::rpm::RpmInstFlag;
 using zypp::target::rpm::RpmInstFlags;
 using namespace zypprpm;
@@ -116,6 +128,7 @@ bool pushMessage ( const Message &msg ) {
     }
 
     maybeMessage->writeTo(outStr);
+    ++sentMessages;
     return true;
 
   } catch ( const zypp::Exception &e ) {
@@ -124,6 +137,18 @@ bool pushMessage ( const Message &msg ) {
   return false;
 }
 
+// sends a high frequency event via the progress ring, or as STOMP message if there is no ring or it is full
+template <typename Message>
+bool pushProgress ( const Message &msg ) {
+  if ( progressRing ) {
+    zypp::proto::target::ProgressEvent ev( msg );
+    ev.msgSeq = sentMessages;
+    if ( progressRing.push( ev ) )
+      return true;
+  }
+  return pushMessage( msg );
+}
+
 bool pushTransactionErrorMessage ( rpmps ps )
 {
   if ( !ps )
@@ -175,6 +200,47 @@ std::pair<RpmHeader, int> readPackage( rpmts ts_r, const zypp::filesystem::Pathn
 }
 
 
+using PrereadResult = std::optional<std::pair<RpmHeader, int>>;
+
+/*!
+ * Reads and verifies the headers of all packages to install in \a steps_r on a few threads,
+ * so the serial phase adding the transaction elements does not need to wait for the disk.
+ * Each thread uses its own transaction set (and thereby keyring), set up like \a ts_r.
+ * The result is indexed like \a steps_r, steps that were not read are left empty.
+ */
+std::vector<PrereadResult> prereadPackages( rpmts ts_r, const std::vector<zypp::proto::target::TransactionStep> &steps_r, unsigned &threads_r )
+{
+  std::vector<PrereadResult> res( steps_r.size() );
+
+  std::vector<size_t> todo;
+  for ( size_t i = 0; i < steps_r.size(); ++i ) {
+    if ( std::holds_alternative<zypp::proto::target::InstallStep>( steps_r[i] ) )
+      todo.push_back( i );
+  }
+
+  threads_r = std::min( zypp::base::parallelJobs( todo.size(), 1 ), 8U );
+  if ( threads_r < 2 ) {
+    // not worth the effort, addStep will read them
+    threads_r = 0;
+    return res;
+  }
+
+  zypp::base::parallelFor( todo.size(), threads_r, [&]( unsigned, size_t begin_r, size_t end_r ) {
+    zypp::AutoDispose<rpmts> ts( ::rpmtsCreate(), ::rpmtsFree );
+    ::rpmtsSetRootDir( ts, ::rpmtsRootDir( ts_r ) );
+    ::rpmtsSetVSFlags( ts, ::rpmtsVSFlags( ts_r ) );
+#ifdef HAVE_RPMTSSETVFYLEVEL
+    ::rpmtsSetVfyLevel( ts, ::rpmtsVfyLevel( ts_r ) );
+#endif
+    for ( size_t n = begin_r; n < end_r; ++n ) {
+      const auto i = todo[n];
+      res[i] = readPackage( ts, std::get<zypp::proto::target::InstallStep>( steps_r[i] ).pathname );
+    }
+  } );
+
+  return res;
+}
+
 struct TransactionData {
   zypp::proto::target::Commit &commitData;
 
@@ -219,8 +285,8 @@ int main( int, char ** )
   zyppng::blockSignalsForCurrentThread( { SIGPIPE, SIGINT } );
 
   // lets read our todo from stdin
-  // since all we can receive on stdin is the commit message, there is no need to read a envelope first
-  // we read it directly from the FD
+  // since all we can receive on stdin is the commit message (followed by the steps if it is streamed),
+  // there is no need to read a envelope first, we read it directly from the FD
   zypp::proto::target::Commit msg;
 
   try {
@@ -235,6 +301,12 @@ int main( int, char ** )
     return WrongMessageFormat;
   }
 
+  if ( msg.progressRing ) {
+    progressRing = zypp::proto::target::ProgressRing::attach( static_cast<int>( ExpectedFds::ProgressFd ) );
+    if ( !progressRing )
+      ZERR << "Failed to map the progress ring (" << zypp::str::strerror( errno ) << "), sending all events as messages" << std::endl;
+  }
+
   // create or fill a pid file, if there is a existing one just take it over
   // if we reach this place libzypp has its global lock and made sure there is
   // no still running zypp-rpm instance. So no need to do anything complicated.
@@ -341,7 +413,23 @@ int main( int, char ** )
   // do we care about knowing the public key?
   const bool allowUntrusted = ( rpmInstFlags & RpmInstFlag::RPMINST_ALLOWUNTRUSTED );
 
-  for ( int i = 0; i < msg.transactionSteps.size(); i++ ) {
+  // read the package headers of the steps we already know in parallel
+  std::vector<PrereadResult> preread;
+  {
+    zypp::proto::target::HeaderPreread stats;
+    const auto start = std::chrono::steady_clock::now();
+    preread = prereadPackages( ts, msg.transactionSteps, stats.threads );
+    if ( stats.threads ) {
+      stats.headers = std::count_if( preread.begin(), preread.end(), []( const auto &r ) { return bool(r); } );
+      stats.milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now() - start ).count();
+      ZDBG << "Read " << stats.headers << " package headers using " << stats.threads << " threads in " << stats.milliseconds << "ms" << std::endl;
+      pushMessage( stats );
+    }
+  }
+
+  // adds the step at index i of msg.transactionSteps to the transaction
+  // rpm remembers a pointer to the step as callback key, so the steps vector must not be reallocated afterwards
+  const auto &addStep = [&]( int i ) -> int {
     const auto &step = msg.transactionSteps[i];
 
     if ( std::holds_alternative<zypp::proto::target::InstallStep>(step) ) {
@@ -349,7 +437,7 @@ int main( int, char ** )
       const auto &install = std::get<zypp::proto::target::InstallStep>(step);
 
       const auto &file = install.pathname;
-      auto rpmHeader = readPackage( ts, install.pathname );
+      auto rpmHeader = ( i < preread.size() && preread[i] ) ? std::move( *preread[i] ) : readPackage( ts, install.pathname );
 
       switch(rpmHeader.second) {
         case RPMRC_OK:
@@ -425,6 +513,51 @@ int main( int, char ** )
       ZERR << "Ignoring step that is neither a remove, nor a install." << std::endl;
     }
 
+    return NoError;
+  };
+
+  // in streamed mode more steps arrive while libzypp is still downloading the packages,
+  // make sure there is room for all of them
+  if ( msg.streamed )
+    msg.transactionSteps.reserve( std::max<size_t>( msg.stepCount, msg.transactionSteps.size() ) );
+
+  for ( int i = 0; i < msg.transactionSteps.size(); i++ ) {
+    if ( const auto res = addStep( i ); res != NoError )
+      return res;
+  }
+
+  if ( msg.streamed ) {
+    // read the headers and add the steps to the transaction as they come in
+    try {
+      while ( true ) {
+        zypp::PluginFrame pf( std::cin );
+        if ( pf.command() == zypp::proto::target::CommitStepsDone::typeName )
+          break;
+
+        const auto &expMsg = zypp::proto::target::CommitSteps::fromStompMessage ( pf );
+        if ( !expMsg ) {
+          std::rethrow_exception ( expMsg.error() );
+        }
+
+        for ( const auto &step : expMsg->transactionSteps ) {
+          if ( msg.transactionSteps.size() == msg.transactionSteps.capacity() ) {
+            ZERR << "Received more steps than announced in the commit message, aborting" << std::endl;
+            return WrongMessageFormat;
+          }
+          msg.transactionSteps.push_back( step );
+          if ( const auto res = addStep( msg.transactionSteps.size() - 1 ); res != NoError )
+            return res;
+        }
+      }
+    } catch ( const zypp::Exception &e ) {
+      ZERR << "Wrong commit steps message format, aborting (" << e << ")" << std::endl;
+      return WrongMessageFormat;
+    }
+
+    if ( msg.transactionSteps.empty() ) {
+      ZDBG << "No transaction steps received, nothing to do." << std::endl;
+      return NoError;
+    }
   }
 
   // set the callback function for progress reporting and things
@@ -751,7 +884,7 @@ void *rpmLibCallback( const void *h, const rpmCallbackType what, const rpm_loff_
       zypp::proto::target::PackageProgress step;
       step.stepId = std::visit([](const auto &val){ return val.stepId;}, *iStep );
       step.amount = progress;
-      pushMessage( step );
+      pushProgress( step );
 
       break;
     }
@@ -771,13 +904,13 @@ void *rpmLibCallback( const void *h, const rpmCallbackType what, const rpm_loff_
         zypp::proto::target::CleanupProgress step;
         step.nvra = header.nvra();
         step.amount = progress;
-        pushMessage( step );
+        pushProgress( step );
 
       } else {
         zypp::proto::target::PackageProgress step;
         step.stepId = std::visit([](const auto &val){ return val.stepId;}, *iStep );
         step.amount = progress;
-        pushMessage( step );
+        pushProgress( step );
       }
       break;
     }
@@ -816,7 +949,7 @@ void *rpmLibCallback( const void *h, const rpmCallbackType what, const rpm_loff_
                                       : 100.0);
       zypp::proto::target::TransProgress prog;
       prog.amount = percentage;
-      pushMessage( prog );
+      pushProgress( prog );
       break;
     }
     case RPMCALLBACK_CPIO_ERROR:
@@ -877,7 +1010,7 @@ int rpmLogCallback ( rpmlogRec rec, rpmlogCallbackData )
   zypp::proto::target::RpmLog log;
   log.level = rpmlogRecPriority(rec);
   log.line  =  zypp::str::asString( ::rpmlogRecMessage(rec) );
-  pushMessage( log );
+  pushProgress( log );
 
   return logRc;
 }
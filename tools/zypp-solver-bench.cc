@@ -0,0 +1,442 @@
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+#include <zypp/Resolver.h>
+#include <zypp/ResPool.h>
+#include <zypp/base/String.h>
+#include "argparse.h"
+
+#define INCLUDE_TESTSETUP_WITHOUT_BOOST
+#include "../tests/lib/TestSetup.h"
+#undef  INCLUDE_TESTSETUP_WITHOUT_BOOST
+
+static std::string appname { "NO_NAME" };
+
+int errexit( const std::string & msg_r = std::string(), int exit_r = 100 )
+{
+  if ( ! msg_r.empty() )
+    cerr << endl << appname << ": ERR: " << msg_r << endl << endl;
+  return exit_r;
+}
+
+int usage( const argparse::Options & options_r, int return_r = 0 )
+{
+  cerr << "USAGE: " << appname << " [OPTION]... TESTCASEDIR..." << endl;
+  cerr << "    Replay solver testcases and report the resolver timings." << endl;
+  cerr << "    A TESTCASEDIR is either a solver testcase or a directory containing" << endl;
+  cerr << "    solver testcases. Each testcase is loaded in a separate process and" << endl;
+  cerr << "    resolved RUNS times. Timings are reported in ms, the memory high-water" << endl;
+  cerr << "    mark of the process in MiB." << endl;
+  cerr << options_r << endl;
+  cerr << "    Exit code 2 if a testcase is more than THRESHOLD percent slower (p50)" << endl;
+  cerr << "    or uses more memory than in the BASELINE." << endl;
+  return return_r;
+}
+
+///////////////////////////////////////////////////////////////////
+namespace
+{
+  using Clock = std::chrono::steady_clock;
+  using Usec  = std::chrono::microseconds;
+
+  /** The summary of a testcase. All times in microseconds, memory in KiB. */
+  struct Stats
+  {
+    unsigned runs = 0;
+    unsigned problems = 0;
+    long load = 0;
+    long min = 0;
+    long p50 = 0;
+    long p90 = 0;
+    long p99 = 0;
+    long max = 0;
+    long solve50 = 0;
+    long maxrss = 0;
+
+    std::string asString() const
+    { return str::Str() << runs << " " << problems << " " << load << " " << min << " " << p50 << " " << p90 << " " << p99 << " " << max << " " << solve50 << " " << maxrss; }
+
+    static bool fromString( const std::string & line_r, Stats & stats_r )
+    {
+      std::istringstream str( line_r );
+      str >> stats_r.runs >> stats_r.problems >> stats_r.load >> stats_r.min >> stats_r.p50 >> stats_r.p90 >> stats_r.p99 >> stats_r.max >> stats_r.solve50 >> stats_r.maxrss;
+      return bool(str);
+    }
+  };
+
+  /** Nearest-rank percentile of sorted \a vals_r. */
+  inline long percentile( const std::vector<long> & vals_r, unsigned pct_r )
+  {
+    if ( vals_r.empty() )
+      return 0;
+    size_t rank = std::ceil( pct_r / 100.0 * vals_r.size() );
+    return vals_r[ rank ? rank-1 : 0 ];
+  }
+
+  inline std::string ms( long usec_r )
+  { return str::form( "%.3f", usec_r / 1000.0 ); }
+
+  inline std::string mib( long kib_r )
+  { return str::form( "%.1f", kib_r / 1024.0 ); }
+
+  /** Jobs of a testcase trial; applied to the pool once and to each resolver. */
+  struct Jobs
+  {
+    enum Mode { Resolve, Upgrade, Update, Verify };
+    Mode mode = Resolve;
+    CapabilitySet requireCaps;
+    CapabilitySet conflictCaps;
+    std::vector<std::string> upgradeRepos;
+  };
+
+  /** The item a trial job refers to (the best matching one). */
+  PoolItem jobItem( const misc::testcase::TestcaseTrial::Node & node_r, bool installed_r )
+  {
+    std::string kind    { node_r.getProp( "kind", "package" ) };
+    std::string channel { node_r.getProp( "channel" ) };
+    std::string arch    { node_r.getProp( "arch" ) };
+    std::string version { node_r.getProp( "version" ) };
+    std::string release { node_r.getProp( "release" ) };
+
+    PoolItem ret;
+    for ( const PoolItem & pi : ResPool::instance().byIdent( ResKind( kind ), node_r.getProp( "name" ) ) )
+    {
+      if ( ( ! channel.empty() && pi.repoInfo().alias() != channel )
+        || ( ! arch.empty() && pi.arch().asString() != arch )
+        || ( ! version.empty() && pi.edition().version() != version )
+        || ( ! release.empty() && pi.edition().release() != release ) )
+        continue;
+      // prefer the requested installed state, then the highest edition
+      if ( ! ret
+        || ( pi.isSystem() == installed_r && ret.isSystem() != installed_r )
+        || ( pi.isSystem() == ret.isSystem() && pi.edition() > ret.edition() ) )
+        ret = pi;
+    }
+    return ret;
+  }
+
+  void applyTrials( const misc::testcase::LoadTestcase::TestcaseTrials & trials_r, Jobs & jobs_r )
+  {
+    for ( const auto & trial : trials_r )
+    {
+      for ( const auto & node : trial.nodes() )
+      {
+        const std::string & job { node.name() };
+        if ( job == "install" || job == "uninstall" || job == "lock" || job == "keep" )
+        {
+          PoolItem pi { jobItem( node, job == "uninstall" ) };
+          if ( ! pi )
+          {
+            cerr << "  Ignore " << job << " " << node.getProp( "name" ) << ": no matching item" << endl;
+            continue;
+          }
+          if ( job == "install" )
+            pi.status().setToBeInstalled( ResStatus::USER );
+          else if ( job == "uninstall" )
+            pi.status().setToBeUninstalled( ResStatus::USER );
+          else if ( job == "lock" )
+            pi.status().setLock( true, ResStatus::USER );
+          else
+            pi.status().resetTransact( ResStatus::USER );
+        }
+        else if ( job == "addRequire" )
+          jobs_r.requireCaps.insert( Capability( node.getProp( "name" ) ) );
+        else if ( job == "addConflict" )
+          jobs_r.conflictCaps.insert( Capability( node.getProp( "name" ) ) );
+        else if ( job == "upgradeRepo" )
+          jobs_r.upgradeRepos.push_back( node.getProp( "name" ) );
+        else if ( job == "distupgrade" )
+          jobs_r.mode = Jobs::Upgrade;
+        else if ( job == "update" )
+          jobs_r.mode = Jobs::Update;
+        else if ( job == "verify" )
+          jobs_r.mode = Jobs::Verify;
+        else
+          cerr << "  Ignore unsupported job " << job << endl;
+      }
+    }
+  }
+
+  void setupResolver( Resolver & resolver_r, const misc::testcase::TestcaseSetup & setup_r, const Jobs & jobs_r )
+  {
+    resolver_r.setFocus                    ( setup_r.resolverFocus() );
+    resolver_r.setIgnoreAlreadyRecommended ( setup_r.ignorealreadyrecommended() );
+    resolver_r.setOnlyRequires             ( setup_r.onlyRequires() );
+    resolver_r.setForceResolve             ( setup_r.forceResolve() );
+    resolver_r.setCleandepsOnRemove        ( setup_r.cleandepsOnRemove() );
+    resolver_r.setAllowDowngrade           ( setup_r.allowDowngrade() );
+    resolver_r.setAllowNameChange          ( setup_r.allowNameChange() );
+    resolver_r.setAllowArchChange          ( setup_r.allowArchChange() );
+    resolver_r.setAllowVendorChange        ( setup_r.allowVendorChange() );
+    resolver_r.dupSetAllowDowngrade        ( setup_r.dupAllowDowngrade() );
+    resolver_r.dupSetAllowNameChange       ( setup_r.dupAllowNameChange() );
+    resolver_r.dupSetAllowArchChange       ( setup_r.dupAllowArchChange() );
+    resolver_r.dupSetAllowVendorChange     ( setup_r.dupAllowVendorChange() );
+
+    for ( const auto & cap : jobs_r.requireCaps )
+      resolver_r.addRequire( cap );
+    for ( const auto & cap : jobs_r.conflictCaps )
+      resolver_r.addConflict( cap );
+    for ( const auto & alias : jobs_r.upgradeRepos )
+      resolver_r.addUpgradeRepo( sat::Pool::instance().reposFind( alias ) );
+  }
+
+  bool resolve( Resolver & resolver_r, const Jobs & jobs_r )
+  {
+    switch ( jobs_r.mode )
+    {
+      case Jobs::Upgrade:	return resolver_r.doUpgrade();
+      case Jobs::Update:	resolver_r.doUpdate(); return true;
+      case Jobs::Verify:	return resolver_r.verifySystem();
+      case Jobs::Resolve:	break;
+    }
+    return resolver_r.resolvePool();
+  }
+
+  /** Load and replay the testcase at \a dir_r (in the current process). */
+  Stats benchTestcase( const Pathname & dir_r, unsigned runs_r, bool warm_r )
+  {
+    Stats ret;
+    if ( ::chdir( dir_r.c_str() ) != 0 )	// external yaml files are relative to the testcase
+      ZYPP_THROW( Exception( "Failed to chdir to " + dir_r.asString() ) );
+
+    Clock::time_point start { Clock::now() };
+    TestSetup test;
+    misc::testcase::LoadTestcase::TestcaseTrials trials;
+    misc::testcase::TestcaseSetup setup;
+    test.loadTestcaseRepos( dir_r, &trials, &setup );
+    Jobs jobs;
+    applyTrials( trials, jobs );
+    sat::Pool::instance().prepare();
+    ret.load = std::chrono::duration_cast<Usec>( Clock::now() - start ).count();
+
+    std::vector<long> wall;
+    std::vector<long> solve;
+    Resolver_Ptr resolver;
+    for ( unsigned run = 0; run < runs_r; ++run )
+    {
+      if ( ! resolver || ! warm_r )
+      {
+        // a new resolver starts cold (no reusable solver or result)
+        resolver = new Resolver( ResPool::instance() );
+        setupResolver( *resolver, setup, jobs );
+      }
+      start = Clock::now();
+      bool ok = resolve( *resolver, jobs );
+      if ( ! ok )
+        ret.problems = resolver->problems().size();
+      wall.push_back( std::chrono::duration_cast<Usec>( Clock::now() - start ).count() );
+      solve.push_back( resolver->profile().solve.count() );
+    }
+    ret.runs = runs_r;
+
+    std::sort( wall.begin(), wall.end() );
+    std::sort( solve.begin(), solve.end() );
+    ret.min = wall.front();
+    ret.p50 = percentile( wall, 50 );
+    ret.p90 = percentile( wall, 90 );
+    ret.p99 = percentile( wall, 99 );
+    ret.max = wall.back();
+    ret.solve50 = percentile( solve, 50 );
+
+    struct rusage usage;
+    if ( ::getrusage( RUSAGE_SELF, &usage ) == 0 )
+      ret.maxrss = usage.ru_maxrss;
+    return ret;
+  }
+
+  /** Run \ref benchTestcase in a child process so each testcase starts with a fresh pool. */
+  bool benchInChild( const Pathname & dir_r, unsigned runs_r, bool warm_r, Stats & stats_r )
+  {
+    int fds[2];
+    if ( ::pipe( fds ) != 0 )
+      return false;
+
+    pid_t pid = ::fork();
+    if ( pid < 0 )
+    {
+      ::close( fds[0] );
+      ::close( fds[1] );
+      return false;
+    }
+    if ( pid == 0 )
+    {
+      ::close( fds[0] );
+      int ret = 1;
+      try
+      {
+        std::string line { benchTestcase( dir_r, runs_r, warm_r ).asString() + "\n" };
+        if ( ::write( fds[1], line.c_str(), line.size() ) == ssize_t(line.size()) )
+          ret = 0;
+      }
+      catch ( const Exception & excpt )
+      {
+        cerr << "  " << excpt.asUserString() << endl;
+      }
+      ::close( fds[1] );
+      ::_exit( ret );
+    }
+
+    ::close( fds[1] );
+    std::string line;
+    char buf[256];
+    for ( ssize_t got = 0; ( got = ::read( fds[0], buf, sizeof(buf) ) ) != 0; )
+    {
+      if ( got < 0 )
+      {
+        if ( errno == EINTR )
+          continue;
+        break;
+      }
+      line.append( buf, got );
+    }
+    ::close( fds[0] );
+
+    int status = 0;
+    while ( ::waitpid( pid, &status, 0 ) < 0 && errno == EINTR )
+    {;}
+    return WIFEXITED( status ) && WEXITSTATUS( status ) == 0 && Stats::fromString( line, stats_r );
+  }
+
+  /** Baseline file: one line per testcase: <tt>name p50 p90 maxrss</tt> */
+  using Baseline = std::map<std::string,Stats>;
+
+  Baseline readBaseline( const Pathname & file_r )
+  {
+    Baseline ret;
+    std::ifstream in( file_r.c_str() );
+    for ( std::string line; std::getline( in, line ); )
+    {
+      if ( line.empty() || line[0] == '#' )
+        continue;
+      std::istringstream str( line );
+      std::string name;
+      Stats stats;
+      if ( str >> name >> stats.p50 >> stats.p90 >> stats.maxrss )
+        ret[name] = stats;
+    }
+    return ret;
+  }
+
+  bool writeBaseline( const Pathname & file_r, const std::vector<std::pair<std::string,Stats>> & results_r )
+  {
+    std::ofstream out( file_r.c_str() );
+    out << "# " << appname << " baseline: name p50[us] p90[us] maxrss[KiB]" << endl;
+    for ( const auto & result : results_r )
+      out << result.first << " " << result.second.p50 << " " << result.second.p90 << " " << result.second.maxrss << endl;
+    return bool(out);
+  }
+
+  inline std::string delta( long now_r, long base_r )
+  { return base_r ? str::form( "%+.1f%%", ( now_r - base_r ) * 100.0 / base_r ) : std::string( "-" ); }
+
+  /** Collect the testcases at or below \a path_r. */
+  void collectTestcases( const Pathname & path_r, std::vector<Pathname> & testcases_r )
+  {
+    if ( TestSetup::isTestcase( path_r ) )
+    {
+      testcases_r.push_back( path_r );
+      return;
+    }
+    std::list<std::string> entries;
+    filesystem::readdir( entries, path_r, /*dots*/false );
+    entries.sort();
+    for ( const std::string & entry : entries )
+    {
+      Pathname dir { path_r / entry };
+      if ( PathInfo( dir ).isDir() && TestSetup::isTestcase( dir ) )
+        testcases_r.push_back( dir );
+    }
+  }
+} // namespace
+///////////////////////////////////////////////////////////////////
+
+int main ( int argc, char *argv[] )
+{
+  appname = Pathname::basename( argv[0] );
+  argparse::Options options;
+  options.add()
+    ( "help,h",		"Print help and exit." )
+    ( "runs,n",		"Resolve each testcase RUNS times (default 10).", argparse::Option::Arg::required )
+    ( "warm",		"Reuse the resolver across the runs (warm start) instead of starting cold." )
+    ( "baseline,b",	"Compare the results against the baseline file BASELINE.", argparse::Option::Arg::required )
+    ( "save,s",		"Save the results as baseline file SAVE.", argparse::Option::Arg::required )
+    ( "threshold,t",	"Regression threshold in percent (default 10).", argparse::Option::Arg::required );
+
+  auto result = options.parse( argc, argv );
+
+  if ( result.count( "help" ) || result.positionals().empty() )
+    return usage( options, 1 );
+
+  unsigned runs = result.count( "runs" ) ? str::strtonum<unsigned>( result["runs"].arg() ) : 10;
+  if ( ! runs )
+    return errexit( "RUNS must be a positive number", 1 );
+  double threshold = result.count( "threshold" ) ? std::strtod( result["threshold"].arg().c_str(), nullptr ) : 10.0;
+  bool warm = result.count( "warm" );
+
+  std::vector<Pathname> testcases;
+  for ( const std::string & arg : result.positionals() )
+  {
+    if ( ! PathInfo( arg ).isDir() )
+      return errexit( "Invalid or non existing testcase path: " + arg, 1 );
+    Pathname path { Pathname( arg ).realpath() };	// the child processes chdir into the testcase
+    collectTestcases( path, testcases );
+  }
+  if ( testcases.empty() )
+    return errexit( "No testcases found", 1 );
+
+  Baseline baseline;
+  if ( result.count( "baseline" ) )
+    baseline = readBaseline( result["baseline"].arg() );
+
+  cout << str::form( "%-32s %5s %4s %9s %9s %9s %9s %9s %9s %9s %8s",
+                     "testcase", "runs", "prob", "load", "min", "p50", "p90", "p99", "max", "solve50", "maxrss" ) << endl;
+
+  int ret = 0;
+  std::vector<std::pair<std::string,Stats>> results;
+  for ( const Pathname & testcase : testcases )
+  {
+    std::string name { testcase.basename() };
+    Stats stats;
+    if ( ! benchInChild( testcase, runs, warm, stats ) )
+    {
+      cout << str::form( "%-32s FAILED", name.c_str() ) << endl;
+      ret = 1;
+      continue;
+    }
+    cout << str::form( "%-32s %5u %4u %9s %9s %9s %9s %9s %9s %9s %8s",
+                       name.c_str(), stats.runs, stats.problems, ms( stats.load ).c_str(),
+                       ms( stats.min ).c_str(), ms( stats.p50 ).c_str(), ms( stats.p90 ).c_str(),
+                       ms( stats.p99 ).c_str(), ms( stats.max ).c_str(), ms( stats.solve50 ).c_str(),
+                       mib( stats.maxrss ).c_str() ) << endl;
+
+    auto base { baseline.find( name ) };
+    if ( base != baseline.end() )
+    {
+      const Stats & bstats { base->second };
+      bool regression = ( bstats.p50    && stats.p50    > bstats.p50    * ( 1.0 + threshold / 100.0 ) )
+                     || ( bstats.maxrss && stats.maxrss > bstats.maxrss * ( 1.0 + threshold / 100.0 ) );
+      cout << str::form( "%-32s %5s %4s %9s %9s %9s %9s %9s %9s %9s %8s%s",
+                         "  vs. baseline", "", "", "", "", delta( stats.p50, bstats.p50 ).c_str(),
+                         delta( stats.p90, bstats.p90 ).c_str(), "", "", "", delta( stats.maxrss, bstats.maxrss ).c_str(),
+                         regression ? "  REGRESSION" : "" ) << endl;
+      if ( regression && ! ret )
+        ret = 2;
+    }
+    results.push_back( std::make_pair( name, stats ) );
+  }
+
+  if ( result.count( "save" ) && ! writeBaseline( result["save"].arg(), results ) )
+    return errexit( "Failed to write baseline " + result["save"].arg() );
+
+  return ret;
+}
@@ -16,6 +16,9 @@ extern "C"
 
 #include <iostream>
 #include <fstream>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
 
 #include <zypp/base/Easy.h>
 #include <zypp/base/LogTools.h>
@@ -25,6 +28,8 @@ extern "C"
 #include <zypp/DiskUsageCounter.h>
 #include <zypp/ExternalProgram.h>
 #include <zypp/sat/Pool.h>
+#include <zypp/sat/WhatObsoletes.h>
+#include <zypp/Package.h>
 #include <zypp/sat/detail/PoolImpl.h>
 
 using std::endl;
@@ -37,6 +42,18 @@ namespace zypp
   namespace
   { /////////////////////////////////////////////////////////////////
 
+    /** Used size of \a mp_r after adding \a kbytes_r in \a files_r. */
+    inline long long pkgSize( const DiskUsageCounter::MountPoint & mp_r, long long kbytes_r, long long files_r )
+    {
+      // Limit estimated waste (half block per file) as it does not apply to
+      // btrfs, which reports up to 64K blocksize (bsc#974275,bsc#965322)
+      static const ByteCount blockAdjust( 2, ByteCount::K ); // (files * blocksize) / 2 / 1K; result value in K!
+
+      return mp_r.used_size          // current usage
+           + kbytes_r                // package data size
+           + ( files_r * ( mp_r.fstype == "btrfs" ? 4096 : mp_r.block_size ) / blockAdjust ); // half block per file
+    }
+
     DiskUsageCounter::MountPointSet calcDiskUsage( DiskUsageCounter::MountPointSet result, const Bitmap & installedmap_r )
     {
       if ( result.empty() )
@@ -71,13 +88,7 @@ namespace zypp
         unsigned idx = 0;
         for_( it, result.begin(), result.end() )
         {
-          // Limit estimated waste (half block per file) as it does not apply to
-          // btrfs, which reports up to 64K blocksize (bsc#974275,bsc#965322)
-          static const ByteCount blockAdjust( 2, ByteCount::K ); // (files * blocksize) / 2 / 1K; result value in K!
-
-          it->pkg_size = it->used_size          // current usage
-                       + duchanges[idx].kbytes  // package data size
-                       + ( duchanges[idx].files * ( it->fstype == "btrfs" ? 4096 : it->block_size ) / blockAdjust ); // half block per file
+          it->pkg_size = pkgSize( *it, duchanges[idx].kbytes, duchanges[idx].files );
           ++idx;
         }
       }
@@ -85,12 +96,246 @@ namespace zypp
       return result;
     }
 
+    ///////////////////////////////////////////////////////////////////
+    /// \class DiskUsageCache
+    /// \brief Data for the incremental \ref DiskUsageCounter::disk_usage(const ResPool &)
+    ///
+    /// Remembers the per-mountpoint changes caused by each solvable and the
+    /// mountpoint each disk usage directory maps to. The running totals are
+    /// updated just for items whose transact status changed.
+    ///
+    /// Like libsolv, deleting an installed package does not free space on a
+    /// \c growonly mountpoint (kept in a snapshot).
+    ///
+    /// There is one cache, computed for the mountpoints used last (\see \ref instance).
+    ///////////////////////////////////////////////////////////////////
+    class DiskUsageCache : private base::NonCopyable
+    {
+    public:
+      using MountPoint = DiskUsageCounter::MountPoint;
+      using MountPointSet = DiskUsageCounter::MountPointSet;
+
+      /** The cache for \a mps_r (reset if it was used for different mountpoints).
+       * The caller must hold the \ref mutex.
+       */
+      static DiskUsageCache & instance( const MountPointSet & mps_r )
+      {
+        static std::unique_ptr<DiskUsageCache> _instance;
+        if ( ! _instance || ! _instance->computedFor( mps_r ) )
+          _instance.reset( new DiskUsageCache( mps_r ) );
+        return *_instance;
+      }
+
+      /** Serializes the access to \ref instance. */
+      static std::mutex & mutex()
+      {
+        static std::mutex _mutex;
+        return _mutex;
+      }
+
+    public:
+      DiskUsageCache( const MountPointSet & mps_r )
+      : _kbytes( mps_r.size(), 0LL )
+      , _files( mps_r.size(), 0LL )
+      {
+        for ( const MountPoint & mp : mps_r )
+        {
+          // Compare like libsolv does: no leading but a trailing '/'
+          _dirs.push_back( normalized( mp.dir ) );
+          _growonly.push_back( mp.growonly );
+        }
+      }
+
+      /** Whether the cache was set up for \a mps_r. */
+      bool computedFor( const MountPointSet & mps_r ) const
+      {
+        if ( mps_r.size() != _dirs.size() )
+          return false;
+        unsigned idx = 0;
+        for ( const MountPoint & mp : mps_r )
+        {
+          if ( normalized( mp.dir ) != _dirs[idx] || mp.growonly != _growonly[idx] )
+            return false;
+          ++idx;
+        }
+        return true;
+      }
+
+      /** Update the totals for the transaction in \a pool_r.
+       * Returns \c false if the totals are not exact, because a package
+       * without disk usage data is going to replace an installed one. Libsolv
+       * then ignores the data of all installed packages it replaces, which is
+       * better left to \c pool_calc_duchanges.
+       */
+      bool update( const ResPool & pool_r )
+      {
+        if ( _watcher.remember( pool_r.serial() ) )
+          clear();
+
+        for ( const PoolItem & pi : pool_r )
+        {
+          bool transacts = pi.status().transacts();
+          sat::detail::SolvableIdType id = pi.id();
+          if ( transacts == _transacting.test( id ) )
+            continue;	// unchanged
+
+          bool installed = pi.status().isInstalled();
+          const Delta & delta { lookup( pi.satSolvable() ) };
+          long long sign = ( transacts == installed ? -1LL : 1LL );
+          for ( unsigned idx = 0; idx < _dirs.size(); ++idx )
+          {
+            if ( installed && _growonly[idx] )
+              continue;
+            _kbytes[idx] += sign * delta.kbytes[idx];
+            _files[idx]  += sign * delta.files[idx];
+          }
+          if ( ! installed && ! delta.hasdu && replacesInstalled( pi ) )
+            _withoutDu += ( transacts ? 1 : -1 );
+
+          if ( transacts )
+            _transacting.set( id );
+          else
+            _transacting.clear( id );
+        }
+        return _withoutDu == 0;
+      }
+
+      /** KiB added to mountpoint \a idx_r. */
+      long long kbytes( unsigned idx_r ) const
+      { return _kbytes[idx_r]; }
+
+      /** Files added to mountpoint \a idx_r. */
+      long long files( unsigned idx_r ) const
+      { return _files[idx_r]; }
+
+    private:
+      /** The disk usage data of a solvable per mountpoint. */
+      struct Delta
+      {
+        std::vector<long long> kbytes;
+        std::vector<long long> files;
+        bool hasdu = false;	///< whether the solvable provides disk usage data at all
+      };
+
+      /** Whether the package \a pi_r obsoletes (or updates) an installed package. */
+      static bool replacesInstalled( const PoolItem & pi_r )
+      { return pi_r.isKind<Package>() && ! sat::WhatObsoletes( pi_r ).empty(); }
+
+      static std::string normalized( std::string dir_r )
+      {
+        std::string::size_type pos = dir_r.find_first_not_of( '/' );
+        dir_r.erase( 0, pos == std::string::npos ? dir_r.size() : pos );
+        if ( ! dir_r.empty() && *dir_r.rbegin() != '/' )
+          dir_r += '/';
+        return dir_r;
+      }
+
+      void clear()
+      {
+        _transacting = Bitmap( Bitmap::poolSize );
+        _deltas.clear();
+        _dirmap.clear();
+        _kbytes.assign( _kbytes.size(), 0LL );
+        _files.assign( _files.size(), 0LL );
+        _withoutDu = 0;
+      }
+
+      /** The (cached) \ref Delta of \a solv_r. */
+      const Delta & lookup( sat::Solvable solv_r )
+      {
+        auto it = _deltas.find( solv_r.id() );
+        if ( it != _deltas.end() )
+          return it->second;
+
+        Delta & delta { _deltas[solv_r.id()] };
+        delta.kbytes.resize( _dirs.size(), 0LL );
+        delta.files.resize( _dirs.size(), 0LL );
+        _current = &delta;
+        ::repo_search( solv_r.repository().get(), solv_r.id(), SOLVABLE_DISKUSAGE, 0, 0, &DiskUsageCache::fillDeltaCB, this );
+        _current = nullptr;
+        return delta;
+      }
+
+      static int fillDeltaCB( void * cbdata_r, ::Solvable *, ::Repodata * data_r, ::Repokey *, ::KeyValue * kv_r )
+      {
+        DiskUsageCache & self { *static_cast<DiskUsageCache*>( cbdata_r ) };
+        Delta & delta { *self._current };
+        delta.hasdu = true;
+        int idx = self.mountPointOf( data_r, kv_r->id );
+        if ( idx >= 0 )
+        {
+          delta.kbytes[idx] += kv_r->num;
+          delta.files[idx]  += kv_r->num2;
+        }
+        return 0;
+      }
+
+      /** Index of the mountpoint \a dirid_r belongs to (or \c -1). Computed once per directory. */
+      int mountPointOf( ::Repodata * data_r, sat::detail::IdType dirid_r )
+      {
+        std::unordered_map<sat::detail::IdType,int> & dirmap { _dirmap[data_r] };
+        auto it = dirmap.find( dirid_r );
+        if ( it != dirmap.end() )
+          return it->second;
+
+        const char * dir = ::repodata_dir2str( data_r, dirid_r, 0 );
+        std::string path { normalized( dir ? dir : "" ) };
+        if ( path.empty() || *path.rbegin() != '/' )
+          path += '/';
+
+        int ret = -1;	// the longest matching mountpoint
+        for ( unsigned idx = 0; idx < _dirs.size(); ++idx )
+        {
+          if ( ( ret < 0 || _dirs[idx].size() > _dirs[ret].size() ) && str::startsWith( path, _dirs[idx] ) )
+            ret = idx;
+        }
+        return dirmap[dirid_r] = ret;
+      }
+
+    private:
+      std::vector<std::string> _dirs;	///< normalized mountpoint dirs
+      std::vector<bool> _growonly;
+      std::vector<long long> _kbytes;	///< totals per mountpoint
+      std::vector<long long> _files;	///< totals per mountpoint
+      int _withoutDu = 0;			///< transacting packages to install without disk usage data
+
+      SerialNumberWatcher _watcher;	///< pool content the data were computed for
+      Bitmap _transacting;		///< items included in the totals
+      std::unordered_map<sat::detail::SolvableIdType,Delta> _deltas;
+      std::unordered_map<const ::Repodata *,std::unordered_map<sat::detail::IdType,int>> _dirmap;
+      Delta * _current = nullptr;		///< Delta filled by \ref fillDeltaCB
+    };
+    ///////////////////////////////////////////////////////////////////
+
     /////////////////////////////////////////////////////////////////
   } // namespace
   ///////////////////////////////////////////////////////////////////
 
   DiskUsageCounter::MountPointSet DiskUsageCounter::disk_usage( const ResPool & pool_r ) const
   {
+    if ( _mps.empty() )
+    {
+      // partitioning is not set
+      return _mps;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock( DiskUsageCache::mutex() );
+      DiskUsageCache & cache( DiskUsageCache::instance( _mps ) );
+      if ( cache.update( pool_r ) )
+      {
+        MountPointSet result { _mps };
+        unsigned idx = 0;
+        for ( const MountPoint & mp : result )
+        {
+          mp.pkg_size = pkgSize( mp, cache.kbytes( idx ), cache.files( idx ) );
+          ++idx;
+        }
+        return result;
+      }
+    }
+
+    // not exact: let libsolv compute it from scratch
     Bitmap bitmap( Bitmap::poolSize );
 
     // build installedmap (installed != transact)
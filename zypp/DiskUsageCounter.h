@@ -180,7 +180,14 @@ namespace zypp
     static MountPointSet justRootPartition();
 
 
-    /** Compute disk usage if the current transaction woud be commited. */
+    /** Compute disk usage if the current transaction woud be commited.
+     *
+     * The computation is incremental: The per-mountpoint changes caused by
+     * each transacting item are remembered, so a subsequent call only needs
+     * to look up the disk usage data of items whose transact status changed
+     * since the last call. Changes of the pool content (repos added or
+     * removed) or of the mountpoints start over from scratch.
+     */
     MountPointSet disk_usage( const ResPool & pool ) const;
 
     /** Compute disk usage of a single Solvable */
@@ -16,6 +16,7 @@ extern "C"
 #include <zypp/base/String.h>
 
 #include <zypp/Edition.h>
+#include <zypp/sat/EvrKeyCache.h>
 #include <zypp/sat/detail/PoolImpl.h>
 
 ///////////////////////////////////////////////////////////////////
@@ -124,6 +125,15 @@ namespace zypp
     return( lhs ? 1 : -1 );
   }
 
+  int Edition::_doCompareIdStr( const IdString & lhs, const IdString & rhs )
+  {
+    // Editions in the pool are compared over and over again (e.g. when sorting
+    // candidates). Use the cached keys rather than re-parsing both strings.
+    if ( lhs && rhs && myPool().getPool()->disttype == DISTTYPE_RPM )
+      return sat::EvrKeyCache::instance().compare( lhs, rhs );
+    return _doCompare( (lhs ? lhs.c_str() : (const char *)0 ), (rhs ? rhs.c_str() : (const char *)0 ) );
+  }
+
   int Edition::_doMatch( const char * lhs,  const char * rhs )
   {
     if ( lhs == rhs ) return 0;
@@ -170,6 +170,7 @@ namespace zypp
 
     private:
       static int _doCompare( const char * lhs,  const char * rhs ) ZYPP_API;
+      static int _doCompareIdStr( const IdString & lhs, const IdString & rhs ) ZYPP_API;
       static int _doMatch( const char * lhs,  const char * rhs );
 
     private:
@@ -137,8 +137,7 @@ namespace zypp
       static int compare( const Derived & lhs,     const char * rhs )        { return compare( lhs.idStr(), rhs );}
 
       static int compare( const IdString & lhs,    const Derived & rhs )     { return compare( lhs, rhs.idStr() ); }
-      static int compare( const IdString & lhs,    const IdString & rhs )    { return lhs == rhs ? 0 : Derived::_doCompare( (lhs ? lhs.c_str() : (const char *)0 ),
-                                                                                                                            (rhs ? rhs.c_str() : (const char *)0 ) ); }
+      static int compare( const IdString & lhs,    const IdString & rhs )    { return lhs == rhs ? 0 : Derived::_doCompareIdStr( lhs, rhs ); }
       static int compare( const IdString & lhs,    const std::string & rhs ) { return compare( lhs, rhs.c_str() ); }
       static int compare( const IdString & lhs,    const char * rhs )        { return Derived::_doCompare( (lhs ? lhs.c_str() : (const char *)0 ), rhs ); }
 
@@ -165,6 +164,10 @@ namespace zypp
         if ( ! lhs ) return rhs ? -1 : 0;
         return rhs ? ::strcmp( lhs, rhs ) : 1;
       }
+
+      /** Compare two distinct \ref IdString. Derived may redefine it to use the ids (e.g. a cache). */
+      static inline int _doCompareIdStr( const IdString & lhs, const IdString & rhs )
+      { return Derived::_doCompare( (lhs ? lhs.c_str() : (const char *)0 ), (rhs ? rhs.c_str() : (const char *)0 ) ); }
   };
   ///////////////////////////////////////////////////////////////////
 
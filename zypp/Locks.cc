@@ -17,6 +17,7 @@
 #include <zypp/base/IOStream.h>
 #include <zypp/base/Iterator.h>
 #include <zypp/PoolItem.h>
+#include <zypp/pool/HardLockMatcher.h>
 #include <zypp/PoolQueryUtil.tcc>
 #include <zypp/ZYppCallbacks.h>
 #include <zypp/sat/SolvAttr.h>
@@ -172,8 +173,12 @@ void Locks::read( const Pathname& file )
 
 void Locks::apply() const
 {
-  DBG << "apply locks" << endl;
-  for_each(_pimpl->locks().begin(), _pimpl->locks().end(), ApplyLock());
+  pool::HardLockMatcher matcher( _pimpl->locks().begin(), _pimpl->locks().end() );
+  DBG << "apply locks " << matcher << endl;
+  for ( sat::Solvable slv : matcher.matchAll() )
+  {
+    PoolItem(slv).status().setLock(true,ResStatus::USER);
+  }
 }
 
 
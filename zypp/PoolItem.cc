@@ -12,7 +12,12 @@
 #include <iostream>
 #include <zypp/base/Logger.h>
 #include <utility>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <boost/make_shared.hpp>
 #include <zypp-core/base/DefaultIntegral>
+#include <zypp/base/NonCopyable.h>
 
 #include <zypp/PoolItem.h>
 #include <zypp/ResPool.h>
@@ -25,6 +30,112 @@ using std::endl;
 namespace zypp
 { /////////////////////////////////////////////////////////////////
 
+  namespace
+  {
+    ///////////////////////////////////////////////////////////////////
+    /// \class SlabArena
+    /// \brief Fixed size block storage used by \ref SlabAllocator.
+    ///
+    /// Blocks are carved from slabs of \c _slabBlocks blocks each. Released
+    /// blocks are kept in a free list for reuse, slabs are never returned.
+    /// There is one arena per block size and alignment. It lives as long as
+    /// the program does (intentional leak), as PoolItems may outlive the
+    /// static destructors.
+    ///////////////////////////////////////////////////////////////////
+    template <size_t TSize, size_t TAlign>
+    class SlabArena : private base::NonCopyable
+    {
+      union Block
+      {
+        Block * _next;
+        alignas(TAlign) unsigned char _data[TSize];
+      };
+      static constexpr size_t _slabBlocks = 4096;
+
+    public:
+      static SlabArena & instance()
+      {
+        static SlabArena * _arena( new SlabArena );
+        return *_arena;
+      }
+
+      void * allocate()
+      {
+        std::lock_guard<std::mutex> guard( _mutex );
+        if ( ! _free )
+        {
+          _slabs.emplace_back( new Block[_slabBlocks] );
+          Block * slab = _slabs.back().get();
+          for ( size_t i = _slabBlocks; i--; )
+          {
+            slab[i]._next = _free;
+            _free = &slab[i];
+          }
+        }
+        Block * ret = _free;
+        _free = ret->_next;
+        return ret;
+      }
+
+      void deallocate( void * ptr_r )
+      {
+        std::lock_guard<std::mutex> guard( _mutex );
+        Block * block = static_cast<Block*>( ptr_r );
+        block->_next = _free;
+        _free = block;
+      }
+
+    private:
+      SlabArena() {}
+
+      std::mutex _mutex;
+      Block * _free = nullptr;
+      std::vector<std::unique_ptr<Block[]>> _slabs;
+    };
+
+    ///////////////////////////////////////////////////////////////////
+    /// \class SlabAllocator
+    /// \brief Stateless allocator for use with \c boost::allocate_shared.
+    ///
+    /// \c boost::allocate_shared rebinds it to the type combining the
+    /// shared_ptr control block and the object, so both end up in a
+    /// single \ref SlabArena block.
+    ///////////////////////////////////////////////////////////////////
+    template <class Tp>
+    struct SlabAllocator
+    {
+      typedef Tp value_type;
+
+      SlabAllocator() {}
+
+      template <class Up>
+      SlabAllocator( const SlabAllocator<Up> & ) {}
+
+      Tp * allocate( size_t n_r )
+      {
+        if ( n_r != 1 )
+          return static_cast<Tp*>( ::operator new( n_r * sizeof(Tp) ) );
+        return static_cast<Tp*>( SlabArena<sizeof(Tp),alignof(Tp)>::instance().allocate() );
+      }
+
+      void deallocate( Tp * ptr_r, size_t n_r )
+      {
+        if ( n_r != 1 )
+          ::operator delete( ptr_r );
+        else
+          SlabArena<sizeof(Tp),alignof(Tp)>::instance().deallocate( ptr_r );
+      }
+
+      template <class Up>
+      bool operator==( const SlabAllocator<Up> & ) const
+      { return true; }
+
+      template <class Up>
+      bool operator!=( const SlabAllocator<Up> & ) const
+      { return false; }
+    };
+  } // namespace
+
   ///////////////////////////////////////////////////////////////////
   //
   //	CLASS NAME : PoolItem::Impl
@@ -34,16 +145,19 @@ namespace zypp
    * \li \c ==0 no buddy
    * \li \c >0 this uses \c _buddy status
    * \li \c <0 this status used by \c -_buddy
+   *
+   * The \ref ResObject is created on demand, when it is actually
+   * requested. Most PoolItems in a pool are never asked for it.
    */
   struct PoolItem::Impl
   {
     public:
       Impl() {}
 
-      Impl( ResObject::constPtr &&res_r,
+      Impl( const sat::Solvable & solvable_r,
             ResStatus &&status_r )
       : _status( std::move(status_r) )
-      , _resolvable( std::move(res_r) )
+      , _solvable( solvable_r )
       {}
 
       ResStatus & status() const
@@ -60,8 +174,18 @@ namespace zypp
 
       void setBuddy( const sat::Solvable & solv_r );
 
+      sat::Solvable satSolvable() const
+      { return _solvable; }
+
       ResObject::constPtr resolvable() const
-      { return _resolvable; }
+      {
+        // NOTE: No ResObject for the default PoolItem.
+        std::call_once( _resolvableOnce, [this]() {
+          if ( _solvable )
+            _resolvable = makeResObject( _solvable );
+        } );
+        return _resolvable;
+      }
 
       ResStatus & statusReset() const
       {
@@ -110,7 +234,9 @@ namespace zypp
 
     private:
       mutable ResStatus     _status;
-      ResObject::constPtr   _resolvable;
+      sat::Solvable         _solvable;
+      mutable ResObject::constPtr _resolvable;	///< created on demand
+      mutable std::once_flag _resolvableOnce;
       DefaultIntegral<sat::detail::IdType,sat::detail::noId> _buddy;
 
     /** \name Poor man's save/restore state.
@@ -154,8 +280,8 @@ namespace zypp
   inline std::ostream & operator<<( std::ostream & str, const PoolItem::Impl & obj )
   {
     str << obj.status();
-    if (obj.resolvable())
-        str << *obj.resolvable();
+    if ( obj.satSolvable() )
+        str << obj.satSolvable();
     else
         str << "(NULL)";
     return str;
@@ -171,7 +297,7 @@ namespace zypp
         ERR <<  *this << " would be buddy2 in " << myBuddy << endl;
         return;
       }
-      myBuddy._pimpl->_buddy = -resolvable()->satSolvable().id();
+      myBuddy._pimpl->_buddy = -satSolvable().id();
       _buddy = myBuddy.satSolvable().id();
       DBG << *this << " has buddy " << myBuddy << endl;
     }
@@ -199,7 +325,9 @@ namespace zypp
 
   PoolItem PoolItem::makePoolItem( const sat::Solvable & solvable_r )
   {
-    return PoolItem( new Impl( makeResObject( solvable_r ), solvable_r.isSystem() ) );
+    PoolItem ret;
+    ret._pimpl = RW_pointer<Impl>( boost::allocate_shared<Impl>( SlabAllocator<Impl>(), solvable_r, ResStatus( solvable_r.isSystem() ) ) );
+    return ret;
   }
 
   PoolItem::~PoolItem()
@@ -225,6 +353,7 @@ namespace zypp
   void PoolItem::restoreState() const			{ _pimpl->restoreState(); }
   bool PoolItem::sameState() const			{ return _pimpl->sameState(); }
   ResObject::constPtr PoolItem::resolvable() const	{ return _pimpl->resolvable(); }
+  PoolItem::operator sat::Solvable() const		{ return _pimpl->satSolvable(); }
 
 
   std::ostream & operator<<( std::ostream & str, const PoolItem & obj )
@@ -118,8 +118,7 @@ namespace zypp
       ResPool pool() const;
 
       /** This is a \ref sat::SolvableType. */
-      explicit operator sat::Solvable() const
-      { return resolvable() ? resolvable()->satSolvable() : sat::Solvable::noSolvable; }
+      explicit operator sat::Solvable() const;
 
       /** Return the buddy we share our status object with.
        * A \ref Product e.g. may share its status with an associated reference \ref Package.
@@ -128,6 +127,8 @@ namespace zypp
 
     public:
       /** Returns the ResObject::constPtr.
+       * The \ref ResObject is created on demand. Prefer the \ref sat::SolvableType
+       * methods if you don't actually need it.
        * \see \ref operator->
        */
       ResObject::constPtr resolvable() const;
@@ -142,6 +143,10 @@ namespace zypp
       ResObject::constPtr operator->() const
       { return resolvable(); }
 
+      /** Whether both refer to the same item (i.e. share the same status). */
+      bool sameItem( const PoolItem & rhs ) const
+      { return _pimpl.get() == rhs._pimpl.get(); }
+
     private:
       friend class pool::PoolImpl;
       /** \ref PoolItem generator for \ref pool::PoolImpl. */
@@ -173,7 +178,7 @@ namespace zypp
 
   /** \relates PoolItem Required to disambiguate vs. (PoolItem,ResObject::constPtr) due to implicit PoolItem::operator ResObject::constPtr  */
   inline bool operator==( const PoolItem & lhs, const PoolItem & rhs )
-  { return lhs.resolvable() == rhs.resolvable(); }
+  { return lhs.sameItem( rhs ); }
 
   /** \relates PoolItem Convenience compare */
   inline bool operator==( const PoolItem & lhs, const ResObject::constPtr & rhs )
@@ -175,5 +175,18 @@ namespace zypp
     return os;
   }
 
+  std::ostream & operator<<( std::ostream & os, const ProblemSolutionEvaluation & obj )
+  {
+    os << "Evaluation[";
+    if ( ! obj.evaluated )
+      os << "not evaluated";
+    else
+      os << ( obj.solved ? "solved" : "problems" ) << " +" << obj.installs << " -" << obj.removes;
+    os << "] ";
+    if ( obj.solution )
+      os << obj.solution->description();
+    return os;
+  }
+
 } // namespace zypp
 /////////////////////////////////////////////////////////////////////////
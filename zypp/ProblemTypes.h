@@ -26,6 +26,7 @@
 #include <list>
 #include <set>
 #include <map>
+#include <vector>
 
 #include <zypp/base/ReferenceCounted.h>
 #include <zypp/base/NonCopyable.h>
@@ -45,6 +46,22 @@ namespace zypp
   DEFINE_PTR_TYPE(ResolverProblem);
   using ResolverProblemList = std::list<ResolverProblem_Ptr>;
 
+  /** Outcome of a speculative solver run with one \ref ProblemSolution applied.
+   * \see \ref Resolver::evaluateSolutions
+   */
+  struct ProblemSolutionEvaluation
+  {
+    ProblemSolution_Ptr solution;	///< The evaluated solution.
+    bool evaluated = false;		///< Whether the solution belongs to the last solver run and was evaluated.
+    bool solved = false;		///< Whether the solver run succeeded without problems.
+    unsigned installs = 0;		///< Number of items to be installed.
+    unsigned removes = 0;		///< Number of installed items to be removed.
+  };
+  using ProblemSolutionEvaluationList = std::vector<ProblemSolutionEvaluation>;
+
+  /** \relates ProblemSolutionEvaluation Stream output */
+  std::ostream & operator<<( std::ostream & str, const ProblemSolutionEvaluation & obj ) ZYPP_API;
+
 } // namespace zypp
 /////////////////////////////////////////////////////////////////////////
 #endif // ZYPP_SOLVER_DETAIL_TYPES_H
@@ -14,7 +14,10 @@
 #include <zypp/base/Logger.h>
 #include <zypp/base/Regex.h>
 #include <zypp/base/Iterator.h>
+#include <zypp/base/SerialNumber.h>
 #include <zypp/PurgeKernels.h>
+#include <zypp/sat/Pool.h>
+#include <zypp/sat/WhatProvides.h>
 #include <zypp/PoolQuery.h>
 #include <zypp/ResPool.h>
 #include <zypp/Resolver.h>
@@ -24,7 +27,6 @@
 #include <iostream>
 #include <fstream>
 #include <map>
-#include <unordered_map>
 #include <sys/utsname.h>
 #include <functional>
 #include <array>
@@ -54,18 +56,45 @@ namespace zypp {
     ArchToEditionMap archToEdMap;   //<< Map of actual packages
     std::string groupFlavour;       //<< This would contain a specific flavour if there is one calculated
   };
-  using GroupMap = std::unordered_map<std::string, GroupInfo>;
+  using GroupMap = std::map<std::string, GroupInfo>;
+
+  namespace {
+    /*!
+     * The running kernel does not change, so uname is asked just once per process.
+     */
+    struct RunningKernel {
+      bool        detected = false;
+      Arch        arch;
+      std::string unameR;
+    };
+
+    const RunningKernel & runningKernel()
+    {
+      static const RunningKernel ret = [](){
+        RunningKernel rk;
+        struct utsname unameData;
+        if ( uname( &unameData) == 0 ) {
+          const auto archStr = str::regex_substitute( unameData.machine, str::regex( "^i.86$", str::regex::match_extended ), "i586" );
+          rk.arch = Arch( archStr );
+          rk.unameR = unameData.release;
+          rk.detected = true;
+        } else {
+          MIL << "Failed to detect running kernel: " << errno << std::endl;
+        }
+        return rk;
+      }();
+      return ret;
+    }
+  }
 
   struct PurgeKernels::Impl  {
 
     Impl() {
-      struct utsname unameData;
-      if ( uname( &unameData) == 0 ) {
+      const RunningKernel & rk { runningKernel() };
+      if ( rk.detected ) {
 
-        const auto archStr = str::regex_substitute( unameData.machine, str::regex( "^i.86$", str::regex::match_extended ), "i586" );
-
-        _kernelArch = Arch( archStr );
-        setUnameR( std::string( unameData.release ) );
+        _kernelArch = rk.arch;
+        setUnameR( rk.unameR );
 
         _detectedRunning = true;
 
@@ -73,9 +102,6 @@ namespace zypp {
         for ( const auto &edVar : _runningKernelEditionVariants )
           MIL << "Edition variant: " << edVar << "\n";
         MIL << std::endl;
-
-      } else {
-        MIL << "Failed to detect running kernel: " << errno << std::endl;
       }
     }
 
@@ -118,7 +144,8 @@ namespace zypp {
     bool removePackageAndCheck( const sat::Solvable slv, const std::set<sat::Solvable> &keepList , const std::set<sat::Solvable> &removeList ) const;
     static bool versionMatch ( const Edition &a, const Edition &b );
     void parseKeepSpec();
-    void fillKeepList(const GroupMap &installedKernels, std::set<sat::Solvable> &keepList , std::set<sat::Solvable> &removeList ) const;
+    const GroupMap & installedGroups();
+    void evaluateGroup( const GroupMap::value_type &group, Plan::Group &result ) const;
 
     std::set<size_t>  _keepLatestOffsets = { 0 };
     std::set<size_t>  _keepOldestOffsets;
@@ -135,6 +162,9 @@ namespace zypp {
     std::string       _keepSpec = ZConfig::instance().multiversionKernels();
     bool              _keepRunning     = true;
     bool              _detectedRunning = false;
+
+    GroupMap            _groups;        //< the installed kernel packages grouped by flavour/ident
+    SerialNumberWatcher _groupsWatcher; //< pool content _groups was computed for
   };
 
   /*!
@@ -158,7 +188,7 @@ namespace zypp {
     MIL << "Request to remove package: " << pi << std::endl;
 
     //list of packages that are allowed to be removed automatically.
-    const str::regex validRemovals("(kernel-syms(-.*)?|kgraft-patch(-.*)?|kernel-(.*)-livepatch(-.*)?|kernel-livepatch(-.*)?|.*-kmp(-.*)?)");
+    static const str::regex validRemovals("(kernel-syms(-.*)?|kgraft-patch(-.*)?|kernel-(.*)-livepatch(-.*)?|kernel-livepatch(-.*)?|.*-kmp(-.*)?)");
 
     if ( pi.status().isLocked() ) {
       MIL << "Package " << pi << " is locked by the user, not removing." << std::endl;
@@ -218,8 +248,8 @@ namespace zypp {
        * redundant now.
        */
       bool mostLikelyKmod = false;
-      StrMatcher matchMod( "kmod(*)", Match::GLOB );
-      StrMatcher matchSym( "ksym(*)", Match::GLOB );
+      static const StrMatcher matchMod( "kmod(*)", Match::GLOB );
+      static const StrMatcher matchSym( "ksym(*)", Match::GLOB );
       for ( const auto &prov : p.provides() ) {
         if ( matchMod.doMatch( prov.detail().name().c_str()) || matchSym.doMatch( prov.detail().name().c_str() ) ) {
           mostLikelyKmod = true;
@@ -250,15 +280,12 @@ namespace zypp {
         continue;
 
       for ( const char * suffix : { "-debugsource", "-debuginfo" } ) {
-        PoolQuery q;
-        q.addKind( zypp::ResKind::package );
-        q.addDependency( sat::SolvAttr::provides, Capability( solvable.name()+suffix, Rel::EQ, solvable.edition() ) );
-        q.setInstalledOnly();
-        q.setMatchExact();
-
-        for ( sat::Solvable debugPackage : q ) {
+        // the whatprovides index is prepared by the resolver run above
+        for ( sat::Solvable debugPackage : sat::WhatProvides( Capability( solvable.name()+suffix, Rel::EQ, solvable.edition() ) ) ) {
 
-          if ( debugPackage.arch() != solvable.arch() )
+          if ( ! debugPackage.isSystem()
+               || ! debugPackage.isKind( ResKind::package )
+               || debugPackage.arch() != solvable.arch() )
             continue;
 
           MIL << "Found debug package for " << solvable << " : " << debugPackage << std::endl;
@@ -281,7 +308,7 @@ namespace zypp {
       return true;
 
     // the build counter should not be considered here, so if there is one we cut it off
-    const str::regex buildCntRegex( "\\.[0-9]+($|\\.g[0-9a-f]{7}$)", str::regex::match_extended );
+    static const str::regex buildCntRegex( "\\.[0-9]+($|\\.g[0-9a-f]{7}$)", str::regex::match_extended );
 
     std::string versionStr = b.asString();
     str::smatch matches;
@@ -318,6 +345,7 @@ namespace zypp {
     _keepRunning = false;
     _keepLatestOffsets.clear();
     _keepOldestOffsets.clear();
+    _keepSpecificEditions.clear();
 
     for ( const std::string &word : words ) {
       if ( word == "running" ) {
@@ -377,8 +405,15 @@ namespace zypp {
    * doable. This is also what the perl script did.
    *
    */
-  void PurgeKernels::Impl::fillKeepList( const GroupMap &installedKernels, std::set<sat::Solvable> &keepList, std::set<sat::Solvable> &removeList ) const
+  void PurgeKernels::Impl::evaluateGroup( const GroupMap::value_type &groupInfo, Plan::Group &result ) const
   {
+    // in the first step all packages of the group are to be removed, then we remove the packages we want to explicitly keep
+    std::set<sat::Solvable> keepList;
+    std::set<sat::Solvable> removeList;
+    for ( const auto &archMap : groupInfo.second.archToEdMap ) {
+      for ( const auto &kernelMap : archMap.second )
+        removeList.insert( kernelMap.second.begin(), kernelMap.second.end() );
+    }
 
     const auto markAsKeep = [ &keepList, &removeList ]( sat::Solvable pck ) {
       MIL << "Marking package " << pck << " as to keep." << std::endl;
@@ -393,129 +428,109 @@ namespace zypp {
       };
     };
 
-    for ( const auto &groupInfo : installedKernels ) {
-
-      MIL << "Starting with group " << groupInfo.first << std::endl;
-
-      for ( const auto &archMap : groupInfo.second.archToEdMap ) {
-
-        MIL << "Starting with arch " << archMap.first << std::endl;
+    MIL << "Starting with group " << groupInfo.first << std::endl;
 
-        size_t currOff = 0; //the current "oldest" offset ( runs from map start to end )
-        size_t currROff = archMap.second.size() - 1; // the current "latest" offset ( runs from map end to start )
+    for ( const auto &archMap : groupInfo.second.archToEdMap ) {
 
+      MIL << "Starting with arch " << archMap.first << std::endl;
 
-        const EditionToSolvableMap &map = archMap.second;
+      size_t currOff = 0; //the current "oldest" offset ( runs from map start to end )
+      size_t currROff = archMap.second.size() - 1; // the current "latest" offset ( runs from map end to start )
 
-        if ( _keepRunning
-             && ( ( archMap.first == _kernelArch && groupInfo.second.groupFlavour == _runningKernelFlavour )
-                  || groupInfo.second.groupType == GroupInfo::Sources ) ) {
 
-          MIL << "Matching packages against running kernel "<< _runningKernelFlavour << "-" <<_kernelArch << "\nVariants:\n";
-          for ( const auto &var : _runningKernelEditionVariants )
-            MIL << var << "\n";
-          MIL << std::endl;
+      const EditionToSolvableMap &map = archMap.second;
 
-          const auto &editionPredicate = versionPredicate( _runningKernelEditionVariants );
-          auto it = std::find_if( map.begin(), map.end(), editionPredicate );
-          if ( it == map.end() ) {
+      if ( _keepRunning
+           && ( ( archMap.first == _kernelArch && groupInfo.second.groupFlavour == _runningKernelFlavour )
+                || groupInfo.second.groupType == GroupInfo::Sources ) ) {
 
-            // If we look at Sources we cannot match the flavour but we still want to keep on checking the rest of the keep spec
-            if ( groupInfo.second.groupType != GroupInfo::Sources  ) {
-              MIL << "Running kernel " << _runningKernelFlavour << "-" <<_kernelArch << "\n";
-              for ( const auto &var : _runningKernelEditionVariants )
-                MIL << " Possible Variant:" << var << "\n";
-              MIL << "Not installed! \n";
-              MIL << "NOT removing any packages for flavor "<<_runningKernelFlavour<<"-"<<_kernelArch<<" ."<<std::endl;
-
-              for ( const auto &kernelMap : map ) {
-                for( sat::Solvable pck : kernelMap.second )
-                  markAsKeep(pck);
-              }
-              continue;
-            }
+        MIL << "Matching packages against running kernel "<< _runningKernelFlavour << "-" <<_kernelArch << "\nVariants:\n";
+        for ( const auto &var : _runningKernelEditionVariants )
+          MIL << var << "\n";
+        MIL << std::endl;
 
-          } else {
-            // there could be multiple matches here because of rebuild counter, lets try to find the last one
-            MIL << "Found possible running candidate edition: " << it->first << std::endl;
-            auto nit = it;
-            for ( nit++ ; nit != map.end() && editionPredicate( *nit ) ; nit++ ) {
-              MIL << "Found possible more recent running candidate edition: " << nit->first << std::endl;
-              it = nit;
+        const auto &editionPredicate = versionPredicate( _runningKernelEditionVariants );
+        auto it = std::find_if( map.begin(), map.end(), editionPredicate );
+        if ( it == map.end() ) {
+
+          // If we look at Sources we cannot match the flavour but we still want to keep on checking the rest of the keep spec
+          if ( groupInfo.second.groupType != GroupInfo::Sources  ) {
+            MIL << "Running kernel " << _runningKernelFlavour << "-" <<_kernelArch << "\n";
+            for ( const auto &var : _runningKernelEditionVariants )
+              MIL << " Possible Variant:" << var << "\n";
+            MIL << "Not installed! \n";
+            MIL << "NOT removing any packages for flavor "<<_runningKernelFlavour<<"-"<<_kernelArch<<" ."<<std::endl;
+
+            for ( const auto &kernelMap : map ) {
+              for( sat::Solvable pck : kernelMap.second )
+                markAsKeep(pck);
             }
+            continue;
           }
 
-          // mark all packages of the running version as keep
-          if ( it != map.end() ) {
-            for( sat::Solvable pck : it->second ) {
-              markAsKeep(pck);
-            }
+        } else {
+          // there could be multiple matches here because of rebuild counter, lets try to find the last one
+          MIL << "Found possible running candidate edition: " << it->first << std::endl;
+          auto nit = it;
+          for ( nit++ ; nit != map.end() && editionPredicate( *nit ) ; nit++ ) {
+            MIL << "Found possible more recent running candidate edition: " << nit->first << std::endl;
+            it = nit;
           }
         }
 
-        for ( const auto &kernelMap : map ) {
-          //if we find one of the running offsets in the keepspec, we add the kernel id the the list of packages to keep
-          if (  _keepOldestOffsets.find( currOff ) != _keepOldestOffsets.end() || _keepLatestOffsets.find( currROff ) != _keepLatestOffsets.end() ) {
-            std::for_each( kernelMap.second.begin(), kernelMap.second.end(), markAsKeep );
+        // mark all packages of the running version as keep
+        if ( it != map.end() ) {
+          for( sat::Solvable pck : it->second ) {
+            markAsKeep(pck);
           }
-          currOff++;
-          currROff--;
-
-          // a kernel package might be explicitly locked by version
-          // We need to go over all package name provides ( provides is named like the package ) and match
-          // them against the specified version to know which ones to keep. (bsc#1176740  bsc#1176192)
-          std::for_each( kernelMap.second.begin(), kernelMap.second.end(), [ & ]( sat::Solvable solv ){
-            for ( Capability prov : solv.provides() ) {
-              if ( prov.detail().name() == solv.name() && _keepSpecificEditions.count( prov.detail().ed() ) ) {
-                markAsKeep( solv );
-                break;
-              }
-            }
-          });
         }
       }
-    }
-  }
 
-  PurgeKernels::PurgeKernels()
-    : _pimpl( new Impl() )
-  {
+      for ( const auto &kernelMap : map ) {
+        //if we find one of the running offsets in the keepspec, we add the kernel id the the list of packages to keep
+        if (  _keepOldestOffsets.find( currOff ) != _keepOldestOffsets.end() || _keepLatestOffsets.find( currROff ) != _keepLatestOffsets.end() ) {
+          std::for_each( kernelMap.second.begin(), kernelMap.second.end(), markAsKeep );
+        }
+        currOff++;
+        currROff--;
+
+        // a kernel package might be explicitly locked by version
+        // We need to go over all package name provides ( provides is named like the package ) and match
+        // them against the specified version to know which ones to keep. (bsc#1176740  bsc#1176192)
+        std::for_each( kernelMap.second.begin(), kernelMap.second.end(), [ & ]( sat::Solvable solv ){
+          for ( Capability prov : solv.provides() ) {
+            if ( prov.detail().name() == solv.name() && _keepSpecificEditions.count( prov.detail().ed() ) ) {
+              markAsKeep( solv );
+              break;
+            }
+          }
+        });
+      }
+    }
 
+    result.ident = groupInfo.first;
+    result.keep.assign( keepList.begin(), keepList.end() );
+    result.remove.assign( removeList.begin(), removeList.end() );
   }
 
-  void PurgeKernels::markObsoleteKernels()
+  /*!
+   * Collect all installed multiversion kernel packages, grouped by Flavour -> Arch -> Version -> (List of all packages in that category).
+   * Devel and source packages are grouped together. The result is remembered until the pools content changes.
+   */
+  const GroupMap & PurgeKernels::Impl::installedGroups()
   {
-    MIL << std::endl << "--------------------- Starting to mark obsolete kernels ---------------------"<<std::endl;
-
-    if ( _pimpl->_keepSpec.empty() ) {
-      WAR << "Keep spec is empty, removing nothing." << std::endl;
-      return;
-    }
-
-    _pimpl->parseKeepSpec();
-
-    if ( _pimpl->_keepRunning && !_pimpl->_detectedRunning ) {
-      WAR << "Unable to detect running kernel, but keeping the running kernel was requested. Not removing any packages." << std::endl;
-      return;
-    }
-
-    auto pool = ResPool::instance();
-    pool.resolver().setForceResolve( true ); // set allow uninstall flag
+    if ( ! _groupsWatcher.remember( sat::Pool::instance().serial() ) )
+      return _groups;
 
-    const filter::ByStatus toBeUninstalledFilter( &ResStatus::isToBeUninstalled );
+    _groups.clear();
+    GroupMap & installedKrnlPackages { _groups };
 
     // kernel flavour regex
-    const str::regex kernelFlavourRegex("^kernel-(.*)$");
-
-    // the map of all installed kernel packages, grouped by Flavour -> Arch -> Version -> (List of all packages in that category)
-    // devel and source packages are grouped together
-    GroupMap installedKrnlPackages;
-
-
-    // packages that we plan to remove
-    std::set<sat::Solvable> packagesToRemove;
+    static const str::regex kernelFlavourRegex("^kernel-(.*)$");
+    // if adapting the groups do not forget to explicitly handle the group when querying the matches
+    static const str::regex explicitlyHandled("kernel-syms(-.*)?|kernel(-.*)?-devel");
 
-    const auto addPackageToMap = [&installedKrnlPackages, &packagesToRemove] ( const GroupInfo::GroupType type, const std::string &ident, const std::string &flavour, const sat::Solvable &installedKrnlPck ) {
+    const auto addPackageToMap = [&installedKrnlPackages] ( const GroupInfo::GroupType type, const std::string &ident, const std::string &flavour, const sat::Solvable &installedKrnlPck ) {
 
       if ( !installedKrnlPackages.count( ident ) )
         installedKrnlPackages.insert( std::make_pair( ident, GroupInfo(type, flavour) ) );
@@ -560,14 +575,8 @@ namespace zypp {
         editionToSolvableMap.insert( std::make_pair( edToUse, SolvableList{} ) );
 
       editionToSolvableMap[edToUse].push_back( installedKrnlPck );
-
-      //in the first step we collect all packages in this list, then later we will remove the packages we want to explicitly keep
-      packagesToRemove.insert( installedKrnlPck );
     };
 
-    // the set of satSolvables that have to be kept always
-    std::set<sat::Solvable> packagesToKeep;
-
     //collect the list of installed kernel packages
     PoolQuery q;
     q.addKind( zypp::ResKind::package );
@@ -605,9 +614,6 @@ namespace zypp {
 
       } else {
 
-        // if adapting the groups do not forget to explicitly handle the group when querying the matches
-        const str::regex explicitlyHandled("kernel-syms(-.*)?|kernel(-.*)?-devel");
-
         MIL << "Not a kernel package, inspecting more closely " << std::endl;
 
         // we directly handle all noarch packages that export multiversion(kernel)
@@ -658,7 +664,72 @@ namespace zypp {
       });
     });
 
-    _pimpl->fillKeepList( installedKrnlPackages, packagesToKeep, packagesToRemove );
+    return _groups;
+  }
+
+  bool PurgeKernels::Plan::empty() const
+  {
+    return std::all_of( groups.begin(), groups.end(), []( const Group & group_r ) { return group_r.remove.empty(); } );
+  }
+
+  PurgeKernels::PurgeKernels()
+    : _pimpl( new Impl() )
+  {
+
+  }
+
+  PurgeKernels::Plan PurgeKernels::computePlan( const PlanCallback & cb_r )
+  {
+    Plan ret;
+
+    if ( _pimpl->_keepSpec.empty() ) {
+      WAR << "Keep spec is empty, removing nothing." << std::endl;
+      return ret;
+    }
+
+    _pimpl->parseKeepSpec();
+
+    if ( _pimpl->_keepRunning && !_pimpl->_detectedRunning ) {
+      WAR << "Unable to detect running kernel, but keeping the running kernel was requested. Not removing any packages." << std::endl;
+      return ret;
+    }
+
+    const GroupMap & installedKrnlPackages { _pimpl->installedGroups() };
+    ret.groups.reserve( installedKrnlPackages.size() );
+    for ( const auto & groupInfo : installedKrnlPackages ) {
+      ret.groups.emplace_back();
+      _pimpl->evaluateGroup( groupInfo, ret.groups.back() );
+      if ( cb_r )
+        cb_r( ret.groups.back() );
+    }
+    return ret;
+  }
+
+  void PurgeKernels::markObsoleteKernels()
+  {
+    markObsoleteKernels( computePlan() );
+  }
+
+  void PurgeKernels::markObsoleteKernels( const Plan & plan_r )
+  {
+    MIL << std::endl << "--------------------- Starting to mark obsolete kernels ---------------------"<<std::endl;
+
+    if ( plan_r.empty() ) {
+      MIL << "Nothing to remove." << std::endl;
+      return;
+    }
+
+    auto pool = ResPool::instance();
+    pool.resolver().setForceResolve( true ); // set allow uninstall flag
+
+    // the set of satSolvables that have to be kept always
+    std::set<sat::Solvable> packagesToKeep;
+    // packages that we plan to remove
+    std::set<sat::Solvable> packagesToRemove;
+    for ( const auto & group : plan_r.groups ) {
+      packagesToKeep.insert( group.keep.begin(), group.keep.end() );
+      packagesToRemove.insert( group.remove.begin(), group.remove.end() );
+    }
 
     for ( sat::Solvable slv : packagesToRemove )
       _pimpl->removePackageAndCheck( slv, packagesToKeep, packagesToRemove );
@@ -10,6 +10,10 @@
  *
 */
 
+#include <functional>
+#include <string>
+#include <vector>
+
 #include <zypp/Globals.h>
 #include <zypp/PoolItem.h>
 #include <zypp/base/PtrTypes.h>
@@ -26,16 +30,57 @@ namespace zypp {
    */
   class ZYPP_API PurgeKernels
   {
+  public:
+    /*!
+     * The keep spec applied to the installed kernel packages.
+     * Computing the plan does not touch the pools \ref ResStatus.
+     */
+    struct Plan
+    {
+      /*! The decision for one group of related packages (e.g. a kernel flavour). */
+      struct Group
+      {
+        std::string ident;                    //!< the groups name (flavour or package name)
+        std::vector<sat::Solvable> keep;      //!< packages to keep
+        std::vector<sat::Solvable> remove;    //!< packages to remove (if the solver agrees)
+      };
+
+      std::vector<Group> groups;
+
+      /*! Whether there is nothing to remove. */
+      bool empty() const;
+    };
+
+    /*! Called for each \ref Plan::Group as soon as it is computed. */
+    using PlanCallback = std::function<void( const Plan::Group & )>;
+
   public:
     PurgeKernels();
 
 
     /*!
      * Marks all currently obsolete Kernels according to the keep spec.
+     * Same as \ref markObsoleteKernels( \ref computePlan() ).
      * \note This will not commit the changes
      */
     void markObsoleteKernels();
 
+    /*!
+     * Computes which of the installed kernel packages are to be kept or
+     * removed according to the keep spec. The optional \a cb_r is
+     * called for each group as soon as its decision is made.
+     * \note Unlike \ref markObsoleteKernels this does not touch the pool.
+     */
+    Plan computePlan( const PlanCallback & cb_r = PlanCallback() );
+
+    /*!
+     * Marks the packages to remove in \a plan_r for removal. Each removal is
+     * checked by the solver; it is skipped if it would remove packages that
+     * are to be kept or are not kernel related.
+     * \note This will not commit the changes
+     */
+    void markObsoleteKernels( const Plan & plan_r );
+
     /*!
      * Force a specific uname to be set, only used for testing,
      * in production the running kernel is detected.
@@ -111,8 +111,11 @@ namespace zypp
   const pool::PoolTraits::ItemContainerT & ResPool::store() const
   { return _pimpl->store(); }
 
+  std::pair<ResPool::byIdent_iterator,ResPool::byIdent_iterator> ResPool::byIdentRange( sat::detail::IdType ident_r ) const
+  { return _pimpl->id2item().equal_range( ident_r ); }
+
   const pool::PoolTraits::Id2ItemT & ResPool::id2item() const
-  { return _pimpl->id2item(); }
+  { return _pimpl->id2itemMap(); }
 
   ///////////////////////////////////////////////////////////////////
   //
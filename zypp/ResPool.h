@@ -61,6 +61,7 @@ namespace zypp
   class ZYPP_API ResPool
   {
     friend std::ostream & operator<<( std::ostream & str, const ResPool & obj );
+    friend class pool::PoolImpl;
 
     public:
       /** \ref PoolItem */
@@ -165,10 +166,7 @@ namespace zypp
       using byIdent_iterator = pool::PoolTraits::byIdent_iterator;
 
       byIdent_iterator byIdentBegin( const ByIdent & ident_r ) const
-      {
-        return make_transform_iterator( id2item().equal_range( ident_r.get() ).first,
-                                        pool::PoolTraits::Id2ItemValueSelector() );
-      }
+      { return byIdentRange( ident_r.get() ).first; }
 
       byIdent_iterator byIdentBegin( ResKind kind_r, IdString name_r ) const
       { return byIdentBegin( ByIdent(std::move(kind_r),name_r) ); }
@@ -196,10 +194,7 @@ namespace zypp
 
 
       byIdent_iterator byIdentEnd( const ByIdent & ident_r ) const
-      {
-        return make_transform_iterator( id2item().equal_range( ident_r.get() ).second,
-                                        pool::PoolTraits::Id2ItemValueSelector() );
-      }
+      { return byIdentRange( ident_r.get() ).second; }
 
       byIdent_iterator byIdentEnd( ResKind kind_r, IdString name_r ) const
       { return byIdentEnd( ByIdent(std::move(kind_r),name_r) ); }
@@ -227,7 +222,7 @@ namespace zypp
 
 
       Iterable<byIdent_iterator> byIdent( const ByIdent & ident_r ) const
-      { return makeIterable( byIdentBegin( ident_r ), byIdentEnd( ident_r ) ); }
+      { return makeIterable( byIdentRange( ident_r.get() ) ); }
 
       Iterable<byIdent_iterator> byIdent( const ResKind& kind_r, IdString name_r ) const
       { return makeIterable( byIdentBegin( kind_r, name_r ), byIdentEnd(  kind_r, name_r ) ); }
@@ -461,6 +456,9 @@ namespace zypp
 
     private:
       const pool::PoolTraits::ItemContainerT & store() const;
+      /** The items of \a ident_r in the pools ident index. */
+      std::pair<byIdent_iterator,byIdent_iterator> byIdentRange( sat::detail::IdType ident_r ) const;
+      /** Legacy multimap ident index, built on demand (no longer used by \ref byIdent). */
       const pool::PoolTraits::Id2ItemT & id2item() const;
 
     private:
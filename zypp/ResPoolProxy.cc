@@ -10,6 +10,9 @@
  *
 */
 #include <iostream>
+#include <algorithm>
+#include <map>
+#include <unordered_set>
 #include <utility>
 #include <zypp/base/LogTools.h>
 
@@ -18,6 +21,7 @@
 #include <zypp/base/Functional.h>
 
 #include <zypp/ResPoolProxy.h>
+#include <zypp/sat/Pool.h>
 #include <zypp/pool/PoolImpl.h>
 #include <zypp/ui/SelectableImpl.h>
 
@@ -71,14 +75,27 @@ namespace zypp
 
   namespace
   {
-    ui::Selectable::Ptr makeSelectablePtr( pool::PoolImpl::Id2ItemT::const_iterator begin_r,
-                                           pool::PoolImpl::Id2ItemT::const_iterator end_r )
+    /** Repository priorities determine the order of a Selectables available items. */
+    using RepoPriorities = std::map<Repository::IdType, std::pair<int,int>>;
+
+    RepoPriorities repoPriorities()
     {
-      pool::PoolTraits::byIdent_iterator begin( begin_r, pool::PoolTraits::Id2ItemValueSelector() );
-      pool::PoolTraits::byIdent_iterator end( end_r, pool::PoolTraits::Id2ItemValueSelector() );
-      sat::Solvable solv( begin->satSolvable() );
+      RepoPriorities ret;
+      for ( const Repository & repo : sat::Pool::instance().repos() )
+        ret[repo.id()] = std::make_pair( repo.satInternalPriority(), repo.satInternalSubPriority() );
+      return ret;
+    }
 
-      return new ui::Selectable( ui::Selectable::Impl_Ptr( new ui::Selectable::Impl( solv.kind(), solv.name(), begin, end ) ) );
+    /** Whether a repo present in both snapshots changed its priority. */
+    bool repoPrioritiesChanged( const RepoPriorities & lhs_r, const RepoPriorities & rhs_r )
+    {
+      for ( const auto & el : lhs_r )
+      {
+        RepoPriorities::const_iterator it( rhs_r.find( el.first ) );
+        if ( it != rhs_r.end() && it->second != el.second )
+          return true;
+      }
+      return false;
     }
   } // namespace
 
@@ -86,15 +103,14 @@ namespace zypp
   //
   //	CLASS NAME : ResPoolProxy::Impl
   //
-  /** ResPoolProxy implementation.
-   * \todo Seedup as it is still using old index
-  */
+  /** ResPoolProxy implementation. */
   struct ResPoolProxy::Impl
   {
     friend std::ostream & operator<<( std::ostream & str, const Impl & obj );
     friend std::ostream & dumpOn( std::ostream & str, const Impl & obj );
 
-    using SelectableIndex = std::unordered_map<sat::detail::IdType, ui::Selectable::Ptr>;
+    /** The Selectable and its Impl (needed to update it in place). */
+    using SelectableIndex = std::unordered_map<sat::detail::IdType, std::pair<ui::Selectable::Ptr,ui::Selectable::Impl_Ptr>>;
     using const_iterator = ResPoolProxy::const_iterator;
 
   public:
@@ -106,28 +122,69 @@ namespace zypp
     : _pool( std::move(pool_r) )
     {
       const pool::PoolImpl::Id2ItemT & id2item( poolImpl_r.id2item() );
-      if ( ! id2item.empty() )
+      _selIndex.reserve( id2item.identsSize() );
+      for ( pool::PoolImpl::Id2ItemT::size_type idx = 0; idx < id2item.identsSize(); ++idx )
       {
-        // set startpoint
-        pool::PoolImpl::Id2ItemT::const_iterator cbegin = id2item.begin();
+        addSelectable( id2item.ident( idx ), id2item.identBegin( idx ), id2item.identEnd( idx ) );
+      }
+      _repoPriorities = repoPriorities();
+    }
 
-        for_( it, id2item.begin(), id2item.end() )
+    /** Patch the Selectables of \a idents_r after repos were added or removed.
+     * Selectables are created, updated in place or removed. All others
+     * remain untouched. Returns \c false if a known repositories priority
+     * changed (which affects the order of available items). Then the proxy
+     * must be rebuilt.
+     */
+    bool updateIdents( const pool::PoolImpl & poolImpl_r, std::vector<sat::detail::IdType> idents_r )
+    {
+      const pool::PoolImpl::Id2ItemT & id2item( poolImpl_r.id2item() );
+
+      RepoPriorities priorities( repoPriorities() );
+      if ( repoPrioritiesChanged( _repoPriorities, priorities ) )
+        return false;
+      _repoPriorities.swap( priorities );
+
+      if ( idents_r.empty() )
+        return true;
+      std::sort( idents_r.begin(), idents_r.end() );
+      idents_r.erase( std::unique( idents_r.begin(), idents_r.end() ), idents_r.end() );
+
+      unsigned added = 0;
+      std::unordered_set<const ui::Selectable *> removed;
+      for ( sat::detail::IdType ident : idents_r )
+      {
+        auto range( id2item.equal_range( ident ) );
+        SelectableIndex::iterator it( _selIndex.find( ident ) );
+        if ( range.first == range.second )
         {
-          if ( it->first != cbegin->first )
+          if ( it != _selIndex.end() )
           {
-            // starting a new Selectable, create the previous one
-            ui::Selectable::Ptr p( makeSelectablePtr( cbegin, it ) );
-            _selPool.insert( SelectablePool::value_type( p->kind(), p ) );
-            _selIndex[cbegin->first] = p;
-            // remember new startpoint
-            cbegin = it;
+            removed.insert( it->second.first.get() );
+            _selIndex.erase( it );
           }
         }
-        // create the final one
-        ui::Selectable::Ptr p( makeSelectablePtr( cbegin, id2item.end() ) );
-        _selPool.insert( SelectablePool::value_type( p->kind(), p ) );
-        _selIndex[cbegin->first] = p;
+        else if ( it == _selIndex.end() )
+        {
+          addSelectable( ident, range.first, range.second );
+          ++added;
+        }
+        else
+          it->second.second->setItems( range.first, range.second );
+      }
+
+      if ( ! removed.empty() )
+      {
+        for ( SelectablePool::iterator it = _selPool.begin(); it != _selPool.end(); )
+        {
+          if ( removed.count( it->second.get() ) )
+            it = _selPool.erase( it );
+          else
+            ++it;
+        }
       }
+      MIL << "Updated " << idents_r.size() << " idents (" << added << " new, " << removed.size() << " removed): " << *this << endl;
+      return true;
     }
 
   public:
@@ -135,7 +192,7 @@ namespace zypp
     {
       SelectableIndex::const_iterator it( _selIndex.find( ident_r.get() ) );
       if ( it != _selIndex.end() )
-        return it->second;
+        return it->second.first;
       return ui::Selectable::Ptr();
     }
 
@@ -195,10 +252,23 @@ namespace zypp
     bool diffState( const ResKind & kind_r ) const
     { return PoolItemSaver().diffState( _pool, kind_r ); }
 
+  private:
+    void addSelectable( sat::detail::IdType ident_r,
+                        pool::PoolImpl::Id2ItemT::const_iterator begin_r,
+                        pool::PoolImpl::Id2ItemT::const_iterator end_r )
+    {
+      sat::Solvable solv( begin_r->satSolvable() );
+      ui::Selectable::Impl_Ptr impl( new ui::Selectable::Impl( solv.kind(), solv.name(), begin_r, end_r ) );
+      ui::Selectable::Ptr p( new ui::Selectable( impl ) );
+      _selPool.insert( SelectablePool::value_type( p->kind(), p ) );
+      _selIndex[ident_r] = std::make_pair( p, impl );
+    }
+
   private:
     ResPool _pool;
     mutable SelectablePool _selPool;
     mutable SelectableIndex _selIndex;
+    RepoPriorities _repoPriorities;
 
   public:
     /** Offer default Impl. */
@@ -267,6 +337,9 @@ namespace zypp
   ResPoolProxy::~ResPoolProxy()
   {}
 
+  bool ResPoolProxy::updateIdents( const pool::PoolImpl & poolImpl_r, std::vector<sat::detail::IdType> idents_r )
+  { return _pimpl->updateIdents( poolImpl_r, std::move(idents_r) ); }
+
   ///////////////////////////////////////////////////////////////////
   //
   // forward to implementation
@@ -14,6 +14,7 @@
 
 #include <iosfwd>
 #include <utility>
+#include <vector>
 
 #include <zypp/base/PtrTypes.h>
 
@@ -248,6 +249,10 @@ namespace zypp
     friend class pool::PoolImpl;
     /** Ctor */
     ResPoolProxy( ResPool pool_r, const pool::PoolImpl & poolImpl_r );
+    /** Update the Selectables of \a idents_r after repos were added or removed.
+     * Returns \c false if the proxy must be rebuilt instead.
+     */
+    bool updateIdents( const pool::PoolImpl & poolImpl_r, std::vector<sat::detail::IdType> idents_r );
     /** Pointer to implementation */
     RW_pointer<Impl> _pimpl;
   };
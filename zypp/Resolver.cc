@@ -62,6 +62,9 @@ namespace zypp
   bool Resolver::resolvePool ()
   { return _pimpl->resolvePool(); }
 
+  ResolverWhatIfResultList Resolver::whatIf( const ResolverWhatIfRequestList & requests_r )
+  { return _pimpl->whatIf( requests_r ); }
+
   bool Resolver::resolveQueue( solver::detail::SolverQueueItemList & queue )
   { return _pimpl->resolveQueue(queue); }
 
@@ -74,9 +77,15 @@ namespace zypp
   void Resolver::applySolutions( const ProblemSolutionList & solutions )
   { _pimpl->applySolutions (solutions); }
 
+  ProblemSolutionEvaluationList Resolver::evaluateSolutions( const ProblemSolutionList & solutions )
+  { return _pimpl->evaluateSolutions( solutions ); }
+
   sat::Transaction Resolver::getTransaction()
   { return _pimpl->getTransaction(); }
 
+  const ResolverProfile & Resolver::profile() const
+  { return _pimpl->profile(); }
+
   bool Resolver::doUpgrade()
   { return _pimpl->doUpgrade(); }
 
@@ -164,6 +173,13 @@ namespace zypp
     return testcase.createTestcase(*_pimpl, true, runSolver);
   }
 
+  bool Resolver::createCompactSolverTestcase( const std::string & dumpPath, bool runSolver )
+  {
+    solver::detail::Testcase testcase (dumpPath);
+    testcase.setRepoFormat( solver::detail::Testcase::RepoFormat::Solv );
+    return testcase.createTestcase(*_pimpl, true, runSolver);
+  }
+
   solver::detail::ItemCapKindList Resolver::isInstalledBy( const PoolItem & item )
   { return _pimpl->isInstalledBy (item); }
 
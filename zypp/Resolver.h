@@ -90,6 +90,21 @@ namespace zypp
      **/
     bool resolvePool();
 
+    /**
+     * Batch "what-if" evaluation of independent requests.
+     *
+     * Each \ref ResolverWhatIfRequest is solved in a separate solver run
+     * on top of the transactions currently requested in the pool (the
+     * same jobs \ref resolvePool would use). The requests do not influence
+     * each other. For each request a compact summary of the resulting
+     * transaction is returned, in the order of \a requests_r.
+     *
+     * Neither the pool nor the result of the last \ref resolvePool (incl.
+     * \ref problems) are changed. This is much cheaper than selecting,
+     * solving and undoing each request in the pool.
+     **/
+    ResolverWhatIfResultList whatIf( const ResolverWhatIfRequestList & requests_r );
+
 
     /**
      * Resolve package dependencies:
@@ -171,11 +186,37 @@ namespace zypp
      **/
     void applySolutions( const ProblemSolutionList & solutions );
 
+    /**
+     * Speculatively evaluate problem solutions.
+     *
+     * For each solution (as returned by the last call to \ref problems)
+     * a separate solver run is performed on a copy of the last solvers
+     * jobs with just this solution applied. The result tells whether the
+     * solution leads to a clean transaction and how many items would be
+     * installed or removed. Neither the pool nor the resolver state are
+     * changed, so the least disruptive solution can be picked and applied
+     * via \ref applySolutions afterwards.
+     *
+     * Solutions not created by the last solver run are returned with
+     * \c evaluated set to \c false.
+     **/
+    ProblemSolutionEvaluationList evaluateSolutions( const ProblemSolutionList & solutions );
+
     /**
      * Return the \ref Transaction computed by the last solver run.
      */
     sat::Transaction getTransaction();
 
+    /**
+     * Timings and statistics of the last solver run.
+     *
+     * Covers pool preparation, job building, solving (incl. rule creation),
+     * copying the result back to the pool and the libsolv rule and decision
+     * counts. Time spent in \ref problems and \ref getTransaction after the
+     * solver run is added. \see \ref ResolverProfile::asJSON.
+     */
+    const ResolverProfile & profile() const;
+
     /**
      * Define the resolver's general attitude when resolving jobs.
      * \see \ref ResolverFocus
@@ -417,6 +458,19 @@ namespace zypp
      */
     bool createSolverTestcase( const std::string & dumpPath = "/var/log/YaST2/solverTestcase", bool runSolver = true );
 
+    /**
+     * Generates a compact solver Testcase of the current state
+     *
+     * Like \ref createSolverTestcase, but the repositories are stored as
+     * solv files (incl. \c @System). The testcase is much smaller and
+     * loads an order of magnitude faster, but it lacks libsolv's own
+     * \c testcase.t.
+     *
+     * \parame dumpPath destination directory of the created directory
+     * \return true if it was successful
+     */
+    bool createCompactSolverTestcase( const std::string & dumpPath = "/var/log/YaST2/solverTestcase", bool runSolver = true );
+
     /**
      * Gives information about WHO has pused an installation of an given item.
      *
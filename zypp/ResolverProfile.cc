@@ -0,0 +1,57 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/ResolverProfile.cc
+ */
+#include <iostream>
+#include <zypp/base/Json.h>
+#include <zypp/ResolverProfile.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  unsigned ResolverProfile::ruleCount() const
+  {
+    unsigned ret = 0;
+    for ( const auto & el : rules )
+      ret += el.second;
+    return ret;
+  }
+
+  std::string ResolverProfile::asJSON() const
+  {
+    return json::Object {
+      { "prepare_us",	prepare.count() },
+      { "jobs_us",	jobs.count() },
+      { "solve_us",	solve.count() },
+      { "result_us",	result.count() },
+      { "problems_us",	problems.count() },
+      { "transaction_us",	transaction.count() },
+      { "reused",	reused },
+      { "jobs",		jobCount },
+      { "decisions",	decisions },
+      { "problems",	problemCount },
+      { "rules",	rules },
+    }.asJSON();
+  }
+
+  std::ostream & operator<<( std::ostream & str, const ResolverProfile & obj )
+  {
+    str << "ResolverProfile[";
+    if ( obj.reused )
+      str << "reused ";
+    return str << "prepare " << obj.prepare.count()
+               << "us, jobs " << obj.jobs.count()
+               << "us, solve " << obj.solve.count()
+               << "us, result " << obj.result.count()
+               << "us | " << obj.jobCount << " jobs, " << obj.ruleCount() << " rules, "
+               << obj.decisions << " decisions, " << obj.problemCount << " problems]";
+  }
+
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
@@ -0,0 +1,82 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/ResolverProfile.h
+ */
+#ifndef ZYPP_RESOLVERPROFILE_H
+#define ZYPP_RESOLVERPROFILE_H
+
+#include <iosfwd>
+#include <chrono>
+#include <map>
+#include <string>
+
+#include <zypp/Globals.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  /// \class ResolverProfile
+  /// \brief Timings and statistics of the last solver run.
+  ///
+  /// The phases are timed separately. Rules are created by libsolv as
+  /// part of solving, so \ref solve includes the rule creation. The
+  /// \ref problems and \ref transaction times accumulate the calls to
+  /// \ref Resolver::problems and \ref Resolver::getTransaction after the
+  /// solver run.
+  ///////////////////////////////////////////////////////////////////
+  struct ZYPP_API ResolverProfile
+  {
+    using Duration = std::chrono::microseconds;
+
+    Duration prepare     { 0 };	///< Pool preparation (whatprovides)
+    Duration jobs        { 0 };	///< Building the solver jobs
+    Duration solve       { 0 };	///< Rule creation and solving
+    Duration result      { 0 };	///< Copying the result back to the pool
+    Duration problems    { 0 };	///< Problem extraction
+    Duration transaction { 0 };	///< Building the transaction
+
+    bool reused = false;		///< Whether the last result was reused (jobs and settings unchanged)
+    unsigned jobCount = 0;		///< Number of solver jobs
+    unsigned decisions = 0;		///< Number of solver decisions
+    unsigned problemCount = 0;		///< Number of problems
+    std::map<std::string,unsigned> rules;	///< Number of rules per rule class
+
+    /** Total number of rules. */
+    unsigned ruleCount() const;
+
+    /** JSON representation */
+    std::string asJSON() const;
+
+    /** Adds the elapsed time to a \ref Duration when going out of scope. */
+    struct Timer
+    {
+      Timer( Duration & target_r )
+      : _target( target_r )
+      , _start( std::chrono::steady_clock::now() )
+      {}
+
+      Timer( const Timer & ) = delete;
+      Timer & operator=( const Timer & ) = delete;
+
+      ~Timer()
+      { _target += std::chrono::duration_cast<Duration>( std::chrono::steady_clock::now() - _start ); }
+
+    private:
+      Duration & _target;
+      std::chrono::steady_clock::time_point _start;
+    };
+  };
+
+  /** \relates ResolverProfile Stream output */
+  std::ostream & operator<<( std::ostream & str, const ResolverProfile & obj ) ZYPP_API;
+
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_RESOLVERPROFILE_H
@@ -0,0 +1,38 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/ResolverWhatIf.cc
+ */
+#include <iostream>
+#include <zypp/ResolverWhatIf.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  std::ostream & operator<<( std::ostream & str, const ResolverWhatIfRequest & obj )
+  {
+    str << "WhatIf[";
+    for ( const PoolItem & pi : obj.install )
+      str << " +" << pi.satSolvable();
+    for ( const PoolItem & pi : obj.remove )
+      str << " -" << pi.satSolvable();
+    return str << " ]";
+  }
+
+  std::ostream & operator<<( std::ostream & str, const ResolverWhatIfResult & obj )
+  {
+    str << "WhatIfResult[";
+    if ( obj.solved )
+      str << "solved";
+    else
+      str << obj.problems << " problems";
+    return str << " +" << obj.installs.size() << " -" << obj.removes.size() << "]";
+  }
+
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
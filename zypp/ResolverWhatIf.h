@@ -0,0 +1,52 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/ResolverWhatIf.h
+ */
+#ifndef ZYPP_RESOLVERWHATIF_H
+#define ZYPP_RESOLVERWHATIF_H
+
+#include <iosfwd>
+#include <vector>
+
+#include <zypp/PoolItem.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  /** An independent request for \ref Resolver::whatIf.
+   *
+   * Items to install and installed items to remove, on top of the
+   * transactions already requested in the pool.
+   */
+  struct ResolverWhatIfRequest
+  {
+    std::vector<PoolItem> install;	///< Items to install.
+    std::vector<PoolItem> remove;	///< Installed items to remove.
+  };
+  using ResolverWhatIfRequestList = std::vector<ResolverWhatIfRequest>;
+
+  /** Compact transaction summary of a \ref ResolverWhatIfRequest. */
+  struct ResolverWhatIfResult
+  {
+    bool solved = false;		///< Whether the solver run succeeded without problems.
+    unsigned problems = 0;		///< Number of problems otherwise.
+    std::vector<sat::Solvable> installs;	///< Solvables to be installed.
+    std::vector<sat::Solvable> removes;	///< Installed solvables to be removed.
+  };
+  using ResolverWhatIfResultList = std::vector<ResolverWhatIfResult>;
+
+  /** \relates ResolverWhatIfRequest Stream output */
+  std::ostream & operator<<( std::ostream & str, const ResolverWhatIfRequest & obj ) ZYPP_API;
+
+  /** \relates ResolverWhatIfResult Stream output */
+  std::ostream & operator<<( std::ostream & str, const ResolverWhatIfResult & obj ) ZYPP_API;
+
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_RESOLVERWHATIF_H
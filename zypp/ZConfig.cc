@@ -617,6 +617,14 @@ namespace zypp
                 {
                   commit_downloadMode.set( deserializeDownloadMode( value ) );
                 }
+                else if ( entry == "commit.downloadHeapSize" )
+                {
+                  commit_downloadHeapSize = ByteCount( str::strtonum<unsigned>( value ), ByteCount::MiB );
+                }
+                else if ( entry == "commit.parallelPosttrans" )
+                {
+                  str::split( value, std::inserter( commit_parallelPosttrans, commit_parallelPosttrans.end() ), ", \t" );
+                }
                 else if ( entry == "gpgcheck" )
                 {
                   gpgCheck.restoreToDefault( str::strToBool( value, gpgCheck ) );
@@ -789,6 +797,8 @@ namespace zypp
     DefaultOption<Pathname> download_mediaMountdir;
 
     Option<DownloadMode> commit_downloadMode;
+    ByteCount commit_downloadHeapSize;
+    std::set<std::string> commit_parallelPosttrans;
 
     DefaultOption<bool>		gpgCheck;
     DefaultOption<TriBool>	repoGpgCheck;
@@ -1210,6 +1220,12 @@ namespace zypp
   DownloadMode ZConfig::commit_downloadMode() const
   { return _pimpl->commit_downloadMode; }
 
+  ByteCount ZConfig::commit_downloadHeapSize() const
+  { return _pimpl->commit_downloadHeapSize; }
+
+  const std::set<std::string> & ZConfig::commit_parallelPosttrans() const
+  { return _pimpl->commit_parallelPosttrans; }
+
 
   bool ZConfig::gpgCheck() const			{ return _pimpl->gpgCheck; }
   TriBool ZConfig::repoGpgCheck() const			{ return _pimpl->repoGpgCheck; }
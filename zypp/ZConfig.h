@@ -23,6 +23,7 @@
 #include <zypp/Arch.h>
 #include <zypp/Locale.h>
 #include <zypp/Pathname.h>
+#include <zypp/ByteCount.h>
 #include <zypp/IdString.h>
 #include <zypp/TriBool.h>
 #include <zypp/ResolverFocus.h>
@@ -360,6 +361,20 @@ namespace zypp
        */
       DownloadMode commit_downloadMode() const;
 
+      /**
+       * Maximum size of the packages downloaded for one heap in
+       * \ref DownloadInHeaps mode (see commit.downloadHeapSize in zypp.conf).
+       * \c 0 means no limit, all packages are downloaded in advance.
+       */
+      ByteCount commit_downloadHeapSize() const;
+
+      /**
+       * Names of packages whose %posttrans script is independent of any
+       * other script (e.g. just updates some cache). Those scripts may be
+       * run in parallel (see commit.parallelPosttrans in zypp.conf).
+       */
+      const std::set<std::string> & commit_parallelPosttrans() const;
+
       /** \name Signature checking (repodata and packages)
        * If \ref gpgcheck is \c on (the default), we will either check the signature
        * of repo metadata (packages are secured via checksum in the metadata), or the
@@ -38,6 +38,7 @@ namespace zypp
       sat::Transaction          _transaction;
       TransactionStepList       _transactionStepList;
       UpdateNotifications	_updateMessages;
+      HeaderPrereadStats	_headerPrereadStats;
 
     private:
       friend Impl * rwcowClone<Impl>( const Impl * rhs );
@@ -99,6 +100,12 @@ namespace zypp
   UpdateNotifications & ZYppCommitResult::rUpdateMessages()
   { return _pimpl->_updateMessages; }
 
+  const ZYppCommitResult::HeaderPrereadStats & ZYppCommitResult::headerPrereadStats() const
+  { return _pimpl->_headerPrereadStats; }
+
+  void ZYppCommitResult::setHeaderPrereadStats( const HeaderPrereadStats & stats_r )
+  { _pimpl->_headerPrereadStats = stats_r; }
+
   ///////////////////////////////////////////////////////////////////
 
   std::ostream & operator<<( std::ostream & str, const ZYppCommitResult & obj )
@@ -121,6 +128,10 @@ namespace zypp
         << ", skipped " << result[3]
         << ", updateMessages " << obj.updateMessages().size()
         << ")";
+    if ( obj.headerPrereadStats().headers )
+      str << " (" << obj.headerPrereadStats().headers << " headers read by "
+          << obj.headerPrereadStats().threads << " threads in "
+          << obj.headerPrereadStats().milliseconds << "ms)";
     return str;
   }
 
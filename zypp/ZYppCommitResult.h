@@ -150,6 +150,24 @@ namespace zypp
        */
       UpdateNotifications & rUpdateMessages();
 
+      /** Statistics about reading the package headers (single transaction mode).
+       * zypp-rpm reads and verifies the headers of the packages to install on
+       * a pool of threads before the transaction is set up. All values are \c 0
+       * if the headers were read one by one.
+       */
+      struct HeaderPrereadStats
+      {
+        unsigned headers = 0;		///< number of headers read in parallel
+        unsigned threads = 0;		///< number of threads used
+        unsigned milliseconds = 0;	///< wall time needed
+      };
+
+      /** \ref HeaderPrereadStats of the single transaction. */
+      const HeaderPrereadStats & headerPrereadStats() const;
+
+      /** Set \ref headerPrereadStats */
+      void setHeaderPrereadStats( const HeaderPrereadStats & stats_r );
+
     public:
 
       /** \name Some statistics based on \ref Transaction
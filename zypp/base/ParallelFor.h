@@ -0,0 +1,117 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/base/ParallelFor.h
+ * Internal helper to spread CPU bound loops across worker threads.
+ */
+#ifndef ZYPP_BASE_PARALLELFOR_H
+#define ZYPP_BASE_PARALLELFOR_H
+
+#include <cstdlib>
+#include <algorithm>
+#include <exception>
+#include <thread>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  namespace base
+  {
+    /** Number of worker threads to use for \a work_r items of CPU bound work.
+     *
+     * Defaults to \c std::thread::hardware_concurrency, but never more
+     * threads than \c work_r / \c minChunk_r. The environment variable
+     * \c ZYPP_MAX_THREADS may be used to limit the number of threads
+     * (\c ZYPP_MAX_THREADS=1 disables threading at all).
+     */
+    inline unsigned parallelJobs( size_t work_r, size_t minChunk_r = 1024 )
+    {
+      unsigned ret = std::thread::hardware_concurrency();
+      if ( const char * envp = ::getenv( "ZYPP_MAX_THREADS" ) )
+      {
+        unsigned lim = std::strtoul( envp, nullptr, 10 );
+        if ( lim && lim < ret )
+          ret = lim;
+      }
+      if ( ! ret )
+        ret = 1;
+      size_t chunks = minChunk_r ? work_r / minChunk_r : work_r;
+      if ( chunks < ret )
+        ret = chunks ? chunks : 1;
+      return ret;
+    }
+
+    /** Split <tt>[0,size_r)</tt> into contiguous chunks and call
+     * <tt>fnc_r( chunk, begin, end )</tt> for each of them on a worker thread.
+     *
+     * Chunks are numbered in ascending index order, so a caller collecting
+     * per chunk results can simply concatenate them to preserve the order.
+     * The calling thread processes the 1st chunk itself and returns after
+     * all workers are joined. An exception thrown by a worker is rethrown
+     * in the calling thread (the 1st one, if there are many).
+     *
+     * \note \a fnc_r must not touch shared data that is modified concurrently.
+     * Reading the sat-pool is fine as long as nobody modifies it (i.e. no new
+     * \ref IdString or \ref Capability is created meanwhile).
+     *
+     * \code
+     *   std::vector<std::vector<Result>> parts( base::parallelJobs( size ) );
+     *   base::parallelFor( size, parts.size(), [&]( unsigned chunk, size_t begin, size_t end ) {
+     *     for ( size_t i = begin; i < end; ++i )
+     *       parts[chunk].push_back( compute( i ) );
+     *   } );
+     * \endcode
+     */
+    template <class TFnc>
+    void parallelFor( size_t size_r, unsigned jobs_r, TFnc && fnc_r )
+    {
+      if ( ! size_r )
+        return;
+      if ( jobs_r <= 1 || size_r == 1 )
+      {
+        fnc_r( 0U, size_t(0), size_r );
+        return;
+      }
+      jobs_r = std::min( size_t(jobs_r), size_r );
+
+      size_t step = size_r / jobs_r;
+      size_t rest = size_r % jobs_r;
+      auto chunkBegin = [&]( unsigned chunk_r ) -> size_t
+      { return chunk_r * step + std::min( size_t(chunk_r), rest ); };
+
+      std::vector<std::exception_ptr> excpt( jobs_r );
+      std::vector<std::thread> workers;
+      workers.reserve( jobs_r-1 );
+      for ( unsigned chunk = 1; chunk < jobs_r; ++chunk )
+      {
+        workers.emplace_back( [&,chunk]() {
+          try { fnc_r( chunk, chunkBegin( chunk ), chunkBegin( chunk+1 ) ); }
+          catch ( ... ) { excpt[chunk] = std::current_exception(); }
+        } );
+      }
+      try { fnc_r( 0U, chunkBegin( 0 ), chunkBegin( 1 ) ); }
+      catch ( ... ) { excpt[0] = std::current_exception(); }
+
+      for ( auto & worker : workers )
+        worker.join();
+      for ( auto & e : excpt )
+        if ( e ) std::rethrow_exception( e );
+    }
+
+    /** \overload Using \ref parallelJobs threads. */
+    template <class TFnc>
+    void parallelFor( size_t size_r, TFnc && fnc_r )
+    { parallelFor( size_r, parallelJobs( size_r ), std::forward<TFnc>(fnc_r) ); }
+
+  } // namespace base
+  ///////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_BASE_PARALLELFOR_H
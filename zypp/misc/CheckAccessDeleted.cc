@@ -13,12 +13,16 @@
 #include <fstream>
 #include <unordered_set>
 #include <iterator>
+#include <algorithm>
+#include <functional>
 #include <stdio.h>
+#include <pwd.h>
 #include <zypp/base/LogControl.h>
 #include <zypp/base/LogTools.h>
 #include <zypp/base/String.h>
 #include <zypp/base/Gettext.h>
 #include <zypp/base/Exception.h>
+#include <zypp/base/ParallelFor.h>
 
 #include <zypp/PathInfo.h>
 #include <zypp/ExternalProgram.h>
@@ -173,6 +177,171 @@ namespace zypp
     };
 
 
+    /////////////////////////////////////////////////////////////////
+    /// \class ProcScanner
+    /// \brief Collect processes accessing deleted files from /proc.
+    ///
+    /// Reads /proc/<pid>/map_files (or /proc/<pid>/maps if map_files is
+    /// not accessible) of all processes in parallel. Only mappings of
+    /// deleted files are kept. The result is provided in
+    /// lsof output format (\c -FpcuLRftkn0), so it can be processed and
+    /// written to the debug file like real lsof output.
+    ///
+    /// Processes running in a container are omitted. As the container check
+    /// is expensive, it's done only for processes accessing deleted files.
+    /////////////////////////////////////////////////////////////////
+    struct ProcScanner
+    {
+      /** Whether /proc is available for scanning. */
+      static bool available()
+      { return PathInfo( "/proc/self/maps" ).isFile(); }
+
+      /** lsof output lines of all processes accessing deleted files. */
+      std::vector<std::string> operator()() const
+      {
+        std::vector<pid_t> pids;
+        filesystem::dirForEach( "/proc", [&pids]( const Pathname &, const char *const name_r ) {
+          pid_t pid = 0;
+          if ( str::strtonum( name_r, pid ) && pid > 0 && asString( pid ) == name_r )
+            pids.push_back( pid );
+          return true;
+        });
+        std::sort( pids.begin(), pids.end() );
+
+        std::vector<std::vector<std::string>> results( pids.size() );
+        {
+          zypp::base::LogControl::TmpLineWriter shutUp;	// suppress excessive readdir etc. logging
+          base::parallelFor( pids.size(), std::min( base::parallelJobs( pids.size(), 64 ), 8U ), [&]( unsigned, size_t begin_r, size_t end_r ) {
+            for ( size_t i = begin_r; i < end_r; ++i )
+              results[i] = scanProcess( pids[i] );
+          } );
+        }
+
+        std::vector<std::string> ret;
+        for ( auto & lines : results )
+          std::move( lines.begin(), lines.end(), std::back_inserter( ret ) );
+        return ret;
+      }
+
+    private:
+      /** The lsof output lines for \a pid_r, or nothing if it does not access deleted files. */
+      static std::vector<std::string> scanProcess( pid_t pid_r )
+      {
+        static const std::string deletedTag { " (deleted)" };
+        std::vector<std::string> ret;
+        const Pathname pidDir { Pathname("/proc") / asString( pid_r ) };
+
+        // the executable itself
+        std::string exe { filesystem::readlink( pidDir / "exe" ).asString() };
+        if ( str::endsWith( exe, deletedTag ) )
+        {
+          exe.erase( exe.size() - deletedTag.size() );
+          ret.push_back( str::Str() << "ftxt" << '\0' << "tREG" << '\0' << "k0" << '\0' << 'n' << exe << '\0' << '\n' );
+        }
+
+        std::unordered_set<std::string> seen;
+        const auto & addMapped = [&]( std::string name_r ) {
+          if ( ! str::endsWith( name_r, deletedTag ) )
+            return;
+          name_r.erase( name_r.size() - deletedTag.size() );
+          if ( name_r == exe || ! seen.insert( name_r ).second )
+            return;
+          ret.push_back( str::Str() << "fDEL" << '\0' << "tDEL" << '\0' << 'n' << name_r << '\0' << '\n' );
+        };
+
+        // mapped files: map_files/<range> is a link to the file mapped
+        bool unreadable = false;
+        if ( filesystem::dirForEach( pidDir / "map_files", [&]( const Pathname & dir_r, const char *const name_r ) {
+          Pathname target { filesystem::readlink( dir_r / name_r ) };
+          if ( target.empty() )
+          {
+            unreadable = true;	// not permitted
+            return false;
+          }
+          addMapped( target.asString() );
+          return true;
+        } ) != 0 || unreadable )
+        {
+          // map_files may need more privileges than maps: "address perms offset dev inode pathname"
+          std::ifstream maps( ( pidDir / "maps" ).c_str() );
+          for ( std::string line; std::getline( maps, line ); )
+          {
+            std::string::size_type pos = line.find( '/' );
+            if ( pos != std::string::npos )
+              addMapped( line.substr( pos ) );
+          }
+        }
+
+        if ( ret.empty() || FilterRunsInContainer()( pid_r ) )
+          return std::vector<std::string>();
+
+        // the process line goes first
+        std::string command;
+        std::string ppid;
+        std::string puid;
+        std::string login;
+
+        {
+          std::ifstream comm( ( pidDir / "comm" ).c_str() );
+          std::getline( comm, command );
+        }
+
+        {
+          // "pid (comm) state ppid ..." comm may contain blanks and parens
+          std::string stat;
+          std::ifstream statFile( ( pidDir / "stat" ).c_str() );
+          std::getline( statFile, stat );
+          std::string::size_type pos = stat.rfind( ')' );
+          if ( pos != std::string::npos )
+          {
+            std::vector<std::string> words;
+            str::split( stat.substr( pos+1 ), std::back_inserter( words ) );
+            if ( words.size() > 1 )
+              ppid = words[1];
+          }
+        }
+
+        {
+          // "Uid:	real	effective	saved	fs"
+          std::ifstream status( ( pidDir / "status" ).c_str() );
+          for ( std::string line; std::getline( status, line ); )
+          {
+            if ( str::startsWith( line, "Uid:" ) )
+            {
+              std::vector<std::string> words;
+              str::split( line, std::back_inserter( words ) );
+              if ( words.size() > 1 )
+                puid = words[1];
+              break;
+            }
+          }
+        }
+
+        if ( ! puid.empty() )
+        {
+          struct passwd pwd;
+          struct passwd * result = nullptr;
+          char buf[1024];
+          if ( ::getpwuid_r( str::strtonum<uid_t>( puid ), &pwd, buf, sizeof(buf), &result ) == 0 && result )
+            login = result->pw_name;
+        }
+
+        str::Str pline;
+        pline << 'p' << pid_r << '\0';
+        if ( ! command.empty() )
+          pline << 'c' << command << '\0';
+        if ( ! puid.empty() )
+          pline << 'u' << puid << '\0';
+        if ( ! login.empty() )
+          pline << 'L' << login << '\0';
+        if ( ! ppid.empty() )
+          pline << 'R' << ppid << '\0';
+        pline << '\n';
+        ret.insert( ret.begin(), pline.str() );
+        return ret;
+      }
+    };
+
     /** bsc#1099847: Check for lsof version < 4.90 which does not support '-K i'
      * Just a quick check to allow code15 libzypp runnig in a code12 environment.
      * bsc#1036304: '-K i' was backported to older lsof versions, indicated by
@@ -215,7 +384,8 @@ namespace zypp
     bool addDataIf( const CacheEntry & cache_r, std::vector<std::string> *debMap = nullptr );
     void addCacheIf( CacheEntry & cache_r, const std::string & line_r, std::vector<std::string> *debMap = nullptr );
 
-    std::map<pid_t,CacheEntry> filterInput( externalprogram::ExternalDataSource &source );
+    std::map<pid_t,CacheEntry> filterInput( const std::function<std::string()> & nextLine_r, bool checkContainer_r );
+    CheckAccessDeleted::size_type checkLsof();
     CheckAccessDeleted::size_type createProcInfo( const std::map<pid_t,CacheEntry> &in );
 
     std::vector<CheckAccessDeleted::ProcInfo> _data;
@@ -400,11 +570,11 @@ namespace zypp
 
     //inFile is closed by ExternalDataSource
     externalprogram::ExternalDataSource inSource( inFile, nullptr );
-    auto cache = _pimpl->filterInput( inSource );
+    auto cache = _pimpl->filterInput( [&inSource]() { return inSource.receiveLine( 30 * 1000 ); }, false );
     return _pimpl->createProcInfo( cache );
   }
 
-  std::map<pid_t,CacheEntry> CheckAccessDeleted::Impl::filterInput( externalprogram::ExternalDataSource &source )
+  std::map<pid_t,CacheEntry> CheckAccessDeleted::Impl::filterInput( const std::function<std::string()> & nextLine_r, bool checkContainer_r )
   {
     // cachemap: PID => (deleted files)
     // NOTE: omit PIDs running in a (lxc/docker) container
@@ -416,13 +586,13 @@ namespace zypp
     FilterRunsInContainer runsInLXC;
     MIL << "Silently scanning lsof output..." << endl;
     zypp::base::LogControl::TmpLineWriter shutUp;	// suppress excessive readdir etc. logging in runsInLXC
-    for( std::string line = source.receiveLine( 30 * 1000 ); ! line.empty(); line = source.receiveLine(  30 * 1000  ) )
+    for( std::string line = nextLine_r(); ! line.empty(); line = nextLine_r() )
     {
       // NOTE: line contains '\0' separeated fields!
       if ( line[0] == 'p' )
       {
         str::strtonum( line.c_str()+1, cachepid );	// line is "p<PID>\0...."
-        if ( _fromLsofFileMode || !runsInLXC( cachepid ) ) {
+        if ( !checkContainer_r || !runsInLXC( cachepid ) ) {
           if ( debugEnabled ) {
             auto &pidMad = debugMap[cachepid];
             if ( pidMad.empty() )
@@ -445,19 +615,33 @@ namespace zypp
   }
 
   CheckAccessDeleted::size_type CheckAccessDeleted::check( bool verbose_r  )
+  {
+    _pimpl->_verbose = verbose_r;
+    _pimpl->_fromLsofFileMode = false;
+
+    if ( ! ProcScanner::available() )
+    {
+      MIL << "/proc is not available, using lsof." << endl;
+      return _pimpl->checkLsof();
+    }
+
+    std::vector<std::string> lines { ProcScanner()() };
+    auto next = lines.begin();
+    auto cachemap = _pimpl->filterInput( [&]() { return next == lines.end() ? std::string() : std::move( *next++ ); }, false );
+    return _pimpl->createProcInfo( cachemap );
+  }
+
+  CheckAccessDeleted::size_type CheckAccessDeleted::Impl::checkLsof()
   {
     static const char* argv[] = { "lsof", "-n", "-FpcuLRftkn0", "-K", "i", NULL };
     if ( lsofNoOptKi() )
       argv[3] = NULL;
 
-    _pimpl->_verbose = verbose_r;
-    _pimpl->_fromLsofFileMode = false;
-
     ExternalProgram prog( argv, ExternalProgram::Discard_Stderr );
     std::map<pid_t,CacheEntry> cachemap;
 
     try {
-      cachemap = _pimpl->filterInput( prog );
+      cachemap = filterInput( [&prog]() { return prog.receiveLine( 30 * 1000 ); }, true );
     } catch ( const io::TimeoutException &e ) {
       ZYPP_CAUGHT( e );
       prog.kill();
@@ -476,7 +660,7 @@ namespace zypp
       ZYPP_THROW( err );
     }
 
-    return _pimpl->createProcInfo( cachemap );
+    return createProcInfo( cachemap );
   }
 
   CheckAccessDeleted::size_type CheckAccessDeleted::Impl::createProcInfo(const std::map<pid_t,CacheEntry> &in)
@@ -85,8 +85,12 @@ namespace zypp
        * A verbose check will omit this test and collect all processes using
        * any deleted file.
        *
+       * The data is collected by scanning \c /proc/<pid>/map_files (or
+       * \c /proc/<pid>/maps) of all processes in parallel. Only if \c /proc
+       * is not available \c lsof is used.
+       *
        * \return the number of processes found.
-       * \throws Exception On error collecting the data (e.g. no lsof installed)
+       * \throws Exception On error collecting the data (e.g. no \c /proc and no lsof installed)
        */
       size_type check( bool verbose_r = false );
 
@@ -94,6 +98,7 @@ namespace zypp
        * \overload
        * Performs the same checks but instead of investigating the current system it
        * uses information from \a lsofOutput_r to support debugging.
+       * The file is in <tt>lsof -F0</tt> format, as written by \ref setDebugOutputFile.
        *
        * \sa setDebugOutputFile
        */
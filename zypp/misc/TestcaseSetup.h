@@ -37,6 +37,7 @@ namespace zypp::misc::testcase
   enum class TestcaseRepoType {
     Helix,
     Testtags,
+    Solv,
     Url
   };
 
@@ -22,6 +22,12 @@
 
 namespace yamltest::detail {
 
+  // repos are stored as libsolv testtags or as solv files (compact testcases)
+  inline zypp::misc::testcase::TestcaseRepoType repoTypeOfFile( const std::string & file_r ) {
+    return zypp::str::endsWith( file_r, ".solv" ) ? zypp::misc::testcase::TestcaseRepoType::Solv
+                                                  : zypp::misc::testcase::TestcaseRepoType::Testtags;
+  }
+
   bool parseSetup ( const YAML::Node &setup, zypp::misc::testcase::TestcaseSetup &t, std::string *err ) {
 
     auto &target = t.data();
@@ -99,7 +105,7 @@ namespace yamltest::detail {
         }
       } else if ( key == ("system") ) {
         target.systemRepo = zypp::misc::testcase::RepoDataImpl {
-          zypp::misc::testcase::TestcaseRepoType::Testtags,
+          repoTypeOfFile( data["file"].as<std::string>() ),
           "@System",
           99,
           data["file"].as<std::string>()
@@ -132,7 +138,7 @@ namespace yamltest::detail {
             prio = dataNode["priority"].as<unsigned>();
 
           target.repos.push_back( zypp::misc::testcase::RepoDataImpl{
-            zypp::misc::testcase::TestcaseRepoType::Testtags,
+            repoTypeOfFile( file ),
             name,
             prio,
             file
@@ -230,6 +236,10 @@ namespace yamltest::detail {
       else if ( key == ("setlicencebit") ) {
         target.set_licence = data.as<bool>();
       }
+      else if ( key == ("solverProfile") ) {
+        // informational only: timings and statistics of the run that created the testcase
+        MIL << "Solver profile of the original run in '" << data.as<std::string>() << "'" << std::endl;
+      }
       else {
         ERR << "Ignoring unrecognized tag '" << key << "' in setup" << std::endl;
       }
@@ -0,0 +1,418 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/pool/EstablishCache.cc
+ *
+*/
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+
+#include <zypp/base/LogTools.h>
+#include <zypp/base/IOStream.h>
+#include <zypp/base/String.h>
+#include <zypp/base/Exception.h>
+
+#include <zypp/pool/EstablishCache.h>
+#include <zypp/sat/Pool.h>
+#include <zypp/Repository.h>
+#include <zypp/PathInfo.h>
+#include <zypp/TmpPath.h>
+
+using std::endl;
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{ /////////////////////////////////////////////////////////////////
+  ///////////////////////////////////////////////////////////////////
+  namespace pool
+  { /////////////////////////////////////////////////////////////////
+
+    namespace
+    {
+      using IdType = EstablishCache::IdType;
+
+      inline EstablishCache::ItemKey itemKey( sat::Solvable slv_r )
+      { return EstablishCache::ItemKey( slv_r.ident().id(), slv_r.edition().id(), slv_r.arch().id() ); }
+
+      /** Collect the names used in \a cap_r.
+       * \returns \c false if \a cap_r can not be broken down into names (e.g. namespaces).
+       */
+      bool collectNames( Capability cap_r, std::vector<IdType> & names_r )
+      {
+        CapDetail detail( cap_r );
+        if ( detail.isSimple() )
+        {
+          names_r.push_back( detail.name().id() );
+          return true;
+        }
+        if ( detail.isExpression() && detail.capRel() != CapDetail::CAP_NAMESPACE )
+        {
+          bool lhs = collectNames( detail.lhs(), names_r );
+          bool rhs = collectNames( detail.rhs(), names_r );
+          return lhs && rhs;
+        }
+        return detail.isNull();
+      }
+
+      /** \overload for all \a caps_r */
+      bool collectNames( Capabilities caps_r, std::vector<IdType> & names_r )
+      {
+        bool ret = true;
+        for ( const Capability & cap : caps_r )
+        {
+          if ( ! collectNames( cap, names_r ) )
+            ret = false;
+        }
+        return ret;
+      }
+
+      inline void sortUnique( std::vector<IdType> & names_r )
+      {
+        std::sort( names_r.begin(), names_r.end() );
+        names_r.erase( std::unique( names_r.begin(), names_r.end() ), names_r.end() );
+      }
+
+      /** Names an installed package may influence a pseudo installed items state with. */
+      std::vector<IdType> installedNames( sat::Solvable slv_r )
+      {
+        std::vector<IdType> ret { slv_r.ident().id() };
+        collectNames( slv_r.provides(), ret );
+        collectNames( slv_r.conflicts(), ret );
+        collectNames( slv_r.obsoletes(), ret );
+        sortUnique( ret );
+        return ret;
+      }
+
+      /** Whether the sorted ranges \a lhs_r and \a rhs_r intersect. */
+      inline bool intersects( const std::vector<IdType> & lhs_r, const std::vector<IdType> & rhs_r )
+      {
+        auto l = lhs_r.begin();
+        auto r = rhs_r.begin();
+        while ( l != lhs_r.end() && r != rhs_r.end() )
+        {
+          if ( *l < *r )
+            ++l;
+          else if ( *r < *l )
+            ++r;
+          else
+            return true;
+        }
+        return false;
+      }
+
+      inline Pathname cookieFile( const Pathname & file_r )
+      { return file_r.extend( ".cookie" ); }
+    } // namespace
+
+    ///////////////////////////////////////////////////////////////////
+    //
+    //	CLASS NAME : EstablishCache
+    //
+    ///////////////////////////////////////////////////////////////////
+
+    unsigned EstablishCache::size() const
+    {
+      unsigned ret = 0;
+      for ( const auto & repo : _states )
+        ret += repo.second.size();
+      return ret;
+    }
+
+    void EstablishCache::clear()
+    {
+      _states.clear();
+      _installed.clear();
+      _installedValid = false;
+      _dirty = false;
+      _computed = 0;
+      _repoKeys.clear();
+    }
+
+    void EstablishCache::setPersistent( const Pathname & file_r, const RepoStatus & systemStatus_r )
+    {
+      _file = file_r;
+      _systemStatus = systemStatus_r;
+      if ( _file.empty() || _systemStatus.empty() )
+        return;
+
+      if ( _states.empty() && RepoStatus::fromCookieFile( cookieFile( _file ) ) == _systemStatus && loadFile() )
+      {
+        // The states were computed for the current @System content.
+        // Remember it as the baseline for incremental updates.
+        _installed.clear();
+        Repository system( sat::Pool::instance().findSystemRepo() );
+        if ( system )
+        {
+          for ( const sat::Solvable & slv : system.solvables() )
+            _installed[itemKey( slv )] = installedNames( slv );
+        }
+        _installedValid = true;
+        _dirty = false;
+      }
+      else
+        _dirty = true;	// write the file on the next save
+    }
+
+    void EstablishCache::save()
+    {
+      if ( _dirty && ! _file.empty() && ! _systemStatus.empty() )
+      {
+        saveFile();
+        _dirty = false;
+      }
+    }
+
+    EstablishCache::RepoKey EstablishCache::repoKey( sat::Solvable slv_r )
+    {
+      Repository repo( slv_r.repository() );
+      auto it = _repoKeys.find( repo.id() );
+      if ( it == _repoKeys.end() )
+        it = _repoKeys.insert( std::make_pair( repo.id(), RepoKey( IdString( repo.alias() ).id(), repo.generatedTimestamp() ) ) ).first;
+      return it->second;
+    }
+
+    void EstablishCache::beginEstablish()
+    {
+      _repoKeys.clear();
+      _computed = 0;
+
+      // Snapshot the installed packages and collect the names of changed ones.
+      std::map<ItemKey,std::vector<IdType>> installed;
+      std::vector<IdType> changed;
+      Repository system( sat::Pool::instance().findSystemRepo() );
+      if ( system )
+      {
+        for ( const sat::Solvable & slv : system.solvables() )
+        {
+          ItemKey key( itemKey( slv ) );
+          auto it = _installed.find( key );
+          if ( it != _installed.end() )
+          {
+            installed[key].swap( it->second );
+            _installed.erase( it );
+          }
+          else
+          {
+            std::vector<IdType> & names( installed[key] );
+            names = installedNames( slv );
+            changed.insert( changed.end(), names.begin(), names.end() );
+          }
+        }
+      }
+      for ( const auto & el : _installed )	// removed ones
+        changed.insert( changed.end(), el.second.begin(), el.second.end() );
+      _installed.swap( installed );
+
+      if ( ! _installedValid )
+      {
+        // No baseline: nothing cached can be trusted.
+        if ( ! _states.empty() )
+        {
+          _states.clear();
+          _dirty = true;
+        }
+        _installedValid = true;
+      }
+      else if ( ! changed.empty() )
+      {
+        sortUnique( changed );
+        unsigned dropped = 0;
+        for ( auto & repo : _states )
+        {
+          for ( auto it = repo.second.begin(); it != repo.second.end(); )
+          {
+            if ( it->second._refsAll || intersects( it->second._refs, changed ) )
+            {
+              it = repo.second.erase( it );
+              ++dropped;
+            }
+            else
+              ++it;
+          }
+        }
+        if ( dropped )
+          _dirty = true;
+        MIL << "Installed packages changed: dropped " << dropped << " established states" << endl;
+      }
+
+      for ( auto & repo : _states )
+        for ( auto & state : repo.second )
+          state.second._used = false;
+    }
+
+    bool EstablishCache::lookup( sat::Solvable slv_r, int & flag_r )
+    {
+      auto repo = _states.find( repoKey( slv_r ) );
+      if ( repo == _states.end() )
+        return false;
+      auto it = repo->second.find( itemKey( slv_r ) );
+      if ( it == repo->second.end() )
+        return false;
+      it->second._used = true;
+      flag_r = it->second._flag;
+      return true;
+    }
+
+    void EstablishCache::store( sat::Solvable slv_r, int flag_r )
+    {
+      State & state( _states[repoKey( slv_r )][itemKey( slv_r )] );
+      state._flag = flag_r;
+      state._used = true;
+      state._refs.clear();
+      state._refs.push_back( slv_r.ident().id() );
+      // An installed package may satisfy the requirements, conflict with
+      // the item or be conflicted by it; or conflict with what it provides.
+      state._refsAll = ! ( collectNames( slv_r.requires(), state._refs )
+                           && collectNames( slv_r.conflicts(), state._refs )
+                           && collectNames( slv_r.obsoletes(), state._refs )
+                           && collectNames( slv_r.provides(), state._refs ) );
+      sortUnique( state._refs );
+      ++_computed;
+      _dirty = true;
+    }
+
+    void EstablishCache::endEstablish()
+    {
+      for ( auto repo = _states.begin(); repo != _states.end(); )
+      {
+        for ( auto it = repo->second.begin(); it != repo->second.end(); )
+        {
+          if ( it->second._used )
+            ++it;
+          else
+          {
+            it = repo->second.erase( it );
+            _dirty = true;
+          }
+        }
+        if ( repo->second.empty() )
+          repo = _states.erase( repo );
+        else
+          ++repo;
+      }
+      _repoKeys.clear();
+    }
+
+    ///////////////////////////////////////////////////////////////////
+    // File format:
+    //   # comment
+    //   @ <timestamp> <repo alias>
+    //   <flag> <ident> <edition> <arch>
+    ///////////////////////////////////////////////////////////////////
+
+    bool EstablishCache::loadFile()
+    {
+      PathInfo pi( _file );
+      if ( ! pi.isFile() )
+        return false;
+
+      std::map<RepoKey,std::map<ItemKey,State>> states;
+      std::map<ItemKey,State> * repo = nullptr;
+      std::ifstream infile( _file.c_str() );
+      std::vector<std::string> words;
+      for( iostr::EachLine in( infile ); in; in.next() )
+      {
+        const std::string & l( *in );
+        if ( l.empty() || l[0] == '#' )
+          continue;
+
+        if ( l[0] == '@' )
+        {
+          // alias is the remainder of the line
+          std::string::size_type sep = l.find( ' ', 2 );
+          if ( sep == std::string::npos )
+          {
+            WAR << "Bad line " << in.lineNo() << " in " << pi << endl;
+            return false;
+          }
+          RepoKey key( IdString( l.substr( sep+1 ) ).id(), str::strtonum<Date::ValueType>( l.substr( 2, sep-2 ) ) );
+          repo = &states[key];
+          continue;
+        }
+
+        words.clear();
+        if ( str::split( l, std::back_inserter(words) ) != 4 || ! repo )
+        {
+          WAR << "Bad line " << in.lineNo() << " in " << pi << endl;
+          return false;
+        }
+        State & state( (*repo)[ItemKey( IdString( words[1] ).id(), IdString( words[2] ).id(), IdString( words[3] ).id() )] );
+        state._flag = str::strtonum<int>( words[0] );
+        state._refsAll = true;	// refs are not persisted
+      }
+      _states.swap( states );
+      MIL << "Read " << size() << " established states from " << pi << endl;
+      return true;
+    }
+
+    void EstablishCache::saveFile() const
+    {
+      filesystem::assert_dir( _file.dirname() );
+      filesystem::TmpFile tmp( filesystem::TmpFile::makeSibling( _file ) );
+      if ( ! tmp )
+      {
+        WAR << "Can't write " << _file << endl;
+        return;
+      }
+      filesystem::chmod( tmp.path(), 0644 );
+
+      std::ofstream outs( tmp.path().c_str() );
+      outs << "# " << _file.basename() << " generated " << Date::now() << endl;
+      for ( const auto & repo : _states )
+      {
+        outs << "@ " << repo.first.second << " " << IdString( repo.first.first ) << endl;
+        for ( const auto & state : repo.second )
+        {
+          outs << state.second._flag
+               << " " << IdString( std::get<0>( state.first ) )
+               << " " << IdString( std::get<1>( state.first ) )
+               << " " << IdString( std::get<2>( state.first ) ) << endl;
+        }
+      }
+      outs.close();
+
+      filesystem::unlink( cookieFile( _file ) );	// file and cookie must match
+      if ( outs.good() && filesystem::rename( tmp.path(), _file ) == 0 )
+      {
+        try
+        {
+          _systemStatus.saveToCookieFile( cookieFile( _file ) );
+          MIL << "Wrote " << size() << " established states to " << PathInfo(_file) << endl;
+        }
+        catch ( const Exception & excpt )
+        {
+          ZYPP_CAUGHT( excpt );
+          filesystem::unlink( _file );
+        }
+      }
+      else
+      {
+        ERR << "Can't write " << PathInfo(tmp.path()) << endl;
+      }
+    }
+
+    /******************************************************************
+    **
+    **	FUNCTION NAME : operator<<
+    **	FUNCTION TYPE : std::ostream &
+    */
+    std::ostream & operator<<( std::ostream & str, const EstablishCache & obj )
+    {
+      str << "EstablishCache{" << obj.size() << " states|" << obj._computed << " computed";
+      if ( ! obj._file.empty() )
+        str << "|" << obj._file;
+      return str << "}";
+    }
+
+    /////////////////////////////////////////////////////////////////
+  } // namespace pool
+  ///////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
@@ -0,0 +1,155 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/pool/EstablishCache.h
+ *
+*/
+#ifndef ZYPP_POOL_ESTABLISHCACHE_H
+#define ZYPP_POOL_ESTABLISHCACHE_H
+
+#include <iosfwd>
+#include <map>
+#include <tuple>
+#include <vector>
+
+#include <zypp/base/NonCopyable.h>
+#include <zypp/Date.h>
+#include <zypp/Pathname.h>
+#include <zypp/RepoStatus.h>
+#include <zypp/sat/Solvable.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{ /////////////////////////////////////////////////////////////////
+  class ResPool;
+
+  ///////////////////////////////////////////////////////////////////
+  namespace pool
+  { /////////////////////////////////////////////////////////////////
+
+    ///////////////////////////////////////////////////////////////////
+    /// \class EstablishCache
+    /// \brief Cache of the established states of pseudo installed items.
+    ///
+    /// Establishing the state of all Patches, Patterns, etc. is expensive
+    /// on systems with many patches. But an items state only depends on its
+    /// own dependencies and the installed packages. So a computed state is
+    /// kept (keyed by the items repo alias and timestamp and its NVRA). It
+    /// needs to be recomputed only for new items, and for items referring
+    /// to installed packages that changed since.
+    ///
+    /// Each \ref ResPool owns its cache (\see \ref forPool). If \ref setPersistent
+    /// was called, the cache can be written along with the \c @System solv file
+    /// by calling \ref save. The next process reuses it as long as the \c @System
+    /// cookie (i.e. the rpm database) did not change.
+    ///
+    /// \code
+    ///   EstablishCache & cache( EstablishCache::forPool( ResPool::instance() ) );
+    ///   cache.beginEstablish();
+    ///   for ( sat::Solvable slv : pseudoItems )
+    ///     if ( ! cache.lookup( slv, flag ) )
+    ///       cache.store( slv, compute( slv ) );
+    ///   cache.endEstablish();
+    /// \endcode
+    ///////////////////////////////////////////////////////////////////
+    class ZYPP_API EstablishCache : private base::NonCopyable
+    {
+      friend std::ostream & operator<<( std::ostream & str, const EstablishCache & obj );
+
+    public:
+      /** The cache owned by \a pool_r. */
+      static EstablishCache & forPool( const ResPool & pool_r );
+
+    public:
+      /** Keep the cache persistent in \a file_r for the installed system
+       * described by \a systemStatus_r (the \c @System cookie).
+       * If the file was written for the same \a systemStatus_r and there
+       * are no states in memory, it is loaded.
+       */
+      void setPersistent( const Pathname & file_r, const RepoStatus & systemStatus_r );
+
+      /** Number of cached states. */
+      unsigned size() const;
+
+      /** Number of states computed (not taken from the cache) in the last run. */
+      unsigned lastComputed() const
+      { return _computed; }
+
+      /** Forget everything (but the persistent file settings). */
+      void clear();
+
+      /** Write the persistent file if it is set and something changed. */
+      void save();
+
+    public:
+      /** Start a new establish run.
+       * Take a new snapshot of the installed packages and drop all states
+       * referring to packages which changed since the last run.
+       */
+      void beginEstablish();
+
+      /** Lookup the cached state of \a slv_r (\see \c solver_trivial_installable).
+       * \returns \c false if there is no valid state cached for \a slv_r.
+       */
+      bool lookup( sat::Solvable slv_r, int & flag_r );
+
+      /** Remember the state computed for \a slv_r. */
+      void store( sat::Solvable slv_r, int flag_r );
+
+      /** Finish the establish run.
+       * Drop all states not looked up or stored in this run. The persistent
+       * file is not written here, but by the next \ref save.
+       */
+      void endEstablish();
+
+    public:
+      using IdType = sat::detail::IdType;
+      /** The items repo (alias and timestamp). */
+      using RepoKey = std::pair<IdType,Date::ValueType>;
+      /** The items NVRA (ident, edition and arch). */
+      using ItemKey = std::tuple<IdType,IdType,IdType>;
+
+    private:
+      /** A cached state. */
+      struct State
+      {
+        int _flag = 0;
+        bool _used = false;
+        bool _refsAll = false;		///< depends on any installed change (or \ref _refs are unknown)
+        std::vector<IdType> _refs;	///< sorted names of relevant dependencies
+      };
+
+      RepoKey repoKey( sat::Solvable slv_r );
+
+      bool loadFile();
+      void saveFile() const;
+
+    private:
+      std::map<RepoKey,std::map<ItemKey,State>> _states;
+      std::map<ItemKey,std::vector<IdType>> _installed;	///< installed NVRA and their names (provides, conflicts, obsoletes)
+      bool _installedValid = false;
+      bool _dirty = false;
+      unsigned _computed = 0;
+
+      std::map<sat::detail::RepoIdType,RepoKey> _repoKeys;	///< per run cache
+
+      Pathname _file;
+      RepoStatus _systemStatus;
+    };
+    ///////////////////////////////////////////////////////////////////
+
+    /** \relates EstablishCache Stream output */
+    std::ostream & operator<<( std::ostream & str, const EstablishCache & obj ) ZYPP_API;
+
+    /////////////////////////////////////////////////////////////////
+  } // namespace pool
+  ///////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_POOL_ESTABLISHCACHE_H
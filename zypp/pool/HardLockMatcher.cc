@@ -0,0 +1,185 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/pool/HardLockMatcher.cc
+ *
+*/
+#include <iostream>
+#include <sstream>
+#include <set>
+#include <algorithm>
+
+#include <zypp/base/Logger.h>
+#include <zypp/base/String.h>
+#include <zypp/pool/HardLockMatcher.h>
+#include <zypp/sat/Pool.h>
+#include <zypp/Repository.h>
+
+using std::endl;
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{ /////////////////////////////////////////////////////////////////
+  ///////////////////////////////////////////////////////////////////
+  namespace pool
+  { /////////////////////////////////////////////////////////////////
+
+    namespace
+    {
+      /** The names of a plain name lock, or an empty set if \a query_r is something else.
+       * A plain name lock matches exact names of some kinds and has no other restrictions.
+       */
+      PoolQuery::StrContainer plainNameLock( const PoolQuery & query_r )
+      {
+        PoolQuery::StrContainer ret;
+        if ( ! query_r.strings().empty()
+             || query_r.attributes().size() != 1
+             || query_r.attributes().begin()->first != sat::SolvAttr::name
+             || query_r.kinds().empty()
+             || ! ( query_r.matchExact() || query_r.matchGlob() ) )
+          return ret;
+
+        const PoolQuery::StrContainer & names { query_r.attribute( sat::SolvAttr::name ) };
+        for ( const std::string & name : names )
+        {
+          // no explicit 'kind:', no glob
+          if ( name.empty() || name.find_first_of( ":*?[\\" ) != std::string::npos )
+            return ret;
+        }
+
+        // Make sure there are no other restrictions (repos, edition, status,...)
+        PoolQuery plain;
+        plain.setFlags( query_r.flags() );
+        for ( const ResKind & kind : query_r.kinds() )
+          plain.addKind( kind );
+        for ( const std::string & name : names )
+          plain.addAttribute( sat::SolvAttr::name, name );
+        if ( plain == query_r )
+          ret = names;
+        return ret;
+      }
+
+      inline std::string nocaseIdent( const std::string & kind_r, const std::string & name_r )
+      { return kind_r + ":" + str::toLower( name_r ); }
+
+      /** A deep copy (PoolQuery copies share their data). */
+      inline PoolQuery cloneQuery( const PoolQuery & query_r )
+      {
+        std::stringstream str;
+        query_r.serialize( str );
+        PoolQuery ret;
+        ret.recover( str );
+        return ret;
+      }
+    } // namespace
+
+    void HardLockMatcher::add( const PoolQuery & query_r )
+    {
+      const PoolQuery::StrContainer & names { plainNameLock( query_r ) };
+      if ( names.empty() )
+      {
+        _queries.push_back( query_r );
+        return;
+      }
+
+      for ( const ResKind & kind : query_r.kinds() )
+      {
+        for ( const std::string & name : names )
+        {
+          if ( query_r.caseSensitive() )
+            _idents.insert( sat::Solvable::SplitIdent( kind, IdString(name) ).ident() );
+          else
+            _nocaseIdents.insert( nocaseIdent( kind.asString(), name ) );
+        }
+      }
+      ++_compiled;
+    }
+
+    bool HardLockMatcher::matchIdent( sat::Solvable slv_r ) const
+    {
+      if ( ! _idents.empty() && _idents.count( slv_r.ident() ) )
+        return true;
+      if ( ! _nocaseIdents.empty() && _nocaseIdents.count( nocaseIdent( slv_r.kind().asString(), slv_r.name() ) ) )
+        return true;
+      return false;
+    }
+
+    void HardLockMatcher::matchQueries( PoolQueryResult & result_r, const std::vector<std::string> & repos_r ) const
+    {
+      for ( const PoolQuery & query : _queries )
+      {
+        if ( repos_r.empty() )
+        {
+          result_r += query;
+          continue;
+        }
+
+        if ( query.repos().empty() )
+        {
+          PoolQuery q { cloneQuery( query ) };
+          for ( const std::string & alias : repos_r )
+            q.addRepo( alias );
+          result_r += q;
+        }
+        else if ( std::any_of( repos_r.begin(), repos_r.end(), [&query]( const std::string & alias_r ) { return query.repos().count( alias_r ); } ) )
+        {
+          result_r += query;
+        }
+      }
+    }
+
+    PoolQueryResult HardLockMatcher::matchAll() const
+    {
+      PoolQueryResult ret;
+      if ( ! ( _idents.empty() && _nocaseIdents.empty() ) )
+      {
+        for ( sat::Solvable slv : sat::Pool::instance().solvables() )
+        {
+          if ( matchIdent( slv ) )
+            ret += slv;
+        }
+      }
+      matchQueries( ret, std::vector<std::string>() );
+      return ret;
+    }
+
+    PoolQueryResult HardLockMatcher::match( const std::vector<PoolItem> & items_r ) const
+    {
+      PoolQueryResult ret;
+      if ( items_r.empty() )
+        return ret;
+
+      std::set<std::string> repos;
+      for ( const PoolItem & pi : items_r )
+      {
+        if ( matchIdent( pi.satSolvable() ) )
+          ret += pi;
+        if ( ! _queries.empty() )
+          repos.insert( pi.repository().alias() );
+      }
+      if ( ! repos.empty() )
+        matchQueries( ret, std::vector<std::string>( repos.begin(), repos.end() ) );
+      return ret;
+    }
+
+    /******************************************************************
+    **
+    **	FUNCTION NAME : operator<<
+    **	FUNCTION TYPE : std::ostream &
+    */
+    std::ostream & operator<<( std::ostream & str, const HardLockMatcher & obj )
+    {
+      return str << "HardLockMatcher{" << obj.compiledSize() << " compiled|" << obj.queriesSize() << " queries}";
+    }
+
+    /////////////////////////////////////////////////////////////////
+  } // namespace pool
+  ///////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
@@ -0,0 +1,109 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/pool/HardLockMatcher.h
+ *
+*/
+#ifndef ZYPP_POOL_HARDLOCKMATCHER_H
+#define ZYPP_POOL_HARDLOCKMATCHER_H
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include <unordered_set>
+
+#include <zypp/PoolQuery.h>
+#include <zypp/PoolQueryResult.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{ /////////////////////////////////////////////////////////////////
+  ///////////////////////////////////////////////////////////////////
+  namespace pool
+  { /////////////////////////////////////////////////////////////////
+
+    ///////////////////////////////////////////////////////////////////
+    /// \class HardLockMatcher
+    /// \brief A set of lock queries compiled into one matcher.
+    ///
+    /// Most locks (e.g. <tt>zypper addlock foo</tt>) just name a package.
+    /// Evaluating each of them as \ref PoolQuery means one pass over all
+    /// solvables per lock. Those locks are compiled into a hash set of
+    /// idents (or lowercased names for case insensitive locks), so all of
+    /// them are checked in a single pass. Only the remaining queries are
+    /// evaluated as \ref PoolQuery.
+    ///
+    /// \ref match considers only the passed items, and restricts the remaining
+    /// queries to their repos. This allows to apply the locks to items added
+    /// to the pool without evaluating them for the whole pool again.
+    ///////////////////////////////////////////////////////////////////
+    class ZYPP_API HardLockMatcher
+    {
+      friend std::ostream & operator<<( std::ostream & str, const HardLockMatcher & obj );
+
+    public:
+      /** Default ctor: no locks. */
+      HardLockMatcher()
+      {}
+
+      /** Ctor compiling a range of \ref PoolQuery. */
+      template <class TIterator>
+      HardLockMatcher( TIterator begin_r, TIterator end_r )
+      { for ( ; begin_r != end_r; ++begin_r ) add( *begin_r ); }
+
+    public:
+      /** Add a lock query. */
+      void add( const PoolQuery & query_r );
+
+      /** Whether there are no locks. */
+      bool empty() const
+      { return _idents.empty() && _nocaseIdents.empty() && _queries.empty(); }
+
+      /** Number of locks compiled into the ident sets. */
+      unsigned compiledSize() const
+      { return _compiled; }
+
+      /** Number of locks evaluated as \ref PoolQuery. */
+      unsigned queriesSize() const
+      { return _queries.size(); }
+
+    public:
+      /** All solvables in the pool matched by a lock. */
+      PoolQueryResult matchAll() const;
+
+      /** The solvables in \a items_r matched by a lock.
+       * The result may also contain solvables not in \a items_r, but from
+       * the same repos.
+       */
+      PoolQueryResult match( const std::vector<PoolItem> & items_r ) const;
+
+    private:
+      /** Whether \a slv_r is matched by one of the compiled locks. */
+      bool matchIdent( sat::Solvable slv_r ) const;
+
+      /** Add the results of the remaining queries (restricted to \a repos_r unless empty). */
+      void matchQueries( PoolQueryResult & result_r, const std::vector<std::string> & repos_r ) const;
+
+    private:
+      std::unordered_set<IdString> _idents;		///< case sensitive exact ident locks
+      std::unordered_set<std::string> _nocaseIdents;	///< case insensitive exact locks: lowercased "kind:name"
+      std::vector<PoolQuery> _queries;			///< everything else
+      unsigned _compiled = 0;
+    };
+    ///////////////////////////////////////////////////////////////////
+
+    /** \relates HardLockMatcher Stream output */
+    std::ostream & operator<<( std::ostream & str, const HardLockMatcher & obj ) ZYPP_API;
+
+    /////////////////////////////////////////////////////////////////
+  } // namespace pool
+  ///////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_POOL_HARDLOCKMATCHER_H
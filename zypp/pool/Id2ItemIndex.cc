@@ -0,0 +1,171 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/pool/Id2ItemIndex.cc
+ *
+*/
+#include <iostream>
+#include <algorithm>
+
+#include <zypp/pool/Id2ItemIndex.h>
+#include <zypp/ResKind.h>
+
+using std::endl;
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{ /////////////////////////////////////////////////////////////////
+  ///////////////////////////////////////////////////////////////////
+  namespace pool
+  { /////////////////////////////////////////////////////////////////
+
+    namespace
+    {
+      /** Sort order of the index: by key, then by solvable id. */
+      struct KeyedItem
+      {
+        Id2ItemIndex::IdType _key;
+        PoolItem _item;
+
+        bool operator<( const KeyedItem & rhs ) const
+        { return _key < rhs._key || ( _key == rhs._key && _item.id() < rhs._item.id() ); }
+      };
+
+      inline std::vector<KeyedItem> makeKeyed( Id2ItemIndex::ItemContainerT items_r )
+      {
+        std::vector<KeyedItem> ret;
+        ret.reserve( items_r.size() );
+        for ( PoolItem & pi : items_r )
+        {
+          if ( pi )
+            ret.push_back( KeyedItem { Id2ItemIndex::key( pi.satSolvable() ), std::move(pi) } );
+        }
+        std::sort( ret.begin(), ret.end() );
+        return ret;
+      }
+    } // namespace
+
+    Id2ItemIndex::IdType Id2ItemIndex::key( sat::Solvable slv_r )
+    { return slv_r.isKind( ResKind::srcpackage ) ? -slv_r.ident().id() : slv_r.ident().id(); }
+
+    std::pair<Id2ItemIndex::const_iterator,Id2ItemIndex::const_iterator> Id2ItemIndex::equal_range( IdType key_r ) const
+    {
+      GroupContainerT::const_iterator it( std::lower_bound( _groups.begin(), _groups.end(), Group( key_r, 0 ),
+                                                            []( const Group & lhs, const Group & rhs ) { return lhs.first < rhs.first; } ) );
+      if ( it == _groups.end() || it->first != key_r )
+        return std::make_pair( _items.end(), _items.end() );
+      size_type idx = it - _groups.begin();
+      return std::make_pair( identBegin( idx ), identEnd( idx ) );
+    }
+
+    void Id2ItemIndex::clear()
+    {
+      _items.clear();
+      _keys.clear();
+      _groups.clear();
+    }
+
+    void Id2ItemIndex::rebuild( const ItemContainerT & store_r )
+    {
+      clear();
+      insert( store_r );
+    }
+
+    void Id2ItemIndex::insert( ItemContainerT added_r, std::vector<IdType> * touched_r )
+    {
+      std::vector<KeyedItem> added( makeKeyed( std::move(added_r) ) );
+      if ( added.empty() )
+        return;
+
+      if ( touched_r )
+      {
+        for ( const KeyedItem & ki : added )
+          touched_r->push_back( ki._key );
+      }
+
+      ItemContainerT items;
+      std::vector<IdType> keys;
+      items.reserve( _items.size() + added.size() );
+      keys.reserve( _items.size() + added.size() );
+
+      // merge both sorted sequences
+      size_type lhs = 0;
+      auto rhs = added.begin();
+      while ( lhs < _items.size() || rhs != added.end() )
+      {
+        if ( rhs == added.end()
+             || ( lhs < _items.size() && ( _keys[lhs] < rhs->_key || ( _keys[lhs] == rhs->_key && _items[lhs].id() < rhs->_item.id() ) ) ) )
+        {
+          keys.push_back( _keys[lhs] );
+          items.push_back( std::move(_items[lhs]) );
+          ++lhs;
+        }
+        else
+        {
+          keys.push_back( rhs->_key );
+          items.push_back( std::move(rhs->_item) );
+          ++rhs;
+        }
+      }
+      _items.swap( items );
+      _keys.swap( keys );
+      buildGroups();
+    }
+
+    void Id2ItemIndex::eraseStale( const ItemContainerT & store_r, std::vector<IdType> * touched_r )
+    {
+      size_type out = 0;
+      for ( size_type in = 0; in < _items.size(); ++in )
+      {
+        const PoolItem & pi( _items[in] );
+        sat::detail::SolvableIdType id = pi.id();
+        if ( id < store_r.size() && store_r[id].sameItem( pi ) )
+        {
+          if ( out != in )
+          {
+            _items[out] = std::move(_items[in]);
+            _keys[out] = _keys[in];
+          }
+          ++out;
+        }
+        else if ( touched_r )
+          touched_r->push_back( _keys[in] );
+      }
+      if ( out == _items.size() )
+        return;	// nothing removed
+      _items.resize( out );
+      _keys.resize( out );
+      buildGroups();
+    }
+
+    void Id2ItemIndex::buildGroups()
+    {
+      _groups.clear();
+      for ( size_type idx = 0; idx < _keys.size(); ++idx )
+      {
+        if ( ! idx || _keys[idx] != _keys[idx-1] )
+          _groups.push_back( Group( _keys[idx], idx ) );
+      }
+    }
+
+    /******************************************************************
+    **
+    **	FUNCTION NAME : operator<<
+    **	FUNCTION TYPE : std::ostream &
+    */
+    std::ostream & operator<<( std::ostream & str, const Id2ItemIndex & obj )
+    {
+      return str << "Id2ItemIndex{" << obj.size() << " items|" << obj.identsSize() << " idents}";
+    }
+
+    /////////////////////////////////////////////////////////////////
+  } // namespace pool
+  ///////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
@@ -0,0 +1,132 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/pool/Id2ItemIndex.h
+ *
+*/
+#ifndef ZYPP_POOL_ID2ITEMINDEX_H
+#define ZYPP_POOL_ID2ITEMINDEX_H
+
+#include <iosfwd>
+#include <utility>
+#include <vector>
+
+#include <zypp/PoolItem.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{ /////////////////////////////////////////////////////////////////
+  ///////////////////////////////////////////////////////////////////
+  namespace pool
+  { /////////////////////////////////////////////////////////////////
+
+    ///////////////////////////////////////////////////////////////////
+    /// \class Id2ItemIndex
+    /// \brief Flat index of \ref PoolItem by ident (\see \ref ByIdent).
+    ///
+    /// All items are stored in one contiguous vector, sorted by ident and
+    /// solvable id, so all items of one ident form a contiguous range. A
+    /// sorted vector of <tt>(ident, begin)</tt> pairs locates the range.
+    ///
+    /// The index can be updated incrementally. Added items are merged in,
+    /// items of removed solvables are dropped. Both is done in linear time
+    /// without rehashing or per item allocations.
+    ///////////////////////////////////////////////////////////////////
+    class Id2ItemIndex
+    {
+      friend std::ostream & operator<<( std::ostream & str, const Id2ItemIndex & obj );
+
+    public:
+      using IdType = sat::detail::IdType;
+      using ItemContainerT = std::vector<PoolItem>;
+      using const_iterator = ItemContainerT::const_iterator;
+      using size_type = ItemContainerT::size_type;
+
+      /** An idents range in \ref items: <tt>(ident, begin)</tt>. */
+      using Group = std::pair<IdType,size_type>;
+      using GroupContainerT = std::vector<Group>;
+
+    public:
+      /** The ident used as key for \a slv_r (negative for \c srcpackage). */
+      static IdType key( sat::Solvable slv_r );
+
+    public:
+      bool empty() const
+      { return _items.empty(); }
+
+      /** Number of items. */
+      size_type size() const
+      { return _items.size(); }
+
+      /** Iterate all items (ordered by ident). */
+      const_iterator begin() const
+      { return _items.begin(); }
+
+      const_iterator end() const
+      { return _items.end(); }
+
+      /** The range of items with ident \a key_r. */
+      std::pair<const_iterator,const_iterator> equal_range( IdType key_r ) const;
+
+    public:
+      /** Number of distinct idents. */
+      size_type identsSize() const
+      { return _groups.size(); }
+
+      /** The ident of group \a idx_r. */
+      IdType ident( size_type idx_r ) const
+      { return _groups[idx_r].first; }
+
+      /** Begin of group \a idx_r items. */
+      const_iterator identBegin( size_type idx_r ) const
+      { return _items.begin() + _groups[idx_r].second; }
+
+      /** End of group \a idx_r items. */
+      const_iterator identEnd( size_type idx_r ) const
+      { return idx_r+1 < _groups.size() ? _items.begin() + _groups[idx_r+1].second : _items.end(); }
+
+    public:
+      /** Clear the index. */
+      void clear();
+
+      /** Rebuild the index from scratch using all valid items in \a store_r. */
+      void rebuild( const ItemContainerT & store_r );
+
+      /** Merge \a added_r into the index. Invalid items are ignored.
+       * If \a touched_r is not \c nullptr, the keys of all added items
+       * are appended (unsorted, maybe duplicate).
+       */
+      void insert( ItemContainerT added_r, std::vector<IdType> * touched_r = nullptr );
+
+      /** Remove all items no longer present in \a store_r (items of removed solvables).
+       * If \a touched_r is not \c nullptr, the keys of all removed items
+       * are appended (unsorted, maybe duplicate).
+       */
+      void eraseStale( const ItemContainerT & store_r, std::vector<IdType> * touched_r = nullptr );
+
+    private:
+      /** Recompute \ref _groups from \ref _keys. */
+      void buildGroups();
+
+    private:
+      ItemContainerT _items;		///< all items sorted by (key,id)
+      std::vector<IdType> _keys;	///< key of each item in \ref _items
+      GroupContainerT _groups;		///< per key the begin of its range in \ref _items
+    };
+    ///////////////////////////////////////////////////////////////////
+
+    /** \relates Id2ItemIndex Stream output */
+    std::ostream & operator<<( std::ostream & str, const Id2ItemIndex & obj );
+
+    /////////////////////////////////////////////////////////////////
+  } // namespace pool
+  ///////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_POOL_ID2ITEMINDEX_H
@@ -52,6 +52,14 @@ namespace zypp
     PoolImpl::~PoolImpl()
     {}
 
+    ///////////////////////////////////////////////////////////////////
+    //
+    //	METHOD NAME : EstablishCache::forPool
+    //	METHOD TYPE : EstablishCache &
+    //
+    EstablishCache & EstablishCache::forPool( const ResPool & pool_r )
+    { return PoolImpl::establishCache( pool_r ); }
+
     /////////////////////////////////////////////////////////////////
   } // namespace pool
   ///////////////////////////////////////////////////////////////////
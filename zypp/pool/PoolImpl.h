@@ -21,6 +21,9 @@
 #include <zypp-core/Globals.h>
 
 #include <zypp/pool/PoolTraits.h>
+#include <zypp/pool/Id2ItemIndex.h>
+#include <zypp/pool/HardLockMatcher.h>
+#include <zypp/pool/EstablishCache.h>
 #include <zypp/ResPoolProxy.h>
 #include <zypp/PoolQueryResult.h>
 
@@ -108,7 +111,7 @@ namespace zypp
   ///////////////////////////////////////////////////////////////////
   namespace solver {
     namespace detail {
-      void establish( sat::Queue & pseudoItems_r, sat::Queue & pseudoFlags_r );	// in solver/detail/SATResolver.cc
+      void establish( sat::Queue & pseudoItems_r, sat::Queue & pseudoFlags_r, pool::EstablishCache & cache_r );	// in solver/detail/SATResolver.cc
     }
   }
   ///////////////////////////////////////////////////////////////////
@@ -117,8 +120,8 @@ namespace zypp
   class ResPool::EstablishedStates::Impl
   {
   public:
-    Impl()
-    { solver::detail::establish( _pseudoItems, _pseudoFlags ); }
+    Impl( pool::EstablishCache & cache_r )
+    { solver::detail::establish( _pseudoItems, _pseudoFlags, cache_r ); }
 
     /** Return all pseudo installed items whose current state differs from their initial one. */
     ResPool::EstablishedStates::ChangedPseudoInstalled changedPseudoInstalled() const
@@ -174,7 +177,7 @@ namespace zypp
         using ContainerT = PoolTraits::ItemContainerT;
         using size_type = PoolTraits::size_type;
         using const_iterator = PoolTraits::const_iterator;
-        using Id2ItemT = PoolTraits::Id2ItemT;
+        using Id2ItemT = Id2ItemIndex;
 
         using repository_iterator = PoolTraits::repository_iterator;
 
@@ -242,12 +245,31 @@ namespace zypp
         //
         ///////////////////////////////////////////////////////////////////
       public:
+        /** The ResPoolProxy.
+         * If the pool content changed just by adding or removing repos, the
+         * existing proxy is patched (only the Selectables of idents whose items
+         * changed are updated, created or removed). Unchanged Selectable::Ptr
+         * are preserved. Any other change (\ref sat::Pool::serialNonRepo, the
+         * priority of a known repo) or reused solvable ids rebuild the proxy
+         * from scratch.
+         */
         ResPoolProxy proxy( ResPool self ) const
         {
           checkSerial();
+          id2item();	// may drop the proxy or remember the idents to update
+          if ( _poolProxyNonRepoWatcher.remember( satpool().serialNonRepo() ) )
+            _poolProxy.reset();
           if ( !_poolProxy )
           {
             _poolProxy.reset( new ResPoolProxy( std::move(self), *this ) );
+            _poolProxyTouched.clear();
+            _poolProxyWatcher.remember( serial() );
+          }
+          else if ( _poolProxyWatcher.remember( serial() ) )
+          {
+            if ( ! _poolProxy->updateIdents( *this, std::move(_poolProxyTouched) ) )
+              _poolProxy.reset( new ResPoolProxy( std::move(self), *this ) );
+            _poolProxyTouched.clear();
           }
           return *_poolProxy;
         }
@@ -260,6 +282,14 @@ namespace zypp
         ResPool::EstablishedStates establishedStates() const
         { store(); return ResPool::EstablishedStates( _establishedStates ); }
 
+        /** The cache used to compute the \ref establishedStates. */
+        EstablishCache & establishCache() const
+        { return _establishCache; }
+
+        /** \ref establishCache of \a pool_r (\see \ref EstablishCache::forPool). */
+        static EstablishCache & establishCache( const ResPool & pool_r )
+        { return pool_r._pimpl->establishCache(); }
+
       public:
         /** Forward list of Repositories that contribute ResObjects from \ref sat::Pool */
         size_type knownRepositoriesSize() const
@@ -284,18 +314,27 @@ namespace zypp
         const HardLockQueries & hardLockQueries() const
         { return _hardLockQueries; }
 
-        void reapplyHardLocks() const
+        /** Apply the hard locks to the \a added_r items (or to all items if \c nullptr). */
+        void reapplyHardLocks( const std::vector<PoolItem> * added_r = nullptr ) const
         {
           // It is assumed that reapplyHardLocks is called after new
           // items were added to the pool, but the _hardLockQueries
           // did not change since. Action is to be performed only on
           // those items that gained the bit in the UserLockQueryField.
-          MIL << "Re-apply " << _hardLockQueries.size() << " HardLockQueries" << endl;
-          PoolQueryResult locked;
-          for_( it, _hardLockQueries.begin(), _hardLockQueries.end() )
+          // As a lock matching an item does not depend on other items,
+          // it's sufficient to look at the added ones.
+          if ( _hardLockMatcher.empty() )
+            return;
+          MIL << "Re-apply " << _hardLockQueries.size() << " HardLockQueries " << _hardLockMatcher << endl;
+          if ( added_r )
           {
-            locked += *it;
+            PoolQueryResult locked { _hardLockMatcher.match( *added_r ) };
+            MIL << "HardLockQueries match " << locked.size() << " Solvables (" << added_r->size() << " added)." << endl;
+            for ( const PoolItem & pi : *added_r )
+              resstatus::UserLockQueryManip::reapplyLock( pi.status(), locked.contains( pi ) );
+            return;
           }
+          PoolQueryResult locked { _hardLockMatcher.matchAll() };
           MIL << "HardLockQueries match " << locked.size() << " Solvables." << endl;
           for_( it, begin(), end() )
           {
@@ -309,12 +348,9 @@ namespace zypp
         {
           MIL << "Apply " << newLocks_r.size() << " HardLockQueries" << endl;
           _hardLockQueries = newLocks_r;
+          _hardLockMatcher = HardLockMatcher( _hardLockQueries.begin(), _hardLockQueries.end() );
           // now adjust the pool status
-          PoolQueryResult locked;
-          for_( it, _hardLockQueries.begin(), _hardLockQueries.end() )
-          {
-            locked += *it;
-          }
+          PoolQueryResult locked { _hardLockMatcher.matchAll() };
           MIL << "HardLockQueries match " << locked.size() << " Solvables." << endl;
           for_( it, begin(), end() )
           {
@@ -374,8 +410,11 @@ namespace zypp
           {
             sat::Pool pool( satpool() );
             bool addedItems = false;
+            std::vector<PoolItem> addedItemsList;	// for reapplyHardLocks (unless reusedIDs)
             bool reusedIDs = _watcherIDs.remember( pool.serialIDs() );
             std::list<PoolItem> addedProducts;
+            if ( reusedIDs )
+              _id2itemRebuild = true;	// all items are new
 
             _store.resize( pool.capacity() );
 
@@ -389,6 +428,7 @@ namespace zypp
                 {
                   // the PoolItem got invalidated (e.g unloaded repo)
                   pi = PoolItem();
+                  _id2itemStale = true;
                 }
                 else if ( reusedIDs || (s && ! pi) )
                 {
@@ -399,6 +439,13 @@ namespace zypp
                     addedProducts.push_back( pi );
                   if ( !addedItems )
                     addedItems = true;
+                  // remember for incremental id2item update
+                  if ( ! reusedIDs )
+                  {
+                    _id2itemAdded.push_back( pi );
+                    if ( ! _hardLockMatcher.empty() )
+                      addedItemsList.push_back( pi );
+                  }
                 }
               }
             }
@@ -418,37 +465,69 @@ namespace zypp
             // .... we must reapply those query based hard locks.
             if ( addedItems )
             {
-              reapplyHardLocks();
+              reapplyHardLocks( reusedIDs ? nullptr : &addedItemsList );
             }
 
             // Compute the initial status of Patches etc.
             if ( !_establishedStates )
-              _establishedStates.reset( new EstablishedStatesImpl );
+              _establishedStates.reset( new EstablishedStatesImpl( _establishCache ) );
           }
           return _store;
         }
 
+        /** The ident index.
+         * After repos were added or removed, the index is updated incrementally
+         * (new items are merged in, items of removed solvables are dropped).
+         * It is rebuilt from scratch only if the solvable ids were reused.
+         */
         const Id2ItemT & id2item () const
         {
           checkSerial();
           if ( _id2itemDirty )
           {
             store();
-            _id2item = Id2ItemT( size() );
-            for_( it, begin(), end() )
+            if ( _id2itemRebuild )
+            {
+              _id2item.rebuild( _store );
+              _id2itemRebuild = false;
+              _poolProxy.reset();	// all items are new
+              _poolProxyTouched.clear();
+            }
+            else
             {
-              const sat::Solvable &s = (*it)->satSolvable();
-              sat::detail::IdType id = s.ident().id();
-              if ( s.isKind( ResKind::srcpackage ) )
-                id = -id;
-              _id2item.insert( std::make_pair( id, *it ) );
+              std::vector<Id2ItemT::IdType> * touched = _poolProxy ? &_poolProxyTouched : nullptr;
+              if ( _id2itemStale )
+                _id2item.eraseStale( _store, touched );
+              if ( ! _id2itemAdded.empty() )
+                _id2item.insert( std::move(_id2itemAdded), touched );
             }
+            _id2itemAdded.clear();
+            _id2itemStale = false;
             //INT << _id2item << endl;
             _id2itemDirty = false;
+            _id2itemMap.clear();
           }
           return _id2item;
         }
 
+        /** The ident index as legacy \ref PoolTraits::Id2ItemT multimap (\see \ref ResPool::id2item).
+         * Built on demand from \ref id2item, only if it is explicitly asked for.
+         */
+        const PoolTraits::Id2ItemT & id2itemMap() const
+        {
+          const Id2ItemT & index( id2item() );
+          if ( _id2itemMap.empty() && ! index.empty() )
+          {
+            _id2itemMap.reserve( index.size() );
+            for ( Id2ItemT::size_type idx = 0; idx < index.identsSize(); ++idx )
+            {
+              for_( it, index.identBegin( idx ), index.identEnd( idx ) )
+                _id2itemMap.insert( std::make_pair( index.ident( idx ), *it ) );
+            }
+          }
+          return _id2itemMap;
+        }
+
         ///////////////////////////////////////////////////////////////////
         //
         ///////////////////////////////////////////////////////////////////
@@ -464,8 +543,6 @@ namespace zypp
         {
           _storeDirty = true;
           _id2itemDirty = true;
-          _id2item.clear();
-          _poolProxy.reset();
           _establishedStates.reset();
         }
 
@@ -478,14 +555,24 @@ namespace zypp
         mutable DefaultIntegral<bool,true>    _storeDirty;
         mutable Id2ItemT		      _id2item;
         mutable DefaultIntegral<bool,true>    _id2itemDirty;
+        mutable DefaultIntegral<bool,true>    _id2itemRebuild;	///< rebuild _id2item from scratch
+        mutable DefaultIntegral<bool,false>   _id2itemStale;	///< _id2item may contain items of removed solvables
+        mutable ContainerT                    _id2itemAdded;	///< items added since _id2item was updated
+        mutable PoolTraits::Id2ItemT          _id2itemMap;	///< _id2item for the public API (built on demand)
 
       private:
         mutable shared_ptr<ResPoolProxy>      _poolProxy;
+        mutable std::vector<Id2ItemT::IdType> _poolProxyTouched;	///< idents to update in _poolProxy
+        SerialNumberWatcher                   _poolProxyWatcher;
+        SerialNumberWatcher                   _poolProxyNonRepoWatcher;	///< rebuild _poolProxy on any change but adding or removing repos
         mutable shared_ptr<EstablishedStatesImpl> _establishedStates;
+        mutable EstablishCache                _establishCache;
 
       private:
         /** Set of queries that define hardlocks. */
         HardLockQueries                       _hardLockQueries;
+        /** The \ref _hardLockQueries compiled. */
+        HardLockMatcher                       _hardLockMatcher;
     };
     ///////////////////////////////////////////////////////////////////
 
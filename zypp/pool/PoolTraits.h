@@ -73,10 +73,10 @@ namespace zypp
       using const_iterator = filter_iterator<ByPoolItem, ItemContainerT::const_iterator>;
       using size_type = ItemContainerT::size_type;
 
-      /** ident index */
+      /** ident index (\see \ref Id2ItemIndex) */
+      using byIdent_iterator = ItemContainerT::const_iterator;
+      /** legacy ident index */
       using Id2ItemT = std::unordered_multimap<sat::detail::IdType, PoolItem>;
-      using Id2ItemValueSelector = P_Select2nd<Id2ItemT::value_type>;
-      using byIdent_iterator = transform_iterator<Id2ItemValueSelector, Id2ItemT::const_iterator>;
 
       /** list of known Repositories */
       using repository_iterator = sat::Pool::RepositoryIterator;
@@ -0,0 +1,209 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/sat/EvrKeyCache.cc
+ *
+*/
+#include <cstring>
+#include <iostream>
+
+#include <zypp/sat/EvrKeyCache.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{ /////////////////////////////////////////////////////////////////
+  ///////////////////////////////////////////////////////////////////
+  namespace sat
+  { /////////////////////////////////////////////////////////////////
+
+    namespace
+    {
+      // The key is a sequence of tokens. The token tags are chosen so that
+      // comparing keys bytewise yields the order of libsolvs solv_vercmp_rpm:
+      //   '~' < end of segment < '^' < alpha < numeric
+      enum : char
+      {
+        TokTilde	= 0x01,
+        TokEnd		= 0x02,
+        TokCaret	= 0x03,
+        TokAlpha	= 0x04,	// followed by the letters and a '\0'
+        TokNum		= 0x05,	// followed by the length and the digits (w/o leading zeros)
+      };
+
+      inline bool isDigit( char ch_r )
+      { return ch_r >= '0' && ch_r <= '9'; }
+
+      inline bool isAlpha( char ch_r )
+      { return ( ch_r >= 'a' && ch_r <= 'z' ) || ( ch_r >= 'A' && ch_r <= 'Z' ); }
+
+      /** Numbers compare by length, then by digits. */
+      void appendNum( std::string & key_r, const char * begin_r, const char * end_r )
+      {
+        while ( end_r - begin_r > 1 && *begin_r == '0' )
+          ++begin_r;
+        size_t len = end_r - begin_r;
+        key_r += TokNum;
+        if ( len < 0xff )
+          key_r += char(len);
+        else
+        {
+          key_r += char(0xff);
+          for ( int shift = 24; shift >= 0; shift -= 8 )
+            key_r += char( ( len >> shift ) & 0xff );
+        }
+        key_r.append( begin_r, end_r );
+      }
+
+      /** Tokenize a version or release string (\see solv_vercmp_rpm). */
+      void appendSegment( std::string & key_r, const char * begin_r, const char * end_r )
+      {
+        const char * s = begin_r;
+        while ( true )
+        {
+          while ( s < end_r && ! isDigit( *s ) && ! isAlpha( *s ) && *s != '~' && *s != '^' )
+            ++s;	// separator
+          if ( s == end_r )
+            break;
+
+          if ( *s == '~' )
+          {
+            key_r += TokTilde;
+            ++s;
+          }
+          else if ( *s == '^' )
+          {
+            key_r += TokCaret;
+            ++s;
+          }
+          else if ( isDigit( *s ) )
+          {
+            const char * b = s;
+            while ( s < end_r && isDigit( *s ) )
+              ++s;
+            appendNum( key_r, b, s );
+          }
+          else
+          {
+            const char * b = s;
+            while ( s < end_r && isAlpha( *s ) )
+              ++s;
+            key_r += TokAlpha;
+            key_r.append( b, s );
+            key_r += '\0';
+          }
+        }
+        key_r += TokEnd;
+      }
+    } // namespace
+
+    EvrKeyCache & EvrKeyCache::instance()
+    {
+      static thread_local EvrKeyCache _instance;
+      return _instance;
+    }
+
+    std::string EvrKeyCache::makeKey( const char * evr_r )
+    {
+      std::string ret;
+      if ( ! evr_r )
+        evr_r = "";
+
+      // epoch (a missing epoch is 0)
+      const char * s = evr_r;
+      const char * sep = s;
+      for ( ; isDigit( *sep ); ++sep )
+        ; // NOOP
+      if ( sep != s && *sep == ':' )
+      {
+        appendNum( ret, s, sep );
+        s = sep+1;
+      }
+      else
+      {
+        static const char zero[] = "0";
+        appendNum( ret, zero, zero+1 );
+      }
+
+      // version, then release (an edition with release is greater)
+      const char * end = s + ::strlen( s );
+      sep = ::strrchr( s, '-' );
+      appendSegment( ret, s, sep ? sep : end );
+      if ( sep )
+      {
+        ret += '\1';
+        appendSegment( ret, sep+1, end );
+      }
+      else
+        ret += '\0';
+
+      return ret;
+    }
+
+    void EvrKeyCache::lookup( IdString evr_r )
+    {
+      IdString::IdType id = evr_r.id();
+      if ( unsigned(id) >= _index.size() )
+        _index.resize( std::max( size_t(id) + 1, _index.size() * 2 ) );
+
+      std::pair<unsigned,unsigned> & entry( _index[id] );
+      if ( entry.first )
+        return;
+
+      std::string key( makeKey( evr_r.c_str() ) );
+      entry.first = _buffer.size() + 1;
+      entry.second = key.size();
+      _buffer += key;
+      ++_size;
+    }
+
+    int EvrKeyCache::compare( IdString lhs_r, IdString rhs_r )
+    {
+      if ( lhs_r == rhs_r )
+        return 0;
+
+      lookup( lhs_r );
+      lookup( rhs_r );
+      // (_buffer may be reallocated by lookup)
+      const std::pair<unsigned,unsigned> & lhs( _index[lhs_r.id()] );
+      const std::pair<unsigned,unsigned> & rhs( _index[rhs_r.id()] );
+      int res = ::memcmp( _buffer.data() + lhs.first - 1, _buffer.data() + rhs.first - 1, std::min( lhs.second, rhs.second ) );
+      if ( ! res )
+        return lhs.second == rhs.second ? 0 : ( lhs.second < rhs.second ? -1 : 1 );
+      return res < 0 ? -1 : 1;
+    }
+
+    std::string EvrKeyCache::key( IdString evr_r )
+    {
+      lookup( evr_r );
+      const std::pair<unsigned,unsigned> & entry( _index[evr_r.id()] );
+      return _buffer.substr( entry.first - 1, entry.second );
+    }
+
+    void EvrKeyCache::clear()
+    {
+      _buffer.clear();
+      _index.clear();
+      _size = 0;
+    }
+
+    /******************************************************************
+    **
+    **	FUNCTION NAME : operator<<
+    **	FUNCTION TYPE : std::ostream &
+    */
+    std::ostream & operator<<( std::ostream & str, const EvrKeyCache & obj )
+    {
+      return str << "EvrKeyCache{" << obj.size() << " keys|" << obj._buffer.size() << " bytes}";
+    }
+
+    /////////////////////////////////////////////////////////////////
+  } // namespace sat
+  ///////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
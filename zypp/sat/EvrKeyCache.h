@@ -0,0 +1,124 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/sat/EvrKeyCache.h
+ *
+*/
+#ifndef ZYPP_SAT_EVRKEYCACHE_H
+#define ZYPP_SAT_EVRKEYCACHE_H
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include <zypp/base/NonCopyable.h>
+#include <zypp/IdString.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{ /////////////////////////////////////////////////////////////////
+  ///////////////////////////////////////////////////////////////////
+  namespace sat
+  { /////////////////////////////////////////////////////////////////
+
+    ///////////////////////////////////////////////////////////////////
+    /// \class EvrKeyCache
+    /// \brief Cache of precomputed, comparable keys for \c [epoch:]version[-release] strings.
+    ///
+    /// Comparing two edition strings (\c pool_evrcmp_str) splits both into
+    /// numeric and alpha segments each time it is called. Sorting n editions
+    /// does this O(n log n) times for the same strings.
+    ///
+    /// The cache tokenizes each \ref IdString just once into a byte string,
+    /// built such that comparing two keys by \c memcmp yields the same order
+    /// as the rpm version comparison (\c EVRCMP_COMPARE). The keys are stored
+    /// in one flat buffer, located via a vector indexed by the \ref IdString id.
+    ///
+    /// \note Only the rpm comparison is implemented. It's the callers job to
+    /// use it only if the pool uses rpm semantics (\see \ref Edition).
+    ///
+    /// \note The cache is not locked. Each thread uses its own \ref instance.
+    /// The keys are per \ref IdString id, so they are valid in any thread.
+    ///////////////////////////////////////////////////////////////////
+    class ZYPP_API EvrKeyCache : private base::NonCopyable
+    {
+      friend std::ostream & operator<<( std::ostream & str, const EvrKeyCache & obj );
+
+    public:
+      /** The calling threads cache. */
+      static EvrKeyCache & instance();
+
+    public:
+      /** Compare two edition strings: <tt>-1, 0, 1</tt> like \c pool_evrcmp_str (\c Null like an empty string). */
+      int compare( IdString lhs_r, IdString rhs_r );
+
+      /** \ref compare as LESS functor (e.g. to sort a container of \ref Edition). */
+      struct Less
+      {
+        template <class TEdition>
+        bool operator()( const TEdition & lhs, const TEdition & rhs ) const
+        { return EvrKeyCache::instance().compare( IdString(lhs), IdString(rhs) ) < 0; }
+      };
+
+      /** The comparable key of \a evr_r. */
+      std::string key( IdString evr_r );
+
+      /** Number of cached keys. */
+      unsigned size() const
+      { return _size; }
+
+      /** Forget all keys. */
+      void clear();
+
+    public:
+      /** Compute the comparable key of \a evr_r (not using the cache). */
+      static std::string makeKey( const char * evr_r );
+
+    private:
+      /** Make sure the key for \a evr_r is cached in \ref _index. */
+      void lookup( IdString evr_r );
+
+    private:
+      std::string _buffer;			///< all keys concatenated
+      std::vector<std::pair<unsigned,unsigned>> _index;	///< per IdString id: key offset + 1 and length (offset \c 0 if not cached)
+      unsigned _size = 0;
+    };
+    ///////////////////////////////////////////////////////////////////
+
+    /** \relates EvrKeyCache Stream output */
+    std::ostream & operator<<( std::ostream & str, const EvrKeyCache & obj ) ZYPP_API;
+
+    /** \relates EvrKeyCache Stable sort the range <tt>[begin_r,end_r)</tt> by ascending edition.
+     * \a editionOf_r returns the edition (as \ref Edition or \ref IdString) of an element.
+     * Each distinct edition string is tokenized at most once.
+     * \code
+     *   sortByEdition( items.begin(), items.end(), []( const PoolItem & pi ) { return pi.edition(); } );
+     * \endcode
+     */
+    template <class TIterator, class TEditionOf>
+    void sortByEdition( TIterator begin_r, TIterator end_r, TEditionOf editionOf_r )
+    {
+      EvrKeyCache & cache( EvrKeyCache::instance() );
+      std::stable_sort( begin_r, end_r, [&]( const auto & lhs, const auto & rhs ) {
+        return cache.compare( IdString(editionOf_r( lhs )), IdString(editionOf_r( rhs )) ) < 0;
+      } );
+    }
+
+    /** \relates EvrKeyCache Stable sort a range of \ref Edition (or \ref IdString) ascending. */
+    template <class TIterator>
+    void sortByEdition( TIterator begin_r, TIterator end_r )
+    { std::stable_sort( begin_r, end_r, EvrKeyCache::Less() ); }
+
+    /////////////////////////////////////////////////////////////////
+  } // namespace sat
+  ///////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_SAT_EVRKEYCACHE_H
@@ -662,6 +662,12 @@ namespace zypp
       return std::string();
     }
 
+    std::string_view LookupAttr::iterator::asStringView() const
+    {
+      const char * ret( c_str() );
+      return ret ? std::string_view( ret ) : std::string_view();
+    }
+
     IdString LookupAttr::iterator::idStr() const
     {
       if ( _dip )
@@ -14,6 +14,7 @@
 
 #include <iosfwd>
 #include <utility>
+#include <string_view>
 
 #include <zypp/base/PtrTypes.h>
 #include <zypp-core/base/DefaultIntegral>
@@ -512,6 +513,11 @@ namespace zypp
          * some appropriate string representation.
         */
         std::string asString() const;
+        /** \overload Non-copying view of the string types (\see \ref c_str).
+         * Returns an empty view for non-string types.
+         * \see \ref Solvable::lookupStrAttributeView for the lifetime of the view.
+        */
+        std::string_view asStringView() const;
 
         /** As \ref IdStr.
          * This is only done for poolized string types. Large strings like
@@ -592,6 +598,7 @@ namespace zypp
     template<> inline bool         LookupAttr::iterator::asType<bool>()         const { return asBool(); }
     template<> inline const char * LookupAttr::iterator::asType<const char *>() const { return c_str(); }
     template<> inline std::string  LookupAttr::iterator::asType<std::string>()  const { return asString(); }
+    template<> inline std::string_view LookupAttr::iterator::asType<std::string_view>() const { return asStringView(); }
     template<> inline IdString     LookupAttr::iterator::asType<IdString>()     const { return idStr(); }
     template<>        CheckSum     LookupAttr::iterator::asType<CheckSum>()     const;
 
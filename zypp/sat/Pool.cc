@@ -58,6 +58,9 @@ namespace zypp
     const SerialNumber & Pool::serialIDs() const
     { return myPool().serialIDs(); }
 
+    const SerialNumber & Pool::serialNonRepo() const
+    { return myPool().serialNonRepo(); }
+
     void Pool::prepare() const
     { return myPool().prepare(); }
 
@@ -140,6 +143,13 @@ namespace zypp
       return q;
     }
 
+    Queue Pool::whatDependsOn( Dep which_r, const Capability & cap_r ) const
+    {
+      Queue q;
+      myPool().whatDependsOn( which_r, cap_r, q );
+      return q;
+    }
+
     Repository Pool::reposInsert( const std::string & alias_r )
     {
       Repository ret( reposFind( alias_r ) );
@@ -15,6 +15,7 @@
 #include <iosfwd>
 
 #include <zypp/Pathname.h>
+#include <zypp/Dep.h>
 
 #include <zypp/sat/detail/PoolMember.h>
 #include <zypp/Repository.h>
@@ -69,6 +70,11 @@ namespace zypp
         /** Serial number changing whenever resusePoolIDs==true was used. ResPool must also invalidate its PoolItems! */
         const SerialNumber & serialIDs() const;
 
+        /** Serial number changing whenever the content changes other than by adding or removing repos and solvables
+         * or setting a repos \ref RepoInfo (e.g. the multiversion spec).
+         */
+        const SerialNumber & serialNonRepo() const;
+
         /** Update housekeeping data if necessary (e.g. whatprovides). */
         void prepare() const;
 
@@ -196,6 +202,26 @@ namespace zypp
         Queue whatMatchesSolvable ( const SolvAttr &attr, const Solvable &solv ) const;
         Queue whatContainsDep ( const SolvAttr &attr, const Capability &cap ) const;
 
+        /** All \ref Solvable mentioning \a cap_r in their \a which_r dependencies.
+         * Unlike \ref whatMatchesDep this does not scan the pool, but uses a
+         * reverse dependency index which is built on demand once the pool content
+         * changed. The lookup is by Id, not by matching capabilities: A plain
+         * \c foo finds all solvables stating \c foo or <tt>foo OP EDITION</tt>, a
+         * versioned <tt>foo >= 1.0</tt> finds only those stating exactly this.
+         *
+         * Supported are \c Dep::REQUIRES, \c Dep::RECOMMENDS, \c Dep::SUPPLEMENTS
+         * and \c Dep::CONFLICTS. Other \ref Dep return an empty \ref Queue.
+         */
+        Queue whatDependsOn( Dep which_r, const Capability & cap_r ) const;
+
+        /** \ref whatDependsOn \c Dep::REQUIRES */
+        Queue whatRequires( const Capability & cap_r ) const
+        { return whatDependsOn( Dep::REQUIRES, cap_r ); }
+
+        /** \ref whatDependsOn \c Dep::RECOMMENDS */
+        Queue whatRecommends( const Capability & cap_r ) const
+        { return whatDependsOn( Dep::RECOMMENDS, cap_r ); }
+
       public:
         /** \name Requested locales. */
         //@{
@@ -128,33 +128,55 @@ namespace zypp
       return noSolvable;
     }
 
-    std::string Solvable::lookupStrAttribute( const SolvAttr & attr ) const
+    namespace
     {
-      NO_SOLVABLE_RETURN( std::string() );
-      const char * s = ::solvable_lookup_str( _solvable, attr.id() );
-      return s ? s : std::string();
-    }
+      /** The string attribute as stored in the pool or \c nullptr. */
+      inline const char * lookupStr( detail::CSolvable * solvable_r, const SolvAttr & attr )
+      { return ::solvable_lookup_str( solvable_r, attr.id() ); }
 
-    std::string Solvable::lookupStrAttribute( const SolvAttr & attr, const Locale & lang_r ) const
-    {
-      NO_SOLVABLE_RETURN( std::string() );
-      const char * s = 0;
-      if ( !lang_r )
-      {
-        s = ::solvable_lookup_str_poollang( _solvable, attr.id() );
-      }
-      else
+      /** \overload Trying to look up a translated string attribute. */
+      inline const char * lookupStr( detail::CSolvable * solvable_r, const SolvAttr & attr, const Locale & lang_r )
       {
+        if ( !lang_r )
+          return ::solvable_lookup_str_poollang( solvable_r, attr.id() );
+
         for ( Locale l( lang_r ); l; l = l.fallback() )
         {
-          if ( (s = ::solvable_lookup_str_lang( _solvable, attr.id(), l.c_str(), 0 )) )
+          if ( const char * s = ::solvable_lookup_str_lang( solvable_r, attr.id(), l.c_str(), 0 ) )
             return s;
         }
         // here: no matching locale, so use default
-        s = ::solvable_lookup_str_lang( _solvable, attr.id(), 0, 0 );
+        return ::solvable_lookup_str_lang( solvable_r, attr.id(), 0, 0 );
       }
+    } // namespace
+
+    std::string Solvable::lookupStrAttribute( const SolvAttr & attr ) const
+    {
+      NO_SOLVABLE_RETURN( std::string() );
+      const char * s = lookupStr( _solvable, attr );
+      return s ? s : std::string();
+    }
+
+    std::string Solvable::lookupStrAttribute( const SolvAttr & attr, const Locale & lang_r ) const
+    {
+      NO_SOLVABLE_RETURN( std::string() );
+      const char * s = lookupStr( _solvable, attr, lang_r );
       return s ? s : std::string();
-   }
+    }
+
+    std::string_view Solvable::lookupStrAttributeView( const SolvAttr & attr ) const
+    {
+      NO_SOLVABLE_RETURN( std::string_view() );
+      const char * s = lookupStr( _solvable, attr );
+      return s ? std::string_view( s ) : std::string_view();
+    }
+
+    std::string_view Solvable::lookupStrAttributeView( const SolvAttr & attr, const Locale & lang_r ) const
+    {
+      NO_SOLVABLE_RETURN( std::string_view() );
+      const char * s = lookupStr( _solvable, attr, lang_r );
+      return s ? std::string_view( s ) : std::string_view();
+    }
 
     unsigned long long Solvable::lookupNumAttribute( const SolvAttr & attr ) const
     {
@@ -408,7 +430,7 @@ namespace zypp
       if ( isKind<Package>() )
         return myPool().isRetracted( *this );
       if ( isKind<Patch>() )
-        return lookupStrAttribute( SolvAttr::updateStatus ) == "retracted";
+        return lookupStrAttributeView( SolvAttr::updateStatus ) == "retracted";
       return false;
     }
 
@@ -729,6 +751,24 @@ namespace zypp
       return lookupStrAttribute( SolvAttr::description, lang_r );
     }
 
+    std::string_view Solvable::distributionView() const
+    {
+      NO_SOLVABLE_RETURN( std::string_view() );
+      return lookupStrAttributeView( SolvAttr::distribution );
+    }
+
+    std::string_view Solvable::summaryView( const Locale & lang_r ) const
+    {
+      NO_SOLVABLE_RETURN( std::string_view() );
+      return lookupStrAttributeView( SolvAttr::summary, lang_r );
+    }
+
+    std::string_view Solvable::descriptionView( const Locale & lang_r ) const
+    {
+      NO_SOLVABLE_RETURN( std::string_view() );
+      return lookupStrAttributeView( SolvAttr::description, lang_r );
+    }
+
     std::string	Solvable::insnotify( const Locale & lang_r ) const
     {
       NO_SOLVABLE_RETURN( std::string() );
@@ -13,6 +13,7 @@
 #define ZYPP_SAT_SOLVABLE_H
 
 #include <iosfwd>
+#include <string_view>
 
 #include <zypp/sat/detail/PoolMember.h>
 #include <zypp/sat/SolvAttr.h>
@@ -330,6 +331,15 @@ namespace zypp
       /** Long (multiline) text describing the solvable (opt. translated). */
       std::string description( const Locale & lang_r = Locale() ) const;
 
+      /** \name Non-copying variants of the text accessors.
+       * \see \ref lookupStrAttributeView for the lifetime of the returned view.
+       */
+      //@{
+      std::string_view distributionView() const;
+      std::string_view summaryView( const Locale & lang_r = Locale() ) const;
+      std::string_view descriptionView( const Locale & lang_r = Locale() ) const;
+      //@}
+
       /** UI hint text when selecting the solvable for install (opt. translated). */
       std::string insnotify( const Locale & lang_r = Locale() ) const;
       /** UI hint text when selecting the solvable for uninstall (opt. translated).*/
@@ -389,6 +399,18 @@ namespace zypp
        */
       std::string lookupStrAttribute( const SolvAttr & attr, const Locale & lang_r ) const;
 
+      /** Like \ref lookupStrAttribute but returning a view into the pools data rather than a copy.
+       *
+       * The view refers to memory owned by libsolv. It is valid only until the next
+       * attribute lookup (of any solvable), as paged data may be reused for it. Use it
+       * to print or compare the value, or create a \c std::string if you need to keep it.
+       *
+       * Returns an empty view if the attribute does not exist.
+       */
+      std::string_view lookupStrAttributeView( const SolvAttr & attr ) const;
+      /** \overload Trying to look up a translated string attribute (\see \ref lookupStrAttribute). */
+      std::string_view lookupStrAttributeView( const SolvAttr & attr, const Locale & lang_r ) const;
+
       /**
        * returns the numeric attribute value for \ref attr
        * or 0 if it does not exists.
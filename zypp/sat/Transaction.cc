@@ -161,12 +161,30 @@ namespace zypp
 #endif
           if ( !_ordered )
           {
-            ::transaction_order( _trans, 0 );
+            // remember the cycles for orderCycles
+            ::transaction_order( _trans, SOLVER_TRANSACTION_KEEP_ORDERCYCLES );
             _ordered = true;
           }
           return true;
         }
 
+        std::vector<std::vector<Solvable>> orderCycles() const
+        {
+          std::vector<std::vector<Solvable>> ret;
+          if ( !_ordered )
+            return ret;
+
+          Queue cycleids;
+          ::transaction_order_get_cycleids( _trans, cycleids, SOLVER_ORDERCYCLE_HARMLESS );
+          Queue cycle;
+          for ( detail::IdType cid : cycleids )
+          {
+            ::transaction_order_get_cycle( _trans, cid, cycle );
+            ret.push_back( std::vector<Solvable>( cycle.begin(), cycle.end() ) );
+          }
+          return ret;
+        }
+
         bool empty() const
         { return( _trans->steps.count == 0 ); }
 
@@ -330,6 +348,9 @@ namespace zypp
     bool Transaction::order()
     { return _pimpl->order(); }
 
+    std::vector<std::vector<Solvable>> Transaction::orderCycles() const
+    { return _pimpl->orderCycles(); }
+
     bool Transaction::empty() const
     { return _pimpl->empty(); }
 
@@ -12,6 +12,7 @@
 #define ZYPP_SAT_TRANSACTION_H
 
 #include <iosfwd>
+#include <vector>
 
 #include <zypp/base/PtrTypes.h>
 #include <zypp/base/Flags.h>
@@ -106,6 +107,12 @@ namespace zypp
          */
         bool order();
 
+        /** The install order cycles found by \ref order.
+         * Each cycle lists solvables which depend on each other, so
+         * they should be committed together. Empty if not ordered.
+         */
+        std::vector<std::vector<Solvable>> orderCycles() const;
+
         /** Whether the transaction contains any steps. */
         bool empty() const;
 
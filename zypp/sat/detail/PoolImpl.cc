@@ -10,6 +10,7 @@
  *
 */
 #include <iostream>
+#include <algorithm>
 #include <fstream>
 #include <boost/mpl/int.hpp>
 
@@ -18,6 +19,7 @@
 #include <zypp/base/Gettext.h>
 #include <zypp/base/Exception.h>
 #include <zypp/base/Measure.h>
+#include <zypp/base/ParallelFor.h>
 #include <zypp-core/fs/WatchFile>
 #include <zypp-core/parser/Sysconfig>
 #include <zypp/base/IOStream.h>
@@ -245,6 +247,12 @@ namespace zypp
      ///////////////////////////////////////////////////////////////////
 
       void PoolImpl::setDirty( const char * a1, const char * a2, const char * a3 )
+      {
+        repoSetDirty( a1, a2, a3 );
+        _serialNonRepo.setDirty();    // may affect all solvables
+      }
+
+      void PoolImpl::repoSetDirty( const char * a1, const char * a2, const char * a3 )
       {
         if ( _retractedSpec.empty() ) {
           // lazy init IdString types we can not use inside the ctor
@@ -291,6 +299,7 @@ namespace zypp
           else if ( a2 ) MIL << a1 << " " << a2 << endl;
           else           MIL << a1 << endl;
         }
+        _depSerial.setDirty();
         ::pool_freewhatprovides( _pool );
       }
 
@@ -327,7 +336,7 @@ namespace zypp
 
       CRepo * PoolImpl::_createRepo( const std::string & name_r )
       {
-        setDirty(__FUNCTION__, name_r.c_str() );
+        repoSetDirty(__FUNCTION__, name_r.c_str() );
         CRepo * ret = ::repo_create( _pool, name_r.c_str() );
         if ( ret && name_r == systemRepoAlias() )
           ::pool_set_installed( _pool, ret );
@@ -336,7 +345,7 @@ namespace zypp
 
       void PoolImpl::_deleteRepo( CRepo * repo_r )
       {
-        setDirty(__FUNCTION__, repo_r->name );
+        repoSetDirty(__FUNCTION__, repo_r->name );
         if ( isSystemRepo( repo_r ) )
           _autoinstalled.clear();
         eraseRepoInfo( repo_r );
@@ -352,7 +361,7 @@ namespace zypp
 
       int PoolImpl::_addSolv( CRepo * repo_r, FILE * file_r )
       {
-        setDirty(__FUNCTION__, repo_r->name );
+        repoSetDirty(__FUNCTION__, repo_r->name );
         int ret = ::repo_add_solv( repo_r, file_r, 0 );
         if ( ret == 0 )
           _postRepoAdd( repo_r );
@@ -361,7 +370,7 @@ namespace zypp
 
       int PoolImpl::_addHelix( CRepo * repo_r, FILE * file_r )
       {
-        setDirty(__FUNCTION__, repo_r->name );
+        repoSetDirty(__FUNCTION__, repo_r->name );
         int ret = ::repo_add_helix( repo_r, file_r, 0 );
         if ( ret == 0 )
           _postRepoAdd( repo_r );
@@ -370,7 +379,7 @@ namespace zypp
 
       int PoolImpl::_addTesttags(CRepo *repo_r, FILE *file_r)
       {
-        setDirty(__FUNCTION__, repo_r->name );
+        repoSetDirty(__FUNCTION__, repo_r->name );
         int ret = ::testcase_add_testtags( repo_r, file_r, 0 );
         if ( ret == 0 )
           _postRepoAdd( repo_r );
@@ -423,7 +432,7 @@ namespace zypp
 
       detail::SolvableIdType PoolImpl::_addSolvables( CRepo * repo_r, unsigned count_r )
       {
-        setDirty(__FUNCTION__, repo_r->name );
+        repoSetDirty(__FUNCTION__, repo_r->name );
         return ::repo_add_solvable_block( repo_r, count_r );
       }
 
@@ -451,8 +460,10 @@ namespace zypp
             dirty = true;
           }
 
+          // A new repos priority is set after its solvables were added, so
+          // ResPoolProxy watches the priorities of the repos it knows itself.
           if ( dirty )
-            setDirty(__FUNCTION__, info_r.alias().c_str() );
+            repoSetDirty(__FUNCTION__, info_r.alias().c_str() );
         }
         _repoinfos[id_r] = info_r;
       }
@@ -614,6 +625,130 @@ namespace zypp
 
       ///////////////////////////////////////////////////////////////////
 
+      namespace
+      {
+        /** Dependency kinds covered by the reverse dependency index. */
+        enum ReverseDepsKind { RD_REQUIRES, RD_RECOMMENDS, RD_SUPPLEMENTS, RD_CONFLICTS, RD_SIZE };
+
+        inline int reverseDepsKind( Dep which_r )
+        {
+          switch ( which_r.inSwitch() )
+          {
+            case Dep::REQUIRES_e:	return RD_REQUIRES;
+            case Dep::RECOMMENDS_e:	return RD_RECOMMENDS;
+            case Dep::SUPPLEMENTS_e:	return RD_SUPPLEMENTS;
+            case Dep::CONFLICTS_e:	return RD_CONFLICTS;
+            default:
+              break;
+          }
+          return -1;
+        }
+      } // namespace
+
+      void PoolImpl::reverseDepsInit() const
+      {
+        typedef std::pair<IdType,SolvableIdType> Entry;
+        typedef std::array<std::vector<Entry>,RD_SIZE> Entries;
+
+        // Collecting the entries just reads the solvables dependency arrays,
+        // so it's safe to do it in parallel on distinct solvable id ranges.
+        const CPool * pool = _pool;
+        size_t nsolvables = _pool->nsolvables;
+        std::vector<Entries> parts( base::parallelJobs( nsolvables ) );
+
+        base::parallelFor( nsolvables, parts.size(), [&]( unsigned chunk_r, size_t begin_r, size_t end_r ) {
+          Entries & entries( parts[chunk_r] );
+          for ( size_t id = std::max( begin_r, size_t(systemSolvableId+1) ); id < end_r; ++id )
+          {
+            const CSolvable & slv( pool->solvables[id] );
+            if ( ! slv.repo )
+              continue;
+
+            auto collect = [&]( ::Offset offs_r, std::vector<Entry> & entries_r ) {
+              if ( ! offs_r )
+                return;
+              for ( const IdType * dp = slv.repo->idarraydata + offs_r; *dp; ++dp )
+              {
+                if ( isDepMarkerId( *dp ) )
+                  continue;
+                entries_r.push_back( Entry( *dp, id ) );
+                if ( ISRELDEP( *dp ) )
+                {
+                  // Plain 'name OP edition' is also indexed by name.
+                  const ::Reldep * rd = GETRELDEP( pool, *dp );
+                  if ( rd->flags > 0 && rd->flags < 8 && ! ISRELDEP( rd->name ) )
+                    entries_r.push_back( Entry( rd->name, id ) );
+                }
+              }
+            };
+            collect( slv.requires,	entries[RD_REQUIRES] );
+            collect( slv.recommends,	entries[RD_RECOMMENDS] );
+            collect( slv.supplements,	entries[RD_SUPPLEMENTS] );
+            collect( slv.conflicts,	entries[RD_CONFLICTS] );
+          }
+        } );
+
+        // Build the per kind CSR indices (in parallel too).
+        _reverseDepsPtr.reset( new ReverseDeps );
+        base::parallelFor( RD_SIZE, RD_SIZE, [&]( unsigned, size_t begin_r, size_t end_r ) {
+          for ( size_t kind = begin_r; kind < end_r; ++kind )
+          {
+            std::vector<Entry> all;
+            {
+              size_t total = 0;
+              for ( const Entries & part : parts )
+                total += part[kind].size();
+              all.reserve( total );
+            }
+            for ( Entries & part : parts )
+            {
+              all.insert( all.end(), part[kind].begin(), part[kind].end() );
+              std::vector<Entry>().swap( part[kind] );
+            }
+            std::sort( all.begin(), all.end() );
+            all.erase( std::unique( all.begin(), all.end() ), all.end() );
+
+            ReverseDepsIndex & index( (*_reverseDepsPtr)[kind] );
+            index._solvables.reserve( all.size() );
+            for ( size_t begin = 0; begin < all.size(); )
+            {
+              size_t end = begin;
+              for ( ; end < all.size() && all[end].first == all[begin].first; ++end )
+                index._solvables.push_back( all[end].second );
+              index._ranges.emplace( all[begin].first, std::make_pair( unsigned(begin), unsigned(end) ) );
+              begin = end;
+            }
+          }
+        } );
+
+        MIL << "Reverse dependency index: "
+            << (*_reverseDepsPtr)[RD_REQUIRES]._solvables.size() << " requires, "
+            << (*_reverseDepsPtr)[RD_RECOMMENDS]._solvables.size() << " recommends, "
+            << (*_reverseDepsPtr)[RD_SUPPLEMENTS]._solvables.size() << " supplements, "
+            << (*_reverseDepsPtr)[RD_CONFLICTS]._solvables.size() << " conflicts" << endl;
+      }
+
+      bool PoolImpl::whatDependsOn( Dep which_r, Capability cap_r, Queue & ret_r ) const
+      {
+        int kind = reverseDepsKind( which_r );
+        if ( kind < 0 )
+          return false;
+
+        if ( _reverseDepsWatcher.remember( _serial ) || ! _reverseDepsPtr )
+          reverseDepsInit();
+
+        const ReverseDepsIndex & index( (*_reverseDepsPtr)[kind] );
+        auto it = index._ranges.find( cap_r.id() );
+        if ( it != index._ranges.end() )
+        {
+          for ( unsigned i = it->second.first; i < it->second.second; ++i )
+            ret_r.push( index._solvables[i] );
+        }
+        return true;
+      }
+
+      ///////////////////////////////////////////////////////////////////
+
       void PoolImpl::multiversionListInit() const
       {
         _multiversionListPtr.reset( new MultiversionList );
@@ -638,7 +773,10 @@ namespace zypp
       }
 
       void PoolImpl::multiversionSpecChanged()
-      { _multiversionListPtr.reset(); }
+      {
+        _multiversionListPtr.reset();
+        _serialNonRepo.setDirty();
+      }
 
       const PoolImpl::MultiversionList & PoolImpl::multiversionList() const
       {
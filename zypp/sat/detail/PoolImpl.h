@@ -21,6 +21,9 @@ extern "C"
 #include <solv/pool_parserpmrichdep.h>
 }
 #include <iosfwd>
+#include <array>
+#include <unordered_map>
+#include <vector>
 
 #include <zypp/base/Hash.h>
 #include <zypp/base/NonCopyable.h>
@@ -32,6 +35,7 @@ extern "C"
 #include <zypp/RepoInfo.h>
 #include <zypp/Locale.h>
 #include <zypp/Capability.h>
+#include <zypp/Dep.h>
 #include <zypp/IdString.h>
 
 ///////////////////////////////////////////////////////////////////
@@ -72,6 +76,16 @@ namespace zypp
           const SerialNumber & serialIDs() const
           { return _serialIDs; }
 
+          /** Serial number changing whenever the content changes other than by adding or removing repos and solvables
+           * or setting a repos \ref RepoInfo (e.g. the multiversion spec). Such changes may affect all solvables.
+           */
+          const SerialNumber & serialNonRepo() const
+          { return _serialNonRepo; }
+
+          /** Serial number changing whenever dependency/namespace related indices are invalidated (\ref depSetDirty). */
+          const SerialNumber & depSerial() const
+          { return _depSerial; }
+
           /** Update housekeeping data (e.g. whatprovides).
            * \todo actually requires a watcher.
            */
@@ -83,6 +97,11 @@ namespace zypp
            */
           void setDirty( const char * a1 = 0, const char * a2 = 0, const char * a3 = 0 );
 
+          /** \ref setDirty if the content changed just by adding or removing repos and solvables.
+           * \ref serialNonRepo remains unchanged.
+           */
+          void repoSetDirty( const char * a1 = 0, const char * a2 = 0, const char * a3 = 0 );
+
           /** Invalidate locale related housekeeping data.
            */
           void localeSetDirty( const char * a1 = 0, const char * a2 = 0, const char * a3 = 0 );
@@ -351,6 +370,26 @@ namespace zypp
           /** accessor for etc/sysconfig/storage reading file on demand */
           const std::set<std::string> & requiredFilesystems() const;
 
+        public:
+          /** \name Reverse dependency index. */
+          //@{
+          /** Solvables mentioning an Id in one kind of dependencies.
+           * \c _ranges maps the Id to its <tt>[begin,end)</tt> range in \c _solvables.
+           */
+          struct ReverseDepsIndex
+          {
+            std::unordered_map<IdType,std::pair<unsigned,unsigned>> _ranges;
+            std::vector<SolvableIdType> _solvables;
+          };
+          /** One index per kind: requires, recommends, supplements, conflicts. */
+          typedef std::array<ReverseDepsIndex,4> ReverseDeps;
+
+          /** Append all solvables mentioning \a cap_r in their \a which_r dependencies to \a ret_r.
+           * \return \c false if \a which_r is not indexed.
+           */
+          bool whatDependsOn( Dep which_r, Capability cap_r, Queue & ret_r ) const;
+          //@}
+
         private:
           /** sat-pool. */
           CPool * _pool;
@@ -358,6 +397,10 @@ namespace zypp
           SerialNumber _serial;
           /** Serial number of IDs - changes whenever resusePoolIDs==true - ResPool must also invalidate its PoolItems! */
           SerialNumber _serialIDs;
+          /** Serial number of changes other than adding or removing repos and solvables. */
+          SerialNumber _serialNonRepo;
+          /** Serial number of dependency/namespace related indices - changes with each \ref depSetDirty. */
+          SerialNumber _depSerial;
           /** Watch serial number. */
           SerialNumberWatcher _watcher;
           /** Additional \ref RepoInfo. */
@@ -386,6 +429,11 @@ namespace zypp
 
           /** filesystems mentioned in /etc/sysconfig/storage */
           mutable scoped_ptr<std::set<std::string> > _requiredFilesystemsPtr;
+
+          /** Reverse dependency index and the serial it was built for. */
+          void reverseDepsInit() const;
+          mutable scoped_ptr<ReverseDeps> _reverseDepsPtr;
+          SerialNumberWatcher _reverseDepsWatcher;
       };
       ///////////////////////////////////////////////////////////////////
 
@@ -20,5 +20,7 @@
 #include <zypp/ResolverNamespace.h>
 
 #include <zypp/ResolverProblem.h>
+#include <zypp/ResolverProfile.h>
+#include <zypp/ResolverWhatIf.h>
 
 #endif // ZYPP_SOLVER_TYPES_H
@@ -25,6 +25,7 @@
 
 #include <zypp/base/LogTools.h>
 #include <zypp/base/Algorithm.h>
+#include <zypp/AutoDispose.h>
 
 #include <zypp/solver/detail/Resolver.h>
 #include <zypp/solver/detail/Testcase.h>
@@ -314,6 +315,17 @@ void Resolver::solverInit()
         }
     }
 
+    solverInitModeFlags();
+
+    // Resetting additional solver information
+    _isInstalledBy.clear();
+    _installs.clear();
+    _satifiedByInstalled.clear();
+    _installedSatisfied.clear();
+}
+
+void Resolver::solverInitModeFlags()
+{
     // update solver mode flags
     _satResolver->setDistupgrade		(_upgradeMode);
     _satResolver->setUpdatesystem		(_updateMode);
@@ -327,12 +339,6 @@ void Resolver::solverInit()
       // (Will disable weakremover processing in SATResolver)
       // _satResolver->setRemoveOrphaned( ... );
     }
-
-    // Resetting additional solver information
-    _isInstalledBy.clear();
-    _installs.clear();
-    _satifiedByInstalled.clear();
-    _installedSatisfied.clear();
 }
 
 bool Resolver::verifySystem()
@@ -367,6 +373,26 @@ void Resolver::doUpdate()
   return _satResolver->doUpdate();
 }
 
+ResolverWhatIfResultList Resolver::whatIf( const ResolverWhatIfRequestList & requests_r )
+{
+  MIL << "Resolver::whatIf()" << endl;
+  // Like solverInit, but the SATResolvers mode flags are restored afterwards.
+  bool distupgrade = _satResolver->distupgrade();
+  bool updatesystem = _satResolver->updatesystem();
+  bool fixsystem = _satResolver->fixsystem();
+  bool solveSrcPackages = _satResolver->solveSrcPackages();
+  bool ignorealreadyrecommended = _satResolver->ignorealreadyrecommended();
+  OnScopeExit restoreFlags( [&]() {
+    _satResolver->setDistupgrade( distupgrade );
+    _satResolver->setUpdatesystem( updatesystem );
+    _satResolver->setFixsystem( fixsystem );
+    _satResolver->setSolveSrcPackages( solveSrcPackages );
+    _satResolver->setIgnorealreadyrecommended( ignorealreadyrecommended );
+  } );
+  solverInitModeFlags();
+  return _satResolver->whatIf( requests_r, _extra_requires, _extra_conflicts, _addWeak, _upgradeRepos );
+}
+
 bool Resolver::resolveQueue( solver::detail::SolverQueueItemList & queue )
 {
     solverInit();
@@ -408,6 +434,7 @@ bool Resolver::resolveQueue( solver::detail::SolverQueueItemList & queue )
 
 sat::Transaction Resolver::getTransaction()
 {
+  ResolverProfile::Timer timer( _satResolver->profile().transaction );
   // FIXME: That's an ugly way of pushing autoInstalled into the transaction.
   sat::Transaction ret( sat::Transaction::loadFromPool );
   ret.autoInstalled( _satResolver->autoInstalled() );
@@ -418,6 +445,9 @@ sat::Transaction Resolver::getTransaction()
 //----------------------------------------------------------------------------
 // Getting more information about the solve results
 
+const ResolverProfile & Resolver::profile() const
+{ return _satResolver->profile(); }
+
 ResolverProblemList Resolver::problems() const
 {
   MIL << "Resolver::problems()" << endl;
@@ -433,6 +463,12 @@ void Resolver::applySolutions( const ProblemSolutionList & solutions )
   }
 }
 
+ProblemSolutionEvaluationList Resolver::evaluateSolutions( const ProblemSolutionList & solutions ) const
+{
+  MIL << "Resolver::evaluateSolutions()" << endl;
+  return _satResolver->evaluateSolutions( solutions );
+}
+
 bool Resolver::applySolution( const ProblemSolution & solution )
 {
   bool ret = true;
@@ -124,6 +124,7 @@ class ZYPP_API_DEPTESTOMATIC Resolver : private base::NonCopyable
     bool checkUnmaintainedItems ();
 
     void solverInit();
+    void solverInitModeFlags();
 
   public:
 
@@ -174,6 +175,7 @@ class ZYPP_API_DEPTESTOMATIC Resolver : private base::NonCopyable
 
     bool verifySystem();
     bool resolvePool();
+    ResolverWhatIfResultList whatIf( const ResolverWhatIfRequestList & requests_r );
     bool resolveQueue( SolverQueueItemList & queue );
     void doUpdate();
 
@@ -228,10 +230,14 @@ class ZYPP_API_DEPTESTOMATIC Resolver : private base::NonCopyable
 
     void applySolutions( const ProblemSolutionList & solutions );
     bool applySolution( const ProblemSolution & solution );
+    ProblemSolutionEvaluationList evaluateSolutions( const ProblemSolutionList & solutions ) const;
 
     // Return the Transaction computed by the last solver run.
     sat::Transaction getTransaction();
 
+    // Timings and statistics of the last solver run.
+    const ResolverProfile & profile() const;
+
     // reset all SOLVER transaction in pool
     void undo();
 
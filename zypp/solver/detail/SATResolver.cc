@@ -36,11 +36,13 @@ extern "C"
 #include <zypp/base/Algorithm.h>
 
 #include <zypp/ZConfig.h>
+#include <zypp/VendorAttr.h>
 #include <zypp/Product.h>
 #include <zypp/AutoDispose.h>
 #include <zypp/sat/WhatProvides.h>
 #include <zypp/sat/WhatObsoletes.h>
 #include <zypp/sat/detail/PoolImpl.h>
+#include <zypp/pool/EstablishCache.h>
 
 #include <zypp/solver/detail/Resolver.h>
 #include <zypp/solver/detail/SATResolver.h>
@@ -53,6 +55,8 @@ extern "C"
 #include <zypp/solver/detail/SolutionAction.h>
 #include <zypp/solver/detail/SolverQueueItem.h>
 
+#include <algorithm>
+#include <functional>
 #include <utility>
 using std::endl;
 
@@ -94,6 +98,83 @@ namespace zypp
           }
         }
 
+        /** Helper collecting the solvables to install and the installed solvables to remove
+         * decided by the last run of \a satSolver_r.
+         */
+        inline void collectSolverDecisions( sat::detail::CSolver & satSolver_r,
+                                            std::vector<sat::Solvable> & installs_r,
+                                            std::vector<sat::Solvable> & removes_r )
+        {
+          sat::SolvableQueue decisionq;
+          ::solver_get_decisionqueue( &satSolver_r, decisionq );
+          for ( sat::detail::IdType id : decisionq )
+          {
+            if ( id < 0 )
+              continue;
+            sat::Solvable slv { (sat::detail::SolvableIdType)id };
+            if ( slv && ! slv.isSystem() )
+              installs_r.push_back( slv );
+          }
+          Repository systemRepo( sat::Pool::instance().findSystemRepo() ); // don't create if it does not exist
+          if ( systemRepo )
+          {
+            for ( const sat::Solvable & slv : systemRepo.solvables() )
+            {
+              if ( ::solver_get_decisionlevel( &satSolver_r, slv.id() ) <= 0 )
+                removes_r.push_back( slv );
+            }
+          }
+        }
+
+        /** The leading members of libsolv's \c Solver which are declared only if \c LIBSOLV_INTERNAL is defined.
+         * libsolv does not install all headers needed to compile with \c LIBSOLV_INTERNAL, but the internal
+         * members just follow the public ones. We need \c nrules, the end of the solvers rules.
+         */
+        struct CSolverInternals
+        {
+          sat::detail::CSolver _public;
+          ::Repo * installed;
+          ::Rule * rules;
+          Id nrules;
+        };
+
+        /** Helper filling the solver statistics of \a profile_r from the last run of \a satSolver_r. */
+        inline void collectProfileStats( sat::detail::CSolver & satSolver_r, const sat::detail::CQueue & jobQueue_r, ResolverProfile & profile_r )
+        {
+          profile_r.jobCount = jobQueue_r.count / 2;
+          profile_r.problemCount = ::solver_problem_count( &satSolver_r );
+
+          sat::SolvableQueue decisionq;
+          ::solver_get_decisionqueue( &satSolver_r, decisionq );
+          profile_r.decisions = decisionq.size();
+
+          // Rules are numbered 1..nrules-1, each rule class occupying a range.
+          profile_r.rules.clear();
+          const Id nrules = reinterpret_cast<const CSolverInternals &>( satSolver_r ).nrules;
+          for ( Id rid = 1; rid < nrules; ++rid )
+          {
+            const char * name = nullptr;
+            switch ( ::solver_ruleclass( &satSolver_r, rid ) )
+            {
+              case SOLVER_RULE_UNKNOWN:		continue;	// unused rule id between the ranges
+              case SOLVER_RULE_PKG:		name = "pkg";		break;
+              case SOLVER_RULE_UPDATE:		name = "update";	break;
+              case SOLVER_RULE_FEATURE:		name = "feature";	break;
+              case SOLVER_RULE_JOB:		name = "job";		break;
+              case SOLVER_RULE_DISTUPGRADE:	name = "distupgrade";	break;
+              case SOLVER_RULE_INFARCH:		name = "infarch";	break;
+              case SOLVER_RULE_CHOICE:		name = "choice";	break;
+              case SOLVER_RULE_LEARNT:		name = "learnt";	break;
+              case SOLVER_RULE_BEST:		name = "best";		break;
+              case SOLVER_RULE_YUMOBS:		name = "yumobs";	break;
+              case SOLVER_RULE_RECOMMENDS:	name = "recommends";	break;
+              case SOLVER_RULE_BLACK:		name = "black";		break;
+              default:				name = "other";		break;
+            }
+            ++profile_r.rules[name];
+          }
+        }
+
         /** Helper collecting pseudo installed items from the pool.
          * \todo: pseudoItems are cachable as long as pool content does not change
          */
@@ -185,30 +266,57 @@ int relaxedVendorCheck( sat::detail::CPool *pool, Solvable *solvable1, Solvable
  * An empty solver run (no jobs) just to compute the initial status
  * of pseudo installed items (patches).
  */
-void establish( sat::Queue & pseudoItems_r, sat::Queue & pseudoFlags_r )
+void establish( sat::Queue & pseudoItems_r, sat::Queue & pseudoFlags_r, pool::EstablishCache & cache_r )
 {
   pseudoItems_r = collectPseudoInstalled( ResPool::instance() );
   if ( ! pseudoItems_r.empty() )
   {
-    auto satPool = sat::Pool::instance();
     MIL << "Establish..." << endl;
-    sat::detail::CPool * cPool { satPool.get() };
-    ::pool_set_custom_vendorcheck( cPool, &vendorCheck );
+    // Take the states from the cache, compute just the missing ones.
+    cache_r.beginEstablish();
 
-    sat::Queue jobQueue;
-    // Add rules for parallel installable resolvables with different versions
-    for ( const sat::Solvable & solv : satPool.multiversion() )
+    sat::Queue todoItems;
+    pseudoFlags_r.clear();
+    for ( sat::Queue::size_type i = 0; i < pseudoItems_r.size(); ++i )
     {
-      jobQueue.push( SOLVER_NOOBSOLETES | SOLVER_SOLVABLE );
-      jobQueue.push( solv.id() );
+      int flag = 0;
+      if ( ! cache_r.lookup( sat::Solvable(pseudoItems_r[i]), flag ) )
+        todoItems.push( pseudoItems_r[i] );
+      pseudoFlags_r.push( flag );
     }
 
-    AutoDispose<sat::detail::CSolver*> cSolver { ::solver_create( cPool ), ::solver_free };
-    satPool.prepare();
-    if ( ::solver_solve( cSolver, jobQueue ) != 0 )
-      INT << "How can establish fail?" << endl;
+    if ( ! todoItems.empty() )
+    {
+      auto satPool = sat::Pool::instance();
+      sat::detail::CPool * cPool { satPool.get() };
+      ::pool_set_custom_vendorcheck( cPool, &vendorCheck );
+
+      sat::Queue jobQueue;
+      // Add rules for parallel installable resolvables with different versions
+      for ( const sat::Solvable & solv : satPool.multiversion() )
+      {
+        jobQueue.push( SOLVER_NOOBSOLETES | SOLVER_SOLVABLE );
+        jobQueue.push( solv.id() );
+      }
+
+      AutoDispose<sat::detail::CSolver*> cSolver { ::solver_create( cPool ), ::solver_free };
+      satPool.prepare();
+      if ( ::solver_solve( cSolver, jobQueue ) != 0 )
+        INT << "How can establish fail?" << endl;
 
-    ::solver_trivial_installable( cSolver, pseudoItems_r, pseudoFlags_r );
+      sat::Queue todoFlags;
+      ::solver_trivial_installable( cSolver, todoItems, todoFlags );
+
+      for ( sat::Queue::size_type i = 0, t = 0; i < pseudoItems_r.size() && t < todoItems.size(); ++i )
+      {
+        if ( pseudoItems_r[i] != todoItems[t] )
+          continue;
+        pseudoFlags_r[i] = todoFlags[t];
+        cache_r.store( sat::Solvable(todoItems[t]), todoFlags[t] );
+        ++t;
+      }
+    }
+    cache_r.endEstablish();
 
     for ( sat::Queue::size_type i = 0; i < pseudoItems_r.size(); ++i )
     {
@@ -221,12 +329,27 @@ void establish( sat::Queue & pseudoItems_r, sat::Queue & pseudoFlags_r )
         default: pi.status().setUndetermined(); break;
       }
     }
-    MIL << "Establish DONE" << endl;
+    MIL << "Establish DONE " << cache_r << endl;
   }
   else
     MIL << "Establish not needed." << endl;
 }
 
+/** Fingerprint of the vendor equivalence settings.
+ * They affect the solver result but are not part of the jobqueue.
+ */
+inline std::size_t vendorAttrFingerprint()
+{
+  std::size_t ret = 0;
+  VendorAttr::instance().foreachVendorList( [&ret]( VendorAttr::VendorList vlist_r ) {
+    for ( const std::string & vendor : vlist_r )
+      ret = ret * 31 + std::hash<std::string>()( vendor );
+    ret = ret * 31 + 1;	// group separator
+    return true;
+  } );
+  return ret;
+}
+
 inline std::string itemToString( const PoolItem & item )
 {
   if ( !item )
@@ -313,6 +436,7 @@ SATResolver::SATResolver (ResPool  pool, sat::detail::CPool *satPool)
     , _solveSrcPackages(false)
     , _cleandepsOnRemove(ZConfig::instance().solver_cleandepsOnRemove())
 {
+  queue_init( &_jobQueue );
 }
 
 
@@ -369,7 +493,8 @@ SATSolutionToPool (const PoolItem& item, const ResStatus & status, const ResStat
 /// \class SATCollectTransact
 /// \brief Commit helper functor distributing PoolItem by status into lists
 ///
-/// On the fly it clears all PoolItem bySolver/ByApplLow status.
+/// On the fly it clears all PoolItem bySolver/ByApplLow status
+/// (unless \c resetSolverResults_r is \c false; they are skipped anyway).
 /// The lists are cleared in the Ctor, populated by \ref operator().
 /////////////////////////////////////////////////////////////////////////
 struct SATCollectTransact
@@ -378,12 +503,14 @@ struct SATCollectTransact
                       PoolItemList & items_to_remove_r,
                       PoolItemList & items_to_lock_r,
                       PoolItemList & items_to_keep_r,
-                      bool solveSrcPackages_r )
+                      bool solveSrcPackages_r,
+                      bool resetSolverResults_r = true )
   : _items_to_install( items_to_install_r )
   , _items_to_remove( items_to_remove_r )
   , _items_to_lock( items_to_lock_r )
   , _items_to_keep( items_to_keep_r )
   , _solveSrcPackages( solveSrcPackages_r )
+  , _resetSolverResults( resetSolverResults_r )
   {
     _items_to_install.clear();
     _items_to_remove.clear();
@@ -400,7 +527,8 @@ struct SATCollectTransact
     if ( by_solver )
     {
       // Clear former solver/establish resultd
-      itemStatus.resetTransact( ResStatus::APPL_LOW );
+      if ( _resetSolverResults )
+        itemStatus.resetTransact( ResStatus::APPL_LOW );
       return true;	// -> back out here, don't re-queue former results
     }
 
@@ -427,6 +555,7 @@ private:
   PoolItemList & _items_to_lock;
   PoolItemList & _items_to_keep;
   bool _solveSrcPackages;
+  bool _resetSolverResults;
 
 };
 /////////////////////////////////////////////////////////////////////////
@@ -441,6 +570,7 @@ SATResolver::solverEnd()
     _satSolver = NULL;
     queue_free( &(_jobQueue) );
   }
+  _lastJobs.clear();
 }
 
 void
@@ -448,11 +578,37 @@ SATResolver::solverInit(const PoolItemList & weakItems)
 {
     MIL << "SATResolver::solverInit()" << endl;
 
-    // Remove old stuff and create a new jobqueue
-    solverEnd();
-    _satSolver = solver_create( _satPool );
-    queue_init( &_jobQueue );
+    // Reuse the solver unless the pool content changed, just clear the jobqueue.
+    // Otherwise remove old stuff and create a new one.
+    if ( ! _solverPoolWatcher.remember( sat::Pool::instance().serial() ) && _satSolver )
+    {
+      MIL << "Reusing solver (pool unchanged)" << endl;
+      queue_empty( &_jobQueue );
+    }
+    else
+    {
+      solverEnd();
+      _satSolver = solver_create( _satPool );
+      queue_init( &_jobQueue );
+    }
+    _solverSetup.clear();
+    _solutionJobs.clear();
+
+    solverInitJobs( weakItems );
+
+    solverInitSetFlags( *_satSolver );
+
+    // remember settings which are not part of the jobqueue (warm start)
+    _solverSetup.push_back( static_cast<std::size_t>(_focus) );
+    for ( bool flag : { bool(_ignorealreadyrecommended), bool(_allowdowngrade), bool(_allownamechange), bool(_allowarchchange),
+                        bool(_allowvendorchange), bool(_allowuninstall), bool(_noupdateprovide), bool(_dosplitprovides),
+                        bool(_onlyRequires), bool(_dup_allowdowngrade), bool(_dup_allownamechange), bool(_dup_allowarchchange),
+                        bool(_dup_allowvendorchange), ZConfig::instance().solverUpgradeRemoveDroppedPackages() } )
+      _solverSetup.push_back( flag );
+}
 
+void SATResolver::solverInitJobs( const PoolItemList & weakItems, bool resetSolverResults_r )
+{
     {
       // bsc#1182629: in dup allow an available -release package providing 'dup-vendor-relax(suse)'
       // to let (suse/opensuse) vendor being treated as being equivalent.
@@ -467,6 +623,8 @@ SATResolver::solverInit(const PoolItemList & weakItems)
         }
       }
       ::pool_set_custom_vendorcheck( _satPool, toRelax ? &relaxedVendorCheck : &vendorCheck );
+      _solverSetup.push_back( toRelax );
+      _solverSetup.push_back( vendorAttrFingerprint() );
     }
 
     // Add rules for user/auto installed packages
@@ -475,7 +633,7 @@ SATResolver::solverInit(const PoolItemList & weakItems)
     // Collect PoolItem's tasks and cleanup Pool for solving.
     // Todos are kept in _items_to_install, _items_to_remove, _items_to_lock, _items_to_keep
     {
-      SATCollectTransact collector( _items_to_install, _items_to_remove, _items_to_lock, _items_to_keep, solveSrcPackages() );
+      SATCollectTransact collector( _items_to_install, _items_to_remove, _items_to_lock, _items_to_keep, solveSrcPackages(), resetSolverResults_r );
       invokeOnEach ( _pool.begin(), _pool.end(), std::ref( collector ) );
     }
 
@@ -546,8 +704,8 @@ SATResolver::solverInit(const PoolItemList & weakItems)
     // set locks for the solver
     solverInitSetLocks();
 
-    // set mode (verify,up,dup) specific jobs and solver flags
-    solverInitSetModeJobsAndFlags();
+    // set mode (verify,up,dup) specific jobs
+    solverInitSetModeJobs();
 }
 
 void SATResolver::solverInitSetSystemRequirements()
@@ -624,7 +782,7 @@ void SATResolver::solverInitSetLocks()
     }
 }
 
-void SATResolver::solverInitSetModeJobsAndFlags()
+void SATResolver::solverInitSetModeJobs()
 {
     if (_fixsystem) {
         queue_push( &(_jobQueue), SOLVER_VERIFY|SOLVER_SOLVABLE_ALL);
@@ -655,22 +813,37 @@ void SATResolver::solverInitSetModeJobsAndFlags()
           return true;
         } );
     }
+}
 
-    solverSetFocus( *_satSolver, _focus );
-    solver_set_flag(_satSolver, SOLVER_FLAG_ADD_ALREADY_RECOMMENDED, !_ignorealreadyrecommended);
-    solver_set_flag(_satSolver, SOLVER_FLAG_ALLOW_DOWNGRADE,		_allowdowngrade);
-    solver_set_flag(_satSolver, SOLVER_FLAG_ALLOW_NAMECHANGE,		_allownamechange);
-    solver_set_flag(_satSolver, SOLVER_FLAG_ALLOW_ARCHCHANGE,		_allowarchchange);
-    solver_set_flag(_satSolver, SOLVER_FLAG_ALLOW_VENDORCHANGE,		_allowvendorchange);
-    solver_set_flag(_satSolver, SOLVER_FLAG_ALLOW_UNINSTALL,		_allowuninstall);
-    solver_set_flag(_satSolver, SOLVER_FLAG_NO_UPDATEPROVIDE,		_noupdateprovide);
-    solver_set_flag(_satSolver, SOLVER_FLAG_SPLITPROVIDES,		_dosplitprovides);
-    solver_set_flag(_satSolver, SOLVER_FLAG_IGNORE_RECOMMENDED, 	false);		// resolve recommended namespaces
-    solver_set_flag(_satSolver, SOLVER_FLAG_ONLY_NAMESPACE_RECOMMENDED,	_onlyRequires);	//
-    solver_set_flag(_satSolver, SOLVER_FLAG_DUP_ALLOW_DOWNGRADE,	_dup_allowdowngrade );
-    solver_set_flag(_satSolver, SOLVER_FLAG_DUP_ALLOW_NAMECHANGE,	_dup_allownamechange );
-    solver_set_flag(_satSolver, SOLVER_FLAG_DUP_ALLOW_ARCHCHANGE,	_dup_allowarchchange );
-    solver_set_flag(_satSolver, SOLVER_FLAG_DUP_ALLOW_VENDORCHANGE,	_dup_allowvendorchange );
+void SATResolver::solverInitSetFlags( sat::detail::CSolver & satSolver_r ) const
+{
+    solverSetFocus( satSolver_r, _focus );
+    solver_set_flag(&satSolver_r, SOLVER_FLAG_ADD_ALREADY_RECOMMENDED, !_ignorealreadyrecommended);
+    solver_set_flag(&satSolver_r, SOLVER_FLAG_ALLOW_DOWNGRADE,		_allowdowngrade);
+    solver_set_flag(&satSolver_r, SOLVER_FLAG_ALLOW_NAMECHANGE,		_allownamechange);
+    solver_set_flag(&satSolver_r, SOLVER_FLAG_ALLOW_ARCHCHANGE,		_allowarchchange);
+    solver_set_flag(&satSolver_r, SOLVER_FLAG_ALLOW_VENDORCHANGE,		_allowvendorchange);
+    solver_set_flag(&satSolver_r, SOLVER_FLAG_ALLOW_UNINSTALL,		_allowuninstall);
+    solver_set_flag(&satSolver_r, SOLVER_FLAG_NO_UPDATEPROVIDE,		_noupdateprovide);
+    solver_set_flag(&satSolver_r, SOLVER_FLAG_SPLITPROVIDES,		_dosplitprovides);
+    solver_set_flag(&satSolver_r, SOLVER_FLAG_IGNORE_RECOMMENDED, 	false);		// resolve recommended namespaces
+    solver_set_flag(&satSolver_r, SOLVER_FLAG_ONLY_NAMESPACE_RECOMMENDED,	_onlyRequires);	//
+    solver_set_flag(&satSolver_r, SOLVER_FLAG_DUP_ALLOW_DOWNGRADE,	_dup_allowdowngrade );
+    solver_set_flag(&satSolver_r, SOLVER_FLAG_DUP_ALLOW_NAMECHANGE,	_dup_allownamechange );
+    solver_set_flag(&satSolver_r, SOLVER_FLAG_DUP_ALLOW_ARCHCHANGE,	_dup_allowarchchange );
+    solver_set_flag(&satSolver_r, SOLVER_FLAG_DUP_ALLOW_VENDORCHANGE,	_dup_allowvendorchange );
+}
+
+bool SATResolver::solverReuseLastResult()
+{
+    bool depsChanged = _solverDepWatcher.remember( myPool().depSerial() );
+    std::vector<sat::detail::IdType> jobs( _jobQueue.elements, _jobQueue.elements + _jobQueue.count );
+    if ( ! depsChanged && ! _lastJobs.empty() && jobs == _lastJobs && _solverSetup == _lastSolverSetup )
+      return true;
+
+    _lastJobs.swap( jobs );
+    _lastSolverSetup = _solverSetup;
+    return false;
 }
 
 //----------------------------------------------------------------------------
@@ -711,12 +884,30 @@ bool
 SATResolver::solving(const CapabilitySet & requires_caps,
                      const CapabilitySet & conflict_caps)
 {
-    sat::Pool::instance().prepare();
+    {
+      ResolverProfile::Timer timer( _profile.prepare );
+      sat::Pool::instance().prepare();
+    }
 
-    // Solve !
-    MIL << "Starting solving...." << endl;
-    MIL << *this;
-    if ( solver_solve( _satSolver, &(_jobQueue) ) == 0 )
+    // Solve ! (unless jobs, settings and dependencies are the same as in the last run)
+    bool reuseResult = solverReuseLastResult();
+    if ( reuseResult )
+    {
+      MIL << "Jobs and settings unchanged. Reusing the last solver result." << endl;
+    }
+    else
+    {
+      MIL << "Starting solving...." << endl;
+      MIL << *this;
+    }
+    _profile.reused = reuseResult;
+    bool solved = false;
+    if ( ! reuseResult )
+    {
+      ResolverProfile::Timer timer( _profile.solve );
+      solved = ( solver_solve( _satSolver, &(_jobQueue) ) == 0 );
+    }
+    if ( solved )
     {
       // bsc#1155819: Weakremovers of future product not evaluated.
       // Do a 2nd run to cleanup weakremovers() of to be installed
@@ -760,14 +951,19 @@ SATResolver::solving(const CapabilitySet & requires_caps,
             }
           }
           if ( resolve )
+          {
+            ResolverProfile::Timer timer( _profile.solve );
             solver_solve( _satSolver, &(_jobQueue) );
+          }
         }
       }
     }
     MIL << "....Solver end" << endl;
+    collectProfileStats( *_satSolver, _jobQueue, _profile );
 
     // copying solution back to zypp pool
     //-----------------------------------------
+    ResolverProfile::Timer resultTimer( _profile.result );
     _result_items_to_install.clear();
     _result_items_to_remove.clear();
 
@@ -916,19 +1112,23 @@ SATResolver::resolvePool(const CapabilitySet & requires_caps,
                          const std::set<Repository> & upgradeRepos)
 {
     MIL << "SATResolver::resolvePool()" << endl;
+    _profile = ResolverProfile();
+    {
+      ResolverProfile::Timer timer( _profile.jobs );
 
-    // Initialize
-    solverInit(weakItems);
+      // Initialize
+      solverInit(weakItems);
 
-    // Add pool and extra jobs.
-    solverAddJobsFromPool();
-    solverAddJobsFromExtraQueues( requires_caps, conflict_caps );
-    // 'dup --from' jobs
-    for_( iter, upgradeRepos.begin(), upgradeRepos.end() )
-    {
-        queue_push( &(_jobQueue), SOLVER_DISTUPGRADE | SOLVER_SOLVABLE_REPO );
-        queue_push( &(_jobQueue), iter->get()->repoid );
-        MIL << "Upgrade repo " << *iter << endl;
+      // Add pool and extra jobs.
+      solverAddJobsFromPool();
+      solverAddJobsFromExtraQueues( requires_caps, conflict_caps );
+      // 'dup --from' jobs
+      for_( iter, upgradeRepos.begin(), upgradeRepos.end() )
+      {
+          queue_push( &(_jobQueue), SOLVER_DISTUPGRADE | SOLVER_SOLVABLE_REPO );
+          queue_push( &(_jobQueue), iter->get()->repoid );
+          MIL << "Upgrade repo " << *iter << endl;
+      }
     }
 
     // Solve!
@@ -944,17 +1144,21 @@ SATResolver::resolveQueue(const SolverQueueItemList &requestQueue,
                           const PoolItemList & weakItems)
 {
     MIL << "SATResolver::resolvQueue()" << endl;
+    _profile = ResolverProfile();
+    {
+      ResolverProfile::Timer timer( _profile.jobs );
 
-    // Initialize
-    solverInit(weakItems);
+      // Initialize
+      solverInit(weakItems);
 
-    // Add request queue's jobs.
-    for (SolverQueueItemList::const_iterator iter = requestQueue.begin(); iter != requestQueue.end(); iter++) {
-        (*iter)->addRule(_jobQueue);
-    }
+      // Add request queue's jobs.
+      for (SolverQueueItemList::const_iterator iter = requestQueue.begin(); iter != requestQueue.end(); iter++) {
+          (*iter)->addRule(_jobQueue);
+      }
 
-    // Add pool jobs; they do contain any problem resolutions.
-    solverAddJobsFromPool();
+      // Add pool jobs; they do contain any problem resolutions.
+      solverAddJobsFromPool();
+    }
 
     // Solve!
     bool ret = solving();
@@ -967,22 +1171,33 @@ SATResolver::resolveQueue(const SolverQueueItemList &requestQueue,
 void SATResolver::doUpdate()
 {
     MIL << "SATResolver::doUpdate()" << endl;
-
-    // Initialize
-    solverInit(PoolItemList());
+    _profile = ResolverProfile();
+    {
+      ResolverProfile::Timer timer( _profile.jobs );
+      // Initialize
+      solverInit(PoolItemList());
+      _lastJobs.clear();	// solver result is not reusable by solving()
+    }
 
     // By now, doUpdate has no additional jobs.
     // It does not include any pool jobs, and so it does not create an conflicts.
     // Combinations like patch_with_update are driven by resolvePool + _updatesystem.
 
     // TODO: Try to join the following with solving()
-    sat::Pool::instance().prepare();
+    {
+      ResolverProfile::Timer timer( _profile.prepare );
+      sat::Pool::instance().prepare();
+    }
 
     // Solve!
     MIL << "Starting solving for update...." << endl;
     MIL << *this;
-    solver_solve( _satSolver, &(_jobQueue) );
+    {
+      ResolverProfile::Timer timer( _profile.solve );
+      solver_solve( _satSolver, &(_jobQueue) );
+    }
     MIL << "....Solver end" << endl;
+    collectProfileStats( *_satSolver, _jobQueue, _profile );
 
     // copying solution back to zypp pool
     //-----------------------------------------
@@ -1355,7 +1570,9 @@ namespace {
 ResolverProblemList
 SATResolver::problems ()
 {
+    ResolverProfile::Timer timer( _profile.problems );
     ResolverProblemList resolverProblems;
+    _solutionJobs.clear();	// remembered for the solutions returned here
     if (_satSolver && solver_problem_count(_satSolver)) {
         sat::detail::CPool *pool = _satSolver->pool;
         int pcnt = 0;
@@ -1654,6 +1871,7 @@ SATResolver::problems ()
                     }
 
                 }
+                _solutionJobs.push_back( std::make_pair( ProblemSolution_Ptr(problemSolution), SolutionJob{ problem, solution, 0 } ) );
                 resolverProblem->addSolution (problemSolution,
                                               problemSolution->actionCount() > 1 ? true : false); // Solutions with more than 1 action will be shown first.
                 MIL << "------------------------------------" << endl;
@@ -1663,6 +1881,7 @@ SATResolver::problems ()
                 // There is a possibility to ignore this error by setting weak dependencies
                 PoolItem item = _pool.find (sat::Solvable(ignoreId));
                 ProblemSolutionIgnore *problemSolution = new ProblemSolutionIgnore(item);
+                _solutionJobs.push_back( std::make_pair( ProblemSolution_Ptr(problemSolution), SolutionJob{ 0, 0, ignoreId } ) );
                 resolverProblem->addSolution (problemSolution,
                                               false); // Solutions will be shown at the end
                 MIL << "ignore some dependencies of " << item << endl;
@@ -1683,6 +1902,146 @@ SATResolver::problems ()
 void SATResolver::applySolutions( const ProblemSolutionList & solutions )
 { Resolver( _pool ).applySolutions( solutions ); }
 
+ProblemSolutionEvaluationList SATResolver::evaluateSolutions( const ProblemSolutionList & solutions_r )
+{
+  ProblemSolutionEvaluationList ret;
+  ret.reserve( solutions_r.size() );
+
+  // Each solution is evaluated on a scratch solver using a copy of the
+  // last jobs with the solution applied. The libsolv pool is not thread
+  // safe (providers are computed and cached on demand), so solutions are
+  // evaluated one after the other.
+  AutoDispose<sat::detail::CSolver*> scratch;
+
+  for ( const ProblemSolution_Ptr & solution : solutions_r )
+  {
+    ProblemSolutionEvaluation eval;
+    eval.solution = solution;
+
+    auto it = std::find_if( _solutionJobs.begin(), _solutionJobs.end(),
+                            [&solution]( const auto & el_r ) { return el_r.first == solution; } );
+    if ( it == _solutionJobs.end() || ! _satSolver )
+    {
+      WAR << "Not a solution of the last solver run: " << solution << endl;
+      ret.push_back( std::move(eval) );
+      continue;
+    }
+
+    if ( ! scratch )
+    {
+      scratch = AutoDispose<sat::detail::CSolver*>( ::solver_create( _satPool ), ::solver_free );
+      solverInitSetFlags( *scratch.value() );
+      sat::Pool::instance().prepare();
+    }
+
+    sat::Queue jobs;
+    for ( int i = 0; i < _jobQueue.count; ++i )
+      jobs.push( _jobQueue.elements[i] );
+    const SolutionJob & sjob( it->second );
+    if ( sjob.weaken )
+    {
+      jobs.push( SOLVER_WEAKENDEPS | SOLVER_SOLVABLE );
+      jobs.push( sjob.weaken );
+    }
+    else
+      ::solver_take_solution( _satSolver, sjob.problem, sjob.solution, jobs );
+
+    eval.evaluated = true;
+    eval.solved = ( ::solver_solve( scratch, jobs ) == 0 );
+
+    std::vector<sat::Solvable> installs;
+    std::vector<sat::Solvable> removes;
+    collectSolverDecisions( *scratch.value(), installs, removes );
+    eval.installs = installs.size();
+    eval.removes = removes.size();
+    MIL << eval << endl;
+    ret.push_back( std::move(eval) );
+  }
+  return ret;
+}
+
+ResolverWhatIfResultList SATResolver::whatIf( const ResolverWhatIfRequestList & requests_r,
+                                              const CapabilitySet & requires_caps,
+                                              const CapabilitySet & conflict_caps,
+                                              const PoolItemList & weakItems,
+                                              const std::set<Repository> & upgradeRepos )
+{
+  MIL << "SATResolver::whatIf() " << requests_r.size() << " requests" << endl;
+  ResolverWhatIfResultList ret;
+  ret.reserve( requests_r.size() );
+  if ( requests_r.empty() )
+    return ret;
+
+  // Compute the base jobs like resolvePool does, but keep the former
+  // solver results in the pool. Everything the last solver run left in
+  // here (e.g. the _jobQueue needed by problems()) is restored on return.
+  sat::detail::CQueue lastJobQueue = _jobQueue;
+  queue_init( &_jobQueue );
+  PoolItemList lastItemsToInstall;
+  PoolItemList lastItemsToRemove;
+  PoolItemList lastItemsToLock;
+  PoolItemList lastItemsToKeep;
+  lastItemsToInstall.swap( _items_to_install );
+  lastItemsToRemove.swap( _items_to_remove );
+  lastItemsToLock.swap( _items_to_lock );
+  lastItemsToKeep.swap( _items_to_keep );
+  std::vector<std::size_t> lastSolverSetup;
+  lastSolverSetup.swap( _solverSetup );
+  bool lastProtectPTFs = _protectPTFs;
+  auto lastVendorCheck = ::pool_get_custom_vendorcheck( _satPool );
+  OnScopeExit restoreState( [&]() {
+    queue_free( &_jobQueue );
+    _jobQueue = lastJobQueue;
+    _items_to_install.swap( lastItemsToInstall );
+    _items_to_remove.swap( lastItemsToRemove );
+    _items_to_lock.swap( lastItemsToLock );
+    _items_to_keep.swap( lastItemsToKeep );
+    _solverSetup.swap( lastSolverSetup );
+    _protectPTFs = lastProtectPTFs;
+    ::pool_set_custom_vendorcheck( _satPool, lastVendorCheck );
+  } );
+
+  solverInitJobs( weakItems, /*resetSolverResults_r*/false );
+  solverAddJobsFromPool();
+  solverAddJobsFromExtraQueues( requires_caps, conflict_caps );
+  for ( const Repository & repo : upgradeRepos )
+  {
+    queue_push( &(_jobQueue), SOLVER_DISTUPGRADE | SOLVER_SOLVABLE_REPO );
+    queue_push( &(_jobQueue), repo.get()->repoid );
+  }
+  sat::Queue basejobs;
+  for ( int i = 0; i < _jobQueue.count; ++i )
+    basejobs.push( _jobQueue.elements[i] );
+
+  // Each request is solved on a scratch solver using a copy of the base jobs.
+  AutoDispose<sat::detail::CSolver*> scratch( ::solver_create( _satPool ), ::solver_free );
+  solverInitSetFlags( *scratch.value() );
+  sat::Pool::instance().prepare();
+
+  for ( const ResolverWhatIfRequest & request : requests_r )
+  {
+    sat::Queue jobs( basejobs );
+    for ( const PoolItem & pi : request.install )
+    {
+      jobs.push( SOLVER_INSTALL | SOLVER_SOLVABLE );
+      jobs.push( pi.id() );
+    }
+    for ( const PoolItem & pi : request.remove )
+    {
+      jobs.push( SOLVER_ERASE | SOLVER_SOLVABLE | MAYBE_CLEANDEPS );
+      jobs.push( pi.id() );
+    }
+
+    ResolverWhatIfResult result;
+    result.problems = ::solver_solve( scratch, jobs );
+    result.solved = ( result.problems == 0 );
+    collectSolverDecisions( *scratch.value(), result.installs, result.removes );
+    MIL << request << " " << result << endl;
+    ret.push_back( std::move(result) );
+  }
+  return ret;
+}
+
 sat::StringQueue SATResolver::autoInstalled() const
 {
   sat::StringQueue ret;
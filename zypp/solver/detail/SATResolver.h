@@ -34,7 +34,9 @@ extern "C"
 #include <list>
 #include <map>
 #include <string>
+#include <vector>
 
+#include <zypp/base/SerialNumber.h>
 #include <zypp/solver/Types.h>
 
 /////////////////////////////////////////////////////////////////////////
@@ -84,6 +86,27 @@ class SATResolver : public base::ReferenceCounted, private base::NonCopyable, pr
     PoolItemList _result_items_to_install;
     PoolItemList _result_items_to_remove;
 
+    // Warm start: The solver is kept and reused until the pool content changes.
+    // If a run has the same jobs and settings as the previous one and the
+    // dependencies did not change, the solvers last result is reused.
+    SerialNumberWatcher _solverPoolWatcher;	// pool content the solver was created for
+    SerialNumberWatcher _solverDepWatcher;	// dependency state the last result was computed for
+    std::vector<std::size_t> _solverSetup;	// settings not expressed as job (flags, focus, vendor equivalence)
+    std::vector<std::size_t> _lastSolverSetup;	// _solverSetup of the last solver run
+    std::vector<sat::detail::IdType> _lastJobs;	// _jobQueue of the last solver run (empty: no reusable result)
+
+    // The libsolv solution each ProblemSolution created by problems() represents
+    struct SolutionJob
+    {
+      Id problem = 0;	// libsolv problem and solution,...
+      Id solution = 0;
+      Id weaken = 0;	// ...or the solvable whose dependencies are weakened (ProblemSolutionIgnore)
+    };
+    std::vector<std::pair<ProblemSolution_Ptr,SolutionJob>> _solutionJobs;
+
+    // timings and statistics of the last solver run
+    ResolverProfile _profile;
+
   public:
     ResolverFocus _focus;		// The resolver's general attitude
 
@@ -119,13 +142,19 @@ class SATResolver : public base::ReferenceCounted, private base::NonCopyable, pr
 
     // Create a SAT solver and
     void solverInit(const PoolItemList & weakItems);
+    // fill the _jobQueue from the pools state (optionally keeping former solver results in the pool)
+    void solverInitJobs(const PoolItemList & weakItems, bool resetSolverResults_r = true);
     void solverInitSetLocks();
     void solverInitSetSystemRequirements();
-    void solverInitSetModeJobsAndFlags();
+    void solverInitSetModeJobs();
+    void solverInitSetFlags( sat::detail::CSolver & satSolver_r ) const;
 
     void solverAddJobsFromPool();
     void solverAddJobsFromExtraQueues( const CapabilitySet & requires_caps, const CapabilitySet & conflict_caps );
 
+    // whether the last solver result can be reused for the current _jobQueue and settings
+    bool solverReuseLastResult();
+
     // common solver run with the _jobQueue; Save results back to pool
     bool solving(const CapabilitySet & requires_caps = CapabilitySet(),
                  const CapabilitySet & conflict_caps = CapabilitySet());
@@ -170,6 +199,13 @@ class SATResolver : public base::ReferenceCounted, private base::NonCopyable, pr
 
     ResolverProblemList problems ();
     void applySolutions (const ProblemSolutionList &solutions);
+    ProblemSolutionEvaluationList evaluateSolutions( const ProblemSolutionList & solutions_r );
+    // independent solver runs on top of the pools state; neither pool nor solver state are changed
+    ResolverWhatIfResultList whatIf( const ResolverWhatIfRequestList & requests_r,
+                                     const CapabilitySet & requires_caps,
+                                     const CapabilitySet & conflict_caps,
+                                     const PoolItemList & weakItems,
+                                     const std::set<Repository> & upgradeRepos );
 
     bool fixsystem () const {return _fixsystem;}
     void setFixsystem ( const bool fixsystem) { _fixsystem = fixsystem;}
@@ -219,6 +255,10 @@ class SATResolver : public base::ReferenceCounted, private base::NonCopyable, pr
     PoolItemList resultItemsToInstall () { return _result_items_to_install; }
     PoolItemList resultItemsToRemove () { return _result_items_to_remove; }
 
+    // timings and statistics of the last solver run (the transaction time is added by the caller)
+    const ResolverProfile & profile() const { return _profile; }
+    ResolverProfile & profile() { return _profile; }
+
     sat::StringQueue autoInstalled() const;
     sat::StringQueue userInstalled() const;
 
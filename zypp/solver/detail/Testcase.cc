@@ -43,6 +43,7 @@
 
 extern "C" {
 #include <solv/testcase.h>
+#include <solv/repo_write.h>
 }
 
 using std::endl;
@@ -59,6 +60,46 @@ namespace zypp
 
       //---------------------------------------------------------------------------
 
+      namespace
+      {
+        /** Keyfilter dropping the bulky texts not needed to reproduce a solver run. */
+        int testcaseKeyFilter( sat::detail::CRepo * repo_r, Repokey * key_r, void * kfdata_r )
+        {
+          switch ( key_r->name )
+          {
+            case SOLVABLE_DESCRIPTION:
+            case SOLVABLE_AUTHORS:
+            case SOLVABLE_KEYWORDS:
+            case SOLVABLE_CHANGELOG:
+            case SOLVABLE_CHANGELOG_AUTHOR:
+            case SOLVABLE_CHANGELOG_TEXT:
+            case SOLVABLE_MESSAGEINS:
+            case SOLVABLE_MESSAGEDEL:
+            case SOLVABLE_EULA:
+              return KEY_STORAGE_DROPPED;
+          }
+          return ::repo_write_stdkeyfilter( repo_r, key_r, kfdata_r );
+        }
+
+        /** Write \a repo_r as solv file \a file_r. */
+        bool writeRepoSolv( const Repository & repo_r, const Pathname & file_r )
+        {
+          AutoDispose<FILE*> file( ::fopen( file_r.c_str(), "we" ), ::fclose );
+          if ( file == NULL )
+          {
+            file.resetDispose();
+            ERR << "Can't open " << file_r << " to write " << repo_r << endl;
+            return false;
+          }
+          if ( ::repo_write_filtered( repo_r.get(), file, testcaseKeyFilter, nullptr, nullptr ) != 0 )
+          {
+            ERR << "Failed to write " << repo_r << " to " << file_r << endl;
+            return false;
+          }
+          return true;
+        }
+      } // namespace
+
       Testcase::Testcase()
         :dumpPath("/var/log/YaST2/solverTestcase")
       {}
@@ -111,8 +152,10 @@ namespace zypp
         PoolItemList 	items_keep;
 
 
+        const bool solvFormat = ( repoFormat == RepoFormat::Solv );
         const std::string slvTestcaseName = "testcase.t";
         const std::string slvResult       = "solver.result";
+        const std::string slvProfile      = "solver-profile.json";
 
         zypp::AutoDispose<const char **> repoFileNames( testcase_mangle_repo_names( resolver.get()->pool ),
           [ nrepos = resolver.get()->pool->nrepos ]( auto **x ){
@@ -122,11 +165,26 @@ namespace zypp
             solv_free((void *)x);
         });
 
-        if ( ::testcase_write( resolver.get(), dumpPath.c_str(), TESTCASE_RESULT_TRANSACTION | TESTCASE_RESULT_PROBLEMS, slvTestcaseName.c_str(), slvResult.c_str() ) == 0 ) {
+        if ( solvFormat ) {
+          // Each repo as solv file; loading them is much faster than parsing testtags.
+          for ( const Repository & repo : sat::Pool::instance().repos() ) {
+            if ( ! writeRepoSolv( repo, Pathname(dumpPath) / (str::Format("%1%.solv") % repoFileNames[repo.id()->repoid]).str() ) ) {
+              ERR << "Failed to write solv data, aborting." << endl;
+              return false;
+            }
+          }
+        }
+        else if ( ::testcase_write( resolver.get(), dumpPath.c_str(), TESTCASE_RESULT_TRANSACTION | TESTCASE_RESULT_PROBLEMS, slvTestcaseName.c_str(), slvResult.c_str() ) == 0 ) {
           ERR << "Failed to write solv data, aborting." << endl;
           return false;
         }
 
+        {
+          // timings and statistics of the last solver run
+          std::ofstream fout( dumpPath+"/"+slvProfile );
+          fout << resolver.profile().asJSON() << endl;
+        }
+
         // HACK: directly access sat::pool
         const sat::Pool & satpool( sat::Pool::instance() );
 
@@ -178,7 +236,7 @@ namespace zypp
             yOut << YAML::Key << "generated" << YAML::Value << myRepo.generatedTimestamp().form( "%Y-%m-%d %H:%M:%S" );
             yOut << YAML::Key << "outdated" << YAML::Value << myRepo.suggestedExpirationTimestamp().form( "%Y-%m-%d %H:%M:%S" );
             yOut << YAML::Key << "priority" << YAML::Value << myRepoInfo.priority();
-            yOut << YAML::Key << "file" << YAML::Value << str::Format("%1%.repo.gz") % repoFileNames[myRepo.id()->repoid];
+            yOut << YAML::Key << "file" << YAML::Value << str::Format(solvFormat ? "%1%.solv" : "%1%.repo.gz") % repoFileNames[myRepo.id()->repoid];
 
             yOut << YAML::EndMap;
           }
@@ -188,8 +246,11 @@ namespace zypp
         yOut << YAML::EndSeq;
 
         yOut << YAML::Key << "arch" << YAML::Value << ZConfig::instance().systemArchitecture().asString() ;
-        yOut << YAML::Key << "solverTestcase" << YAML::Value << slvTestcaseName ;
-        yOut << YAML::Key << "solverResult" << YAML::Value << slvResult ;
+        if ( ! solvFormat ) {
+          yOut << YAML::Key << "solverTestcase" << YAML::Value << slvTestcaseName ;
+          yOut << YAML::Key << "solverResult" << YAML::Value << slvResult ;
+        }
+        yOut << YAML::Key << "solverProfile" << YAML::Value << slvProfile ;
 
         // RequestedLocales
         const LocaleSet & addedLocales( satpool.getAddedRequestedLocales() );
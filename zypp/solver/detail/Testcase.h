@@ -40,14 +40,25 @@ namespace zypp
        **/
       class ZYPP_API_DEPTESTOMATIC Testcase
       {
+        public:
+          /** How the repositories are stored in the testcase. */
+          enum class RepoFormat
+          {
+            Testtags,	///< libsolv testtags text (plus libsolv's testcase.t and solver.result)
+            Solv	///< compact solv files, fast to load (no libsolv testcase.t)
+          };
+
         private:
           std::string dumpPath; // Path of the generated testcase
+          RepoFormat repoFormat = RepoFormat::Testtags;
 
         public:
           Testcase();
           Testcase( std::string  path );
           ~Testcase();
 
+          void setRepoFormat( RepoFormat format_r ) { repoFormat = format_r; }
+
           bool createTestcase( Resolver & resolver, bool dumpPool = true, bool runSolver = true );
       };
 
@@ -0,0 +1,110 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/target/CommitHeaps.cc
+ *
+*/
+#include <algorithm>
+#include <unordered_map>
+
+#include <zypp/ResObjects.h>
+#include <zypp/sat/Transaction.h>
+
+#include <zypp/target/CommitHeaps.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  namespace target
+  {
+    std::vector<std::size_t> computeCommitHeaps( const std::vector<ByteCount::SizeType> & downloadSizes_r,
+                                                 const std::vector<std::pair<std::size_t,std::size_t>> & cycles_r,
+                                                 ByteCount budget_r )
+    {
+      const std::size_t nsteps = downloadSizes_r.size();
+      std::vector<std::size_t> ret;
+      if ( ! budget_r || ! nsteps )
+      {
+        ret.push_back( nsteps );
+        return ret;
+      }
+
+      // download size of the steps up to (excluding) i
+      std::vector<ByteCount::SizeType> downloadSum( nsteps+1, 0 );
+      for ( std::size_t i = 0; i < nsteps; ++i )
+        downloadSum[i+1] = downloadSum[i] + downloadSizes_r[i];
+
+      // no cut in front of a step inside an order cycle
+      std::vector<bool> noCut( nsteps, false );
+      for ( const auto & cycle : cycles_r )
+      {
+        for ( std::size_t i = cycle.first+1; i <= cycle.second && i < nsteps; ++i )
+          noCut[i] = true;
+      }
+
+      std::size_t heapBegin = 0;
+      std::size_t lastCut = 0;	// last possible cut in the current heap
+      for ( std::size_t i = 0; i < nsteps; ++i )
+      {
+        if ( i > heapBegin && ! noCut[i] )
+          lastCut = i;
+        if ( downloadSum[i+1] > downloadSum[i]	// step i needs a download...
+             && downloadSum[i+1] - downloadSum[heapBegin] > budget_r	// ...not fitting into the heap
+             && lastCut > heapBegin )
+        {
+          ret.push_back( lastCut );
+          heapBegin = lastCut;
+        }
+      }
+      ret.push_back( nsteps );
+      return ret;
+    }
+
+    std::vector<std::size_t> computeCommitHeaps( const ZYppCommitResult::TransactionStepList & steps_r,
+                                                 const sat::Transaction & transaction_r,
+                                                 ByteCount budget_r )
+    {
+      if ( ! budget_r || steps_r.empty() )
+        return { steps_r.size() };
+
+      std::vector<ByteCount::SizeType> downloadSizes( steps_r.size(), 0 );
+      std::unordered_map<sat::detail::IdType,std::size_t> stepIdx;
+      for ( std::size_t i = 0; i < steps_r.size(); ++i )
+      {
+        const sat::Transaction::Step & step { steps_r[i] };
+        if ( ( step.stepType() == sat::Transaction::TRANSACTION_INSTALL || step.stepType() == sat::Transaction::TRANSACTION_MULTIINSTALL )
+          && ( step.satSolvable().isKind<Package>() || step.satSolvable().isKind<SrcPackage>() ) )
+          downloadSizes[i] = step.satSolvable().downloadSize();
+        stepIdx[step.satSolvable().id()] = i;
+      }
+
+      std::vector<std::pair<std::size_t,std::size_t>> cycles;
+      for ( const auto & cycle : transaction_r.orderCycles() )
+      {
+        std::size_t first = steps_r.size();
+        std::size_t last = 0;
+        for ( const sat::Solvable & solv : cycle )
+        {
+          auto it = stepIdx.find( solv.id() );
+          if ( it == stepIdx.end() )
+            continue;	// e.g. cut off by restrictToMedia
+          first = std::min( first, it->second );
+          last = std::max( last, it->second );
+        }
+        if ( first < last )
+          cycles.push_back( { first, last } );
+      }
+
+      return computeCommitHeaps( downloadSizes, cycles, budget_r );
+    }
+
+  } // namespace target
+  ///////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
@@ -0,0 +1,49 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/target/CommitHeaps.h
+ *
+*/
+#ifndef ZYPP_TARGET_COMMITHEAPS_H
+#define ZYPP_TARGET_COMMITHEAPS_H
+
+#include <vector>
+#include <utility>
+#include <cstddef>
+
+#include <zypp/ByteCount.h>
+#include <zypp/ZYppCommitResult.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  namespace target
+  {
+    /** Split the ordered commit steps into heaps whose packages to download fit into \a budget_r.
+     * \a downloadSizes_r holds the download size of each step (\c 0 if nothing is
+     * downloaded, e.g. deleting a package). \a cycles_r holds the first and last step
+     * index of each order cycle. The steps of an order cycle are not split, so a heap
+     * may exceed the budget. A \c 0 budget returns a single heap.
+     *
+     * Returns the end index of each heap.
+     */
+    std::vector<std::size_t> computeCommitHeaps( const std::vector<ByteCount::SizeType> & downloadSizes_r,
+                                                 const std::vector<std::pair<std::size_t,std::size_t>> & cycles_r,
+                                                 ByteCount budget_r );
+
+    /** \overload Taking the download sizes from \a steps_r and the order cycles from \a transaction_r. */
+    std::vector<std::size_t> computeCommitHeaps( const ZYppCommitResult::TransactionStepList & steps_r,
+                                                 const sat::Transaction & transaction_r,
+                                                 ByteCount budget_r );
+
+  } // namespace target
+  ///////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_TARGET_COMMITHEAPS_H
@@ -0,0 +1,245 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/target/IndexedFileConflicts.cc
+ *
+*/
+extern "C"
+{
+#include <solv/pool.h>
+#include <solv/repo_rpmdb.h>
+}
+#include <sys/stat.h>
+
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <unordered_set>
+#include <string_view>
+
+#include <zypp/base/LogTools.h>
+#include <zypp/base/ParallelFor.h>
+#include <zypp-core/AutoDispose.h>
+#include <zypp/IdString.h>
+
+#include <zypp/target/InstalledFilesIndex.h>
+#include <zypp/target/IndexedFileConflicts.h>
+
+using std::endl;
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  namespace target
+  {
+    namespace
+    {
+      /** The conflict rules of libsolv (the lhs being the installed file, if any). */
+      bool isConflict( unsigned lmode_r, unsigned lcolor_r, std::string_view ldigest_r, unsigned rmode_r, unsigned rcolor_r, std::string_view rdigest_r )
+      {
+        if ( lcolor_r && rcolor_r && ! ( lcolor_r & rcolor_r ) )
+          return false;	// multilib: rpm prefers one of the colors
+        if ( S_ISDIR( lmode_r ) && S_ISDIR( rmode_r ) )
+          return false;
+        if ( ( lmode_r & S_IFMT ) != ( rmode_r & S_IFMT ) )
+          return true;
+        return ldigest_r != rdigest_r;
+      }
+
+      /** A conflict (the lhs being the installed package, if any). */
+      struct Conflict
+      {
+        std::string_view path;
+        sat::detail::IdType lsolv;
+        std::string_view ldigest;
+        sat::detail::IdType rsolv;
+        std::string_view rdigest;
+      };
+    } // namespace
+
+    IndexedFileConflicts::IndexedFileConflicts( const InstalledFilesIndex & index_r, std::string rootdir_r )
+    : _index( index_r )
+    , _rootdir( std::move(rootdir_r) )
+    {}
+
+    void IndexedFileConflicts::addInstalled( unsigned rpmdbid_r, sat::detail::IdType solv_r )
+    { _installed[rpmdbid_r] = solv_r; }
+
+    void IndexedFileConflicts::readCandidates( const std::vector<Candidate> & candidates_r, ProgressData & progress_r, sat::Queue & noFilelist_r )
+    {
+      std::vector<std::vector<CandidateFile>> files( candidates_r.size() );
+      std::vector<char> failed( candidates_r.size(), 0 );
+      std::atomic<bool> abort { false };
+
+      // Reading the headers is mostly I/O, so don't use too many threads.
+      unsigned nthreads = std::min( base::parallelJobs( candidates_r.size(), 1 ), 8U );
+      base::parallelFor( candidates_r.size(), nthreads, [&]( unsigned chunk_r, size_t begin_r, size_t end_r ) {
+        AutoDispose<::Pool*> pool { ::pool_create(), ::pool_free };
+        AutoDispose<void*> state { ::rpm_state_create( pool, _rootdir.empty() ? nullptr : _rootdir.c_str() ), ::rpm_state_free };
+        for ( size_t i = begin_r; i < end_r && ! abort; ++i )
+        {
+          const Pathname & localfile { candidates_r[i].second };
+          AutoDispose<FILE*> fp( ::fopen( localfile.c_str(), "re" ), []( FILE * fp_r ) { if ( fp_r ) ::fclose( fp_r ); } );
+          void * rpmhandle = fp ? ::rpm_byfp( state, fp, localfile.c_str() ) : nullptr;
+          if ( rpmhandle )
+          {
+            struct Collect
+            {
+              std::vector<CandidateFile> & _files;
+              sat::detail::IdType _solv;
+              static void invoke( void * cbdata_r, const char * filename_r, struct ::filelistinfo * info_r )
+              {
+                Collect & self { *static_cast<Collect *>( cbdata_r ) };
+                std::string path { filename_r };
+                uint64_t hash = InstalledFilesIndex::pathHash( path );
+                self._files.push_back( CandidateFile{ std::move(path), info_r->digest ? info_r->digest : "", info_r->mode, info_r->color, self._solv, hash } );
+              }
+            } collect { files[i], candidates_r[i].first };
+            ::rpm_iterate_filelist( rpmhandle, RPM_ITERATE_FILELIST_WITHMD5|RPM_ITERATE_FILELIST_WITHCOL|RPM_ITERATE_FILELIST_NOGHOSTS, &Collect::invoke, &collect );
+          }
+          else
+            failed[i] = 1;
+
+          // The 1st chunk is processed by the calling thread, the one allowed to report.
+          if ( chunk_r == 0 )
+          {
+            try { progress_r.set( std::min( ( i + 1 ) * nthreads, candidates_r.size() ) ); }
+            catch ( ... ) { abort = true; throw; }
+          }
+        }
+      } );
+      progress_r.set( candidates_r.size() );
+
+      for ( size_t i = 0; i < candidates_r.size(); ++i )
+      {
+        if ( failed[i] )
+          noFilelist_r.push( candidates_r[i].first );
+        for ( CandidateFile & file : files[i] )
+          _files.push_back( std::move(file) );
+      }
+      MIL << "Read " << _files.size() << " files of " << candidates_r.size() << " packages on " << nthreads << " threads" << endl;
+    }
+
+    bool IndexedFileConflicts::aliasingInvolved() const
+    {
+      if ( _index.aliasedDirs() )
+      {
+        MIL << "Installed system uses directory aliasing." << endl;
+        return true;
+      }
+
+      std::unordered_set<std::string_view> symlinks;
+      std::unordered_set<std::string_view> dirs;
+      for ( const CandidateFile & file : _files )
+      {
+        if ( S_ISLNK( file.mode ) )
+          symlinks.insert( file.path );
+        std::string_view path { file.path };
+        for ( std::string_view::size_type pos = path.rfind( '/' ); pos != std::string_view::npos && pos != 0; pos = path.rfind( '/', pos-1 ) )
+        {
+          if ( ! dirs.insert( path.substr( 0, pos ) ).second )
+            break;	// parents are already in
+        }
+      }
+
+      for ( std::string_view symlink : symlinks )
+      {
+        if ( dirs.count( symlink ) || _index.isDir( symlink ) )
+        {
+          MIL << "Directory aliasing by new symlink " << symlink << endl;
+          return true;
+        }
+      }
+      for ( std::string_view dir : dirs )
+      {
+        for ( const InstalledFilesIndex::Entry & ent : _index.lookup( dir ) )
+        {
+          if ( S_ISLNK( ent.mode ) && _installed.count( ent.rpmdbid ) )
+          {
+            MIL << "Directory aliasing by installed symlink " << dir << endl;
+            return true;
+          }
+        }
+      }
+      return false;
+    }
+
+    void IndexedFileConflicts::findConflicts( sat::FileConflicts & conflicts_r ) const
+    {
+      unsigned nshards = base::parallelJobs( _files.size(), 1000 );
+      std::vector<std::vector<const CandidateFile *>> shards( nshards );
+      for ( const CandidateFile & file : _files )
+        shards[file.hash % nshards].push_back( &file );
+
+      std::vector<std::vector<Conflict>> results( nshards );
+      base::parallelFor( nshards, nshards, [&]( unsigned, size_t begin_r, size_t end_r ) {
+        for ( size_t shard = begin_r; shard < end_r; ++shard )
+        {
+          std::vector<const CandidateFile *> & files { shards[shard] };
+          std::vector<Conflict> & result { results[shard] };
+          std::sort( files.begin(), files.end(), []( const CandidateFile * lhs, const CandidateFile * rhs ) {
+            return lhs->path != rhs->path ? lhs->path < rhs->path : lhs->solv < rhs->solv;
+          } );
+
+          for ( auto begin = files.begin(); begin != files.end(); )
+          {
+            auto end = std::find_if( begin, files.end(), [&]( const CandidateFile * file_r ) { return file_r->path != (*begin)->path; } );
+
+            // vs. installed
+            for ( const InstalledFilesIndex::Entry & ent : _index.lookup( (*begin)->path ) )
+            {
+              auto installed = _installed.find( ent.rpmdbid );
+              if ( installed == _installed.end() )
+                continue;	// deleted or updated
+              for ( auto it = begin; it != end; ++it )
+              {
+                if ( isConflict( ent.mode, ent.color, ent.digest, (*it)->mode, (*it)->color, (*it)->digest ) )
+                  result.push_back( Conflict{ ent.path, installed->second, ent.digest, (*it)->solv, (*it)->digest } );
+              }
+            }
+
+            // vs. each other
+            for ( auto lhs = begin; lhs != end; ++lhs )
+            {
+              for ( auto rhs = lhs+1; rhs != end; ++rhs )
+              {
+                if ( (*lhs)->solv != (*rhs)->solv
+                     && isConflict( (*lhs)->mode, (*lhs)->color, (*lhs)->digest, (*rhs)->mode, (*rhs)->color, (*rhs)->digest ) )
+                  result.push_back( Conflict{ (*lhs)->path, (*lhs)->solv, (*lhs)->digest, (*rhs)->solv, (*rhs)->digest } );
+              }
+            }
+            begin = end;
+          }
+        }
+      } );
+
+      std::vector<Conflict> all;
+      for ( auto & result : results )
+        all.insert( all.end(), result.begin(), result.end() );
+      std::sort( all.begin(), all.end(), []( const Conflict & lhs, const Conflict & rhs ) {
+        if ( lhs.path != rhs.path )
+          return lhs.path < rhs.path;
+        return lhs.lsolv != rhs.lsolv ? lhs.lsolv < rhs.lsolv : lhs.rsolv < rhs.rsolv;
+      } );
+
+      sat::detail::CQueue * queue = conflicts_r;
+      for ( const Conflict & conflict : all )
+      {
+        sat::detail::IdType path = IdString( conflict.path ).id();
+        ::queue_push2( queue, path, conflict.lsolv );
+        ::queue_push( queue, IdString( conflict.ldigest ).id() );
+        ::queue_push2( queue, path, conflict.rsolv );
+        ::queue_push( queue, IdString( conflict.rdigest ).id() );
+      }
+    }
+
+  } // namespace target
+  ///////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
@@ -0,0 +1,98 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/target/IndexedFileConflicts.h
+ *
+*/
+#ifndef ZYPP_TARGET_INDEXEDFILECONFLICTS_H
+#define ZYPP_TARGET_INDEXEDFILECONFLICTS_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <utility>
+#include <cstdint>
+
+#include <zypp/base/NonCopyable.h>
+#include <zypp/Pathname.h>
+#include <zypp/ProgressData.h>
+#include <zypp/sat/Queue.h>
+#include <zypp/sat/FileConflicts.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  namespace target
+  {
+    class InstalledFilesIndex;
+
+    ///////////////////////////////////////////////////////////////////
+    /// \class IndexedFileConflicts
+    /// \brief Find file conflicts using the \ref InstalledFilesIndex.
+    ///
+    /// Like \c pool_findfileconflicts, but only the headers of the packages
+    /// to install are read (on a pool of threads). The installed files are
+    /// taken from the index. The files are then checked in parallel, each
+    /// thread handling the paths of one hash shard.
+    ///
+    /// Directory aliasing (a symlink replacing a directory, e.g. /lib -> usr/lib)
+    /// is not resolved here. If \ref aliasingInvolved, the caller must let
+    /// libsolv do the job.
+    ///////////////////////////////////////////////////////////////////
+    class IndexedFileConflicts : private base::NonCopyable
+    {
+    public:
+      /** A package to install and its rpm file. */
+      using Candidate = std::pair<sat::detail::IdType,Pathname>;
+
+      /** Ctor taking the installed files from \a index_r.
+       * The rpm configuration is read below \a rootdir_r.
+       */
+      IndexedFileConflicts( const InstalledFilesIndex & index_r, std::string rootdir_r = std::string() );
+
+      /** The installed package \a solv_r (rpmdb instance \a rpmdbid_r) remains installed after commit.
+       * Files of installed packages not added here are deleted or updated.
+       */
+      void addInstalled( unsigned rpmdbid_r, sat::detail::IdType solv_r );
+
+      /** Read the file lists of the packages to install.
+       * Packages whose rpm file can't be read are appended to \a noFilelist_r.
+       */
+      void readCandidates( const std::vector<Candidate> & candidates_r, ProgressData & progress_r, sat::Queue & noFilelist_r );
+
+      /** Whether a symlink replaces or is a parent directory of some file. */
+      bool aliasingInvolved() const;
+
+      /** Append the conflicts to \a conflicts_r (sorted by path, the lhs being the installed package, if any). */
+      void findConflicts( sat::FileConflicts & conflicts_r ) const;
+
+    private:
+      /** A file of a package to install. */
+      struct CandidateFile
+      {
+        std::string path;
+        std::string digest;
+        unsigned mode;
+        unsigned color;
+        sat::detail::IdType solv;
+        std::uint64_t hash;
+      };
+
+      const InstalledFilesIndex & _index;
+      std::string _rootdir;
+      std::vector<CandidateFile> _files;
+      std::unordered_map<unsigned,sat::detail::IdType> _installed;	///< rpmdbid -> solvable
+    };
+    ///////////////////////////////////////////////////////////////////
+
+  } // namespace target
+  ///////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_TARGET_INDEXEDFILECONFLICTS_H
@@ -0,0 +1,410 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/target/InstalledFilesIndex.cc
+ *
+*/
+extern "C"
+{
+#include <solv/pool.h>
+#include <solv/repo_rpmdb.h>
+}
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+#include <unordered_set>
+
+#include <zypp/base/LogTools.h>
+#include <zypp/base/String.h>
+#include <zypp/base/Exception.h>
+#include <zypp/base/Measure.h>
+#include <zypp-core/AutoDispose.h>
+#include <zypp/PathInfo.h>
+#include <zypp/TmpPath.h>
+#include <zypp/sat/Queue.h>
+
+#include <zypp/target/InstalledFilesIndex.h>
+
+using std::endl;
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  namespace target
+  {
+    // The index file:
+    //   FileHeader
+    //   cookie (padded to 8 byte)
+    //   FileEntry[nentries]	sorted by hash, path
+    //   DirEntry[ndirs]	sorted by hash, path
+    //   strings
+    namespace
+    {
+      constexpr char     indexMagic[8] = { 'Z', 'Y', 'P', 'P', 'F', 'I', 'D', 'X' };
+      constexpr uint32_t indexVersion  = 1;
+
+      struct FileHeader
+      {
+        char     magic[8];
+        uint32_t version;
+        uint32_t cookielen;
+        uint32_t nentries;
+        uint32_t ndirs;
+        uint32_t naliased;
+        uint32_t reserved;
+        uint64_t stringsize;
+      };
+
+      inline std::size_t padded( std::size_t size_r )
+      { return ( size_r + 7 ) & ~std::size_t(7); }
+    } // namespace
+
+    struct InstalledFilesIndex::FileEntry
+    {
+      uint64_t hash;
+      uint32_t path;
+      uint32_t pathlen;
+      uint32_t digest;
+      uint32_t digestlen;
+      uint32_t rpmdbid;
+      uint32_t mode;
+      uint32_t color;
+      uint32_t pad;
+    };
+
+    struct InstalledFilesIndex::DirEntry
+    {
+      uint64_t hash;
+      uint32_t path;
+      uint32_t pathlen;
+    };
+
+    std::uint64_t InstalledFilesIndex::pathHash( std::string_view path_r )
+    {
+      // FNV-1a
+      std::uint64_t ret = 0xcbf29ce484222325ULL;
+      for ( unsigned char ch : path_r )
+      {
+        ret ^= ch;
+        ret *= 0x100000001b3ULL;
+      }
+      return ret;
+    }
+
+    InstalledFilesIndex::InstalledFilesIndex()
+    {}
+
+    InstalledFilesIndex::InstalledFilesIndex( const Pathname & file_r, const std::string & cookie_r )
+    {
+      AutoDispose<int> fd { ::open( file_r.c_str(), O_RDONLY|O_CLOEXEC ), []( int fd_r ) { if ( fd_r != -1 ) ::close( fd_r ); } };
+      struct ::stat st;
+      if ( fd == -1 || ::fstat( fd, &st ) != 0 || std::size_t(st.st_size) < sizeof(FileHeader) )
+        return;
+
+      void * map = ::mmap( nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+      if ( map == MAP_FAILED )
+      {
+        WAR << "Can't map " << file_r << ": " << str::strerror( errno ) << endl;
+        return;
+      }
+      _map = map;
+      _mapsize = st.st_size;
+
+      const FileHeader & hdr { *static_cast<const FileHeader *>( _map ) };
+      const char * base = static_cast<const char *>( _map );
+      std::size_t tableoff = sizeof(FileHeader) + padded( hdr.cookielen );
+      std::size_t stringsoff = tableoff + std::size_t(hdr.nentries) * sizeof(FileEntry) + std::size_t(hdr.ndirs) * sizeof(DirEntry);
+      if ( ::memcmp( hdr.magic, indexMagic, sizeof(indexMagic) ) != 0
+        || hdr.version != indexVersion
+        || stringsoff > _mapsize
+        || hdr.stringsize != _mapsize - stringsoff )
+      {
+        WAR << "Ignore malformed " << file_r << endl;
+        return;
+      }
+
+      // All strings referenced by the tables must be inside the string area.
+      auto inStrings = [&hdr]( uint32_t off_r, uint32_t len_r ) -> bool
+      { return uint64_t(off_r) + len_r <= hdr.stringsize; };
+      const FileEntry * fentries = reinterpret_cast<const FileEntry *>( base + tableoff );
+      for ( const FileEntry * it = fentries; it != fentries + hdr.nentries; ++it )
+      {
+        if ( ! ( inStrings( it->path, it->pathlen ) && inStrings( it->digest, it->digestlen ) ) )
+        {
+          WAR << "Ignore malformed " << file_r << " (file entry " << (it - fentries) << ")" << endl;
+          return;
+        }
+      }
+      const DirEntry * dentries = reinterpret_cast<const DirEntry *>( base + tableoff + std::size_t(hdr.nentries) * sizeof(FileEntry) );
+      for ( const DirEntry * it = dentries; it != dentries + hdr.ndirs; ++it )
+      {
+        if ( ! inStrings( it->path, it->pathlen ) )
+        {
+          WAR << "Ignore malformed " << file_r << " (dir entry " << (it - dentries) << ")" << endl;
+          return;
+        }
+      }
+
+      _cookie   = std::string_view( base + sizeof(FileHeader), hdr.cookielen );
+      _nentries = hdr.nentries;
+      _ndirs    = hdr.ndirs;
+      _naliased = hdr.naliased;
+      _table    = base + tableoff;
+      _strings  = base + stringsoff;
+      _valid    = ( cookie_r.empty() || _cookie == cookie_r );
+      if ( ! _valid )
+        MIL << file_r << " is outdated" << endl;
+    }
+
+    InstalledFilesIndex::~InstalledFilesIndex()
+    {
+      if ( _map )
+        ::munmap( _map, _mapsize );
+    }
+
+    const InstalledFilesIndex::FileEntry * InstalledFilesIndex::entries() const
+    { return reinterpret_cast<const FileEntry *>( _table ); }
+
+    const InstalledFilesIndex::DirEntry * InstalledFilesIndex::dirs() const
+    { return reinterpret_cast<const DirEntry *>( _table + std::size_t(_nentries) * sizeof(FileEntry) ); }
+
+    InstalledFilesIndex::Entry InstalledFilesIndex::entry( const FileEntry & fe_r ) const
+    { return Entry { string( fe_r.path, fe_r.pathlen ), string( fe_r.digest, fe_r.digestlen ), fe_r.rpmdbid, fe_r.mode, fe_r.color }; }
+
+    std::vector<InstalledFilesIndex::Entry> InstalledFilesIndex::lookup( std::string_view path_r ) const
+    {
+      std::vector<Entry> ret;
+      if ( ! _nentries )
+        return ret;
+
+      uint64_t hash = pathHash( path_r );
+      const FileEntry * begin = entries();
+      const FileEntry * end = begin + _nentries;
+      for ( const FileEntry * it = std::lower_bound( begin, end, hash, []( const FileEntry & lhs, uint64_t rhs ) { return lhs.hash < rhs; } );
+            it != end && it->hash == hash; ++it )
+      {
+        if ( string( it->path, it->pathlen ) == path_r )
+          ret.push_back( entry( *it ) );
+      }
+      return ret;
+    }
+
+    bool InstalledFilesIndex::isDir( std::string_view path_r ) const
+    {
+      if ( ! _ndirs )
+        return false;
+
+      uint64_t hash = pathHash( path_r );
+      const DirEntry * begin = dirs();
+      const DirEntry * end = begin + _ndirs;
+      for ( const DirEntry * it = std::lower_bound( begin, end, hash, []( const DirEntry & lhs, uint64_t rhs ) { return lhs.hash < rhs; } );
+            it != end && it->hash == hash; ++it )
+      {
+        if ( string( it->path, it->pathlen ) == path_r )
+          return true;
+      }
+      return false;
+    }
+
+    ///////////////////////////////////////////////////////////////////
+    namespace
+    {
+      /** An index entry to write. */
+      struct Record
+      {
+        std::string path;
+        std::string digest;
+        uint32_t rpmdbid;
+        uint32_t mode;
+        uint32_t color;
+        uint64_t hash;
+      };
+
+      /** libsolv::rpm_iterate_filelist callback collecting the \ref Record of a header. */
+      struct CollectFiles
+      {
+        std::vector<Record> & _records;
+        uint32_t _rpmdbid;
+
+        static void invoke( void * cbdata_r, const char * filename_r, struct ::filelistinfo * info_r )
+        {
+          CollectFiles & self { *static_cast<CollectFiles *>( cbdata_r ) };
+          std::string path { filename_r };
+          uint64_t hash = InstalledFilesIndex::pathHash( path );
+          self._records.push_back( Record{ std::move(path), info_r->digest ? info_r->digest : "", self._rpmdbid, info_r->mode, info_r->color, hash } );
+        }
+      };
+
+      /** Write the index \a records_r to \a file_r. */
+      void writeIndex( std::vector<Record> & records_r, const std::string & cookie_r, const Pathname & file_r )
+      {
+        std::sort( records_r.begin(), records_r.end(), []( const Record & lhs, const Record & rhs ) {
+          if ( lhs.hash != rhs.hash )
+            return lhs.hash < rhs.hash;
+          if ( lhs.path != rhs.path )
+            return lhs.path < rhs.path;
+          return lhs.rpmdbid < rhs.rpmdbid;
+        } );
+
+        std::string strings;
+        auto addString = [&strings]( const std::string & str_r ) -> uint32_t {
+          uint32_t ret = strings.size();
+          strings += str_r;
+          return ret;
+        };
+
+        // file entries (equal paths are adjacent and stored once)
+        std::vector<InstalledFilesIndex::FileEntry> fileentries;
+        fileentries.reserve( records_r.size() );
+        std::unordered_set<std::string> dirnames;
+        const Record * prev = nullptr;
+        for ( const Record & rec : records_r )
+        {
+          uint32_t pathoff = ( prev && prev->path == rec.path ) ? fileentries.back().path : addString( rec.path );
+          uint32_t digestoff = addString( rec.digest );
+          fileentries.push_back( { rec.hash, pathoff, uint32_t(rec.path.size()), digestoff, uint32_t(rec.digest.size()), rec.rpmdbid, rec.mode, rec.color, 0 } );
+          prev = &rec;
+
+          for ( std::string::size_type pos = rec.path.rfind( '/' ); pos != std::string::npos && pos != 0; pos = rec.path.rfind( '/', pos-1 ) )
+          {
+            if ( ! dirnames.insert( rec.path.substr( 0, pos ) ).second )
+              break;	// parents are already in
+          }
+        }
+
+        // dir entries
+        std::vector<std::pair<uint64_t,const std::string *>> sorteddirs;
+        sorteddirs.reserve( dirnames.size() );
+        for ( const std::string & dir : dirnames )
+          sorteddirs.push_back( { InstalledFilesIndex::pathHash( dir ), &dir } );
+        std::sort( sorteddirs.begin(), sorteddirs.end(), []( const auto & lhs, const auto & rhs ) {
+          return lhs.first != rhs.first ? lhs.first < rhs.first : *lhs.second < *rhs.second;
+        } );
+        // symlinks with files below them (directory aliasing)
+        uint32_t naliased = 0;
+        for ( const Record & rec : records_r )
+        {
+          if ( S_ISLNK( rec.mode ) && dirnames.count( rec.path ) )
+          {
+            MIL << "Aliased directory " << rec.path << endl;
+            ++naliased;
+          }
+        }
+
+        std::vector<InstalledFilesIndex::DirEntry> direntries;
+        direntries.reserve( sorteddirs.size() );
+        for ( const auto & dir : sorteddirs )
+          direntries.push_back( { dir.first, addString( *dir.second ), uint32_t(dir.second->size()) } );
+
+        FileHeader hdr;
+        ::memcpy( hdr.magic, indexMagic, sizeof(indexMagic) );
+        hdr.version    = indexVersion;
+        hdr.cookielen  = cookie_r.size();
+        hdr.nentries   = fileentries.size();
+        hdr.ndirs      = direntries.size();
+        hdr.naliased   = naliased;
+        hdr.reserved   = 0;
+        hdr.stringsize = strings.size();
+
+        filesystem::TmpFile tmpfile( filesystem::TmpFile::makeSibling( file_r ) );
+        if ( ! tmpfile )
+          ZYPP_THROW( Exception( str::Str() << "Can't create temporary file for " << file_r ) );
+        {
+          std::ofstream out( tmpfile.path().c_str(), std::ios::binary );
+          static const char padding[8] = { 0 };
+          out.write( reinterpret_cast<const char *>( &hdr ), sizeof(hdr) );
+          out.write( cookie_r.data(), cookie_r.size() );
+          out.write( padding, padded( cookie_r.size() ) - cookie_r.size() );
+          out.write( reinterpret_cast<const char *>( fileentries.data() ), fileentries.size() * sizeof(InstalledFilesIndex::FileEntry) );
+          out.write( reinterpret_cast<const char *>( direntries.data() ), direntries.size() * sizeof(InstalledFilesIndex::DirEntry) );
+          out.write( strings.data(), strings.size() );
+          out.close();
+          if ( ! out )
+            ZYPP_THROW( Exception( str::Str() << "Failed to write " << tmpfile.path() ) );
+        }
+        if ( filesystem::rename( tmpfile, file_r ) != 0 )
+          ZYPP_THROW( Exception( str::Str() << "Failed to move index to " << file_r ) );
+        filesystem::chmod( file_r, 0644 );
+      }
+    } // namespace
+    ///////////////////////////////////////////////////////////////////
+
+    void InstalledFilesIndex::write( const std::vector<Entry> & entries_r, const std::string & cookie_r, const Pathname & file_r )
+    {
+      std::vector<Record> records;
+      records.reserve( entries_r.size() );
+      for ( const Entry & ent : entries_r )
+        records.push_back( Record{ std::string(ent.path), std::string(ent.digest), ent.rpmdbid, ent.mode, ent.color, pathHash( ent.path ) } );
+      writeIndex( records, cookie_r, file_r );
+    }
+
+    void InstalledFilesIndex::update( const Pathname & root_r, const std::string & cookie_r, const Pathname & file_r )
+    {
+      debug::Measure m( "InstalledFilesIndex::update" );
+      AutoDispose<::Pool*> pool { ::pool_create(), ::pool_free };
+      AutoDispose<void*> state { ::rpm_state_create( pool, root_r.c_str() ), ::rpm_state_free };
+
+      sat::Queue rpmdbids;
+      if ( ::rpm_installedrpmdbids( state, nullptr, nullptr, rpmdbids ) < 0 )
+        ZYPP_THROW( Exception( str::Str() << "Failed to read rpm database: " << ::pool_errstr( pool ) ) );
+      std::unordered_set<uint32_t> installed( rpmdbids.begin(), rpmdbids.end() );
+
+      // reuse the entries of packages still installed
+      std::vector<Record> records;
+      std::unordered_set<uint32_t> known;
+      {
+        InstalledFilesIndex old( file_r, std::string() );
+        records.reserve( old.size() );
+        for ( const FileEntry * it = old.entries(); it != old.entries() + old.size(); ++it )
+        {
+          if ( ! installed.count( it->rpmdbid ) )
+            continue;
+          known.insert( it->rpmdbid );
+          const Entry & ent { old.entry( *it ) };
+          records.push_back( Record{ std::string(ent.path), std::string(ent.digest), ent.rpmdbid, ent.mode, ent.color, it->hash } );
+        }
+      }
+
+      // read the new ones
+      unsigned headers = 0;
+      for ( uint32_t rpmdbid : installed )
+      {
+        if ( known.count( rpmdbid ) )
+          continue;
+        void * rpmhandle = ::rpm_byrpmdbid( state, rpmdbid );
+        if ( ! rpmhandle )
+        {
+          WAR << "Can't read header " << rpmdbid << ": " << ::pool_errstr( pool ) << endl;
+          continue;
+        }
+        CollectFiles collect { records, rpmdbid };
+        ::rpm_iterate_filelist( rpmhandle, RPM_ITERATE_FILELIST_WITHMD5|RPM_ITERATE_FILELIST_WITHCOL|RPM_ITERATE_FILELIST_NOGHOSTS, &CollectFiles::invoke, &collect );
+        ++headers;
+      }
+
+      writeIndex( records, cookie_r, file_r );
+      MIL << "Wrote " << file_r << ": " << records.size() << " files of " << installed.size() << " packages (" << headers << " headers read)" << endl;
+    }
+
+    std::ostream & operator<<( std::ostream & str, const InstalledFilesIndex & obj )
+    { return str << "InstalledFilesIndex{" << (obj?"":"invalid ") << obj.size() << " files|" << obj.cookie() << "}"; }
+
+    std::ostream & operator<<( std::ostream & str, const InstalledFilesIndex::Entry & obj )
+    { return str << obj.path << "(" << obj.rpmdbid << "|" << str::octstring( obj.mode ) << "|" << obj.digest << ")"; }
+
+  } // namespace target
+  ///////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
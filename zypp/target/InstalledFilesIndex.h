@@ -0,0 +1,144 @@
+/*---------------------------------------------------------------------\
+|                          ____ _   __ __ ___                          |
+|                         |__  / \ / / . \ . \                         |
+|                           / / \ V /|  _/  _/                         |
+|                          / /__ | | | | | |                           |
+|                         /_____||_| |_| |_|                           |
+|                                                                      |
+\---------------------------------------------------------------------*/
+/** \file	zypp/target/InstalledFilesIndex.h
+ *
+*/
+#ifndef ZYPP_TARGET_INSTALLEDFILESINDEX_H
+#define ZYPP_TARGET_INSTALLEDFILESINDEX_H
+
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+#include <zypp/base/NonCopyable.h>
+#include <zypp/Pathname.h>
+
+///////////////////////////////////////////////////////////////////
+namespace zypp
+{
+  ///////////////////////////////////////////////////////////////////
+  namespace target
+  {
+    ///////////////////////////////////////////////////////////////////
+    /// \class InstalledFilesIndex
+    /// \brief Persistent index of the files owned by installed packages.
+    ///
+    /// Maps each file path to the owning package (by its rpmdb instance id)
+    /// and the files digest, mode and color, as provided by libsolvs
+    /// \c rpm_iterate_filelist. Ghost files are not included.
+    ///
+    /// The index file is mapped into memory, entries are located via a
+    /// hash of their path. It's valid as long as the rpmdb state it was
+    /// built for (\c cookie) did not change. \ref update rebuilds it,
+    /// reading only the headers of packages not yet in the old index.
+    ///////////////////////////////////////////////////////////////////
+    class InstalledFilesIndex : private base::NonCopyable
+    {
+      friend std::ostream & operator<<( std::ostream & str, const InstalledFilesIndex & obj );
+
+    public:
+      /** An installed file. */
+      struct Entry
+      {
+        std::string_view path;
+        std::string_view digest;	///< file digest, for symlinks the digest of the link target
+        unsigned rpmdbid;		///< the owning package
+        unsigned mode;
+        unsigned color;
+      };
+
+      /** Stable hash of a file path (used for the index and to shard lookups). */
+      static std::uint64_t pathHash( std::string_view path_r );
+
+    public:
+      /** Default ctor: an empty, invalid index. */
+      InstalledFilesIndex();
+
+      /** Map the index \a file_r, if it was built for \a cookie_r (or \a cookie_r is empty).
+       * Otherwise, or if the file is malformed, the index is invalid. A malformed
+       * index is also empty.
+       */
+      InstalledFilesIndex( const Pathname & file_r, const std::string & cookie_r );
+
+      /** Dtor */
+      ~InstalledFilesIndex();
+
+      /** Whether the index was built for the expected cookie. */
+      explicit operator bool() const
+      { return _valid; }
+
+      /** The cookie the index was built for. */
+      std::string_view cookie() const
+      { return _cookie; }
+
+      /** Number of file entries. */
+      unsigned size() const
+      { return _nentries; }
+
+      /** The entries for \a path_r. */
+      std::vector<Entry> lookup( std::string_view path_r ) const;
+
+      /** Whether some installed file is located below \a path_r. */
+      bool isDir( std::string_view path_r ) const;
+
+      /** Number of installed symlinks with installed files below them (directory aliasing). */
+      unsigned aliasedDirs() const
+      { return _naliased; }
+
+    public:
+      /** Build the index of all packages in the rpmdb below \a root_r and write it to \a file_r.
+       * Entries of packages still installed are taken from the old \a file_r (if any),
+       * only the headers of new packages are read from the rpmdb.
+       * \throws Exception on error
+       */
+      static void update( const Pathname & root_r, const std::string & cookie_r, const Pathname & file_r );
+
+      /** Write an index of \a entries_r built for \a cookie_r to \a file_r.
+       * \throws Exception on error
+       */
+      static void write( const std::vector<Entry> & entries_r, const std::string & cookie_r, const Pathname & file_r );
+
+    public:
+      /** \internal On disk layout of the file and dir tables. */
+      struct FileEntry;
+      struct DirEntry;
+
+    private:
+      const FileEntry * entries() const;
+      const DirEntry * dirs() const;
+      Entry entry( const FileEntry & fe_r ) const;
+      std::string_view string( std::uint32_t off_r, std::uint32_t len_r ) const
+      { return std::string_view( _strings + off_r, len_r ); }
+
+    private:
+      void * _map = nullptr;
+      std::size_t _mapsize = 0;
+      bool _valid = false;
+      std::string_view _cookie;
+      unsigned _nentries = 0;
+      unsigned _ndirs = 0;
+      unsigned _naliased = 0;
+      const char * _table = nullptr;
+      const char * _strings = nullptr;
+    };
+    ///////////////////////////////////////////////////////////////////
+
+    /** \relates InstalledFilesIndex Stream output */
+    std::ostream & operator<<( std::ostream & str, const InstalledFilesIndex & obj );
+
+    /** \relates InstalledFilesIndex::Entry Stream output */
+    std::ostream & operator<<( std::ostream & str, const InstalledFilesIndex::Entry & obj );
+
+  } // namespace target
+  ///////////////////////////////////////////////////////////////////
+} // namespace zypp
+///////////////////////////////////////////////////////////////////
+#endif // ZYPP_TARGET_INSTALLEDFILESINDEX_H
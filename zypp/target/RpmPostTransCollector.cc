@@ -12,7 +12,15 @@
 #include <fstream>
 #include <optional>
 #include <utility>
+#include <set>
+#include <unordered_map>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <poll.h>
 #include <zypp/base/LogTools.h>
+#include <zypp/base/ParallelFor.h>
 #include <zypp/base/NonCopyable.h>
 #include <zypp/base/Gettext.h>
 #include <zypp/base/Regex.h>
@@ -29,6 +37,7 @@
 #include <zypp/target/rpm/librpmDb.h>
 #include <zypp/ZConfig.h>
 #include <zypp/ZYppCallbacks.h>
+#include <zypp-core/zyppng/base/private/linuxhelpers_p.h>
 
 using std::endl;
 #undef ZYPP_BASE_LOGGER_LOGGROUP
@@ -52,6 +61,8 @@ namespace zypp
       /// <%posttrans script basename, pkgname> pairs.
       using ScriptList = std::list< std::pair<std::string,std::string> >;
 
+      using Clock = std::chrono::steady_clock;
+
       /// Data regarding the dumpfile used if `rpm --runposttrans` is supported
       struct Dumpfile
       {
@@ -240,39 +251,57 @@ namespace zypp
             str::Format fmtScriptFailedMsg { "warning: %%posttrans(%1%) scriptlet failed, exit status %2%\n" };
             str::Format fmtPosttrans { "%%posttrans(%1%)" };
 
-            rpm::librpmDb::db_const_iterator it;  // Open DB only once
-            while ( ! _scripts->empty() )
-            {
-              const auto &scriptPair = _scripts->front();
-              const std::string & script = scriptPair.first;
-              const std::string & pkgident( script.substr( 0, script.size()-6 ) ); // strip tmp file suffix[6]
-              startNewScript( fmtPosttrans % pkgident );
-
-              int npkgs = 0;
-              for ( it.findByName( scriptPair.second ); *it; ++it )
-                ++npkgs;
-
-              MIL << "EXECUTE posttrans: " << script << " with argument: " << npkgs << endl;
-              ExternalProgram::Arguments cmd {
-                "/bin/sh",
-                (noRootScriptDir/script).asString(),
-                str::numstring( npkgs )
-              };
-              ExternalProgram prog( cmd, ExternalProgram::Stderr_To_Stdout, false, -1, true, _root );
-
-              for( std::string line = prog.receiveLine(); ! line.empty(); line = prog.receiveLine() ) {
-                sendScriptOutput( line );
-              }
-              //script was executed, remove it from the list
-              _scripts->pop_front();
+            // A job is removed from _scripts once it was executed, so discardScripts
+            // still logs the remaining ones if we are aborted by an exception.
+            std::vector<ScriptJob> jobs { prepareScriptJobs() };
 
-              int ret = prog.close();
-              if ( ret != 0 )
+            // lambda to report an executed script
+            auto reportScriptJob = [&]( const ScriptJob & job_r ) -> void {
+              logScriptTime( historylog, fmtPosttrans % job_r._pkgident, job_r._elapsed );
+              if ( job_r._ret != 0 )
               {
-                std::string msg { fmtScriptFailedMsg % pkgident % ret };
+                std::string msg { fmtScriptFailedMsg % job_r._pkgident % job_r._ret };
                 WAR << msg;
                 sendScriptOutput( msg ); // info!, as rpm would have reported it.
               }
+            };
+
+            // lambda to report a script identical to an earlier one with the same argument (run just once)
+            auto reportDuplicate = [&]( const ScriptJob & job_r ) -> void {
+              startNewScript( fmtPosttrans % job_r._pkgident );
+              std::string msg { str::Format("%1% script is identical to %2% script, not executed again.")
+                                % (fmtPosttrans % job_r._pkgident) % (fmtPosttrans % jobs[job_r._duplicateOf]._pkgident) };
+              MIL << msg << endl;
+              historylog.comment( msg, true /*timestamp*/ );
+            };
+
+            for ( const auto & [begin,end] : scriptBatches( jobs ) )
+            {
+              if ( end - begin == 1 && jobs[begin]._duplicateOf < 0 && not jobs[begin]._parallel )
+              {
+                ScriptJob & job { jobs[begin] };
+                startNewScript( fmtPosttrans % job._pkgident );
+                runScriptJob( job, noRootScriptDir, sendScriptOutput );
+                _scripts->pop_front();
+                reportScriptJob( job );
+                continue;
+              }
+
+              runScriptJobsParallel( jobs.begin()+begin, jobs.begin()+end, noRootScriptDir );
+              _scripts->erase( _scripts->begin(), std::next( _scripts->begin(), end - begin ) );
+              for ( size_t idx = begin; idx < end; ++idx )
+              {
+                const ScriptJob & job { jobs[idx] };
+                if ( job._duplicateOf >= 0 )
+                {
+                  reportDuplicate( job );
+                  continue;
+                }
+                startNewScript( fmtPosttrans % job._pkgident );
+                for ( const std::string & line : job._output )
+                  sendScriptOutput( line );
+                reportScriptJob( job );
+              }
             }
             _scripts = std::nullopt;
           }
@@ -280,12 +309,27 @@ namespace zypp
           // ...then 'rpm --runposttrans'
           int res = 0;  // Indicate a failed call to rpm itself! (a failed script is just a warning)
           if ( _dumpfile ) {
+            // A script ends when rpm starts the next one.
+            std::string timedScript;
+            Clock::time_point timedStart;
+            auto finishTimedScript = [&]() -> void {
+              if ( not timedScript.empty() ) {
+                logScriptTime( historylog, timedScript, Clock::now() - timedStart );
+                timedScript.clear();
+              }
+            };
+
             res = rpm_r.runposttrans( _dumpfile->_dumpfile, [&] ( const std::string & line_r ) ->void {
-              if ( str::startsWith( line_r, "RIPOFF:" ) )
-                startNewScript( line_r.substr( 7 ) ); // new scripts ident sent by rpm
+              if ( str::startsWith( line_r, "RIPOFF:" ) ) {
+                finishTimedScript();
+                timedScript = line_r.substr( 7 );
+                timedStart = Clock::now();
+                startNewScript( timedScript ); // new scripts ident sent by rpm
+              }
               else
                 sendScriptOutput( line_r );
             } );
+            finishTimedScript();
             if ( res != 0 )
               _myJobReport.error( str::Format("rpm --runposttrans returned %1%.") % res );
 
@@ -333,6 +377,169 @@ namespace zypp
         }
 
       private:
+        /** Turn the collected \ref _scripts into planned \ref ScriptJob. */
+        std::vector<ScriptJob> prepareScriptJobs()
+        {
+          std::vector<ScriptJob> ret;
+          ret.reserve( _scripts->size() );
+
+          rpm::librpmDb::db_const_iterator it;  // Open DB only once
+          for ( const auto & [script,pkgname] : *_scripts )
+          {
+            ScriptJob & job { ret.emplace_back() };
+            job._script = script;
+            job._pkgident = script.substr( 0, script.size()-6 ); // strip tmp file suffix[6]
+            job._pkgname = pkgname;
+            for ( it.findByName( pkgname ); *it; ++it )
+              ++job._npkgs;
+            std::ifstream in( (tmpDir()/script).c_str() );
+            job._content.assign( std::istreambuf_iterator<char>( in ), std::istreambuf_iterator<char>() );
+          }
+
+          planScriptJobs( ret, ZConfig::instance().commit_parallelPosttrans() );
+          for ( const ScriptJob & job : ret )
+          {
+            MIL << "PREPARE posttrans: " << job._script << " with argument: " << job._npkgs
+                << ( job._parallel ? " (parallel)" : "" ) << ( job._duplicateOf >= 0 ? " duplicate of " : "" )
+                << ( job._duplicateOf >= 0 ? ret[job._duplicateOf]._script : "" ) << endl;
+          }
+          return ret;
+        }
+
+        /** Start \a job_r. */
+        std::unique_ptr<ExternalProgram> startScriptJob( const ScriptJob & job_r, const Pathname & noRootScriptDir_r ) const
+        {
+          MIL << "EXECUTE posttrans: " << job_r._script << " with argument: " << job_r._npkgs << endl;
+          ExternalProgram::Arguments cmd {
+            "/bin/sh",
+            (noRootScriptDir_r/job_r._script).asString(),
+            str::numstring( job_r._npkgs )
+          };
+          return std::make_unique<ExternalProgram>( cmd, ExternalProgram::Stderr_To_Stdout, false, -1, true, _root );
+        }
+
+        /** Execute \a job_r, passing the output lines to \a output_r. */
+        void runScriptJob( ScriptJob & job_r, const Pathname & noRootScriptDir_r, const std::function<void(const std::string &)> & output_r ) const
+        {
+          Clock::time_point start { Clock::now() };
+          try
+          {
+            std::unique_ptr<ExternalProgram> prog { startScriptJob( job_r, noRootScriptDir_r ) };
+            for( std::string line = prog->receiveLine(); ! line.empty(); line = prog->receiveLine() ) {
+              output_r( line );
+            }
+            job_r._ret = prog->close();
+          }
+          catch ( const Exception & excpt )
+          {
+            ZYPP_CAUGHT( excpt );
+            output_r( excpt.asUserString() + "\n" );
+            job_r._ret = -1;
+          }
+          job_r._elapsed = Clock::now() - start;
+        }
+
+        /** Execute the scripts in <tt>[begin_r,end_r)</tt> in parallel, buffering their output.
+         * Duplicates are skipped. At most 4 scripts run at the same time. All scripts are
+         * started from this thread, which polls their output until they are done.
+         */
+        void runScriptJobsParallel( std::vector<ScriptJob>::iterator begin_r, std::vector<ScriptJob>::iterator end_r, const Pathname & noRootScriptDir_r ) const
+        {
+          std::vector<ScriptJob*> todo;
+          for ( ; begin_r != end_r; ++begin_r )
+            if ( begin_r->_duplicateOf < 0 )
+              todo.push_back( &*begin_r );
+
+          unsigned maxrunning = std::min( base::parallelJobs( todo.size(), 1 ), 4U );
+          MIL << "EXECUTE " << todo.size() << " posttrans scripts, " << maxrunning << " at a time" << endl;
+
+          struct Running
+          {
+            ScriptJob * _job;
+            std::unique_ptr<ExternalProgram> _prog;
+            Clock::time_point _start;
+            std::string _line;	///< incomplete last line
+          };
+          std::vector<Running> running;
+
+          auto finish = []( Running & run_r ) -> void {
+            if ( not run_r._line.empty() )
+              run_r._job->_output.push_back( std::move(run_r._line) );
+            run_r._job->_ret = run_r._prog->close();
+            run_r._job->_elapsed = Clock::now() - run_r._start;
+          };
+
+          for ( size_t next = 0; next < todo.size() || not running.empty(); )
+          {
+            while ( running.size() < maxrunning && next < todo.size() )
+            {
+              ScriptJob & job { *todo[next++] };
+              Clock::time_point start { Clock::now() };
+              try
+              {
+                running.push_back( Running{ &job, startScriptJob( job, noRootScriptDir_r ), start, std::string() } );
+              }
+              catch ( const Exception & excpt )
+              {
+                ZYPP_CAUGHT( excpt );
+                job._output.push_back( excpt.asUserString() + "\n" );
+                job._ret = -1;
+                job._elapsed = Clock::now() - start;
+                continue;
+              }
+              if ( not running.back()._prog->inputFile() )	// failed to start
+              {
+                finish( running.back() );
+                running.pop_back();
+              }
+            }
+            if ( running.empty() )
+              continue;
+
+            std::vector<struct pollfd> fds;
+            for ( const Running & run : running )
+              fds.push_back( { ::fileno( run._prog->inputFile() ), POLLIN, 0 } );
+            if ( zyppng::eintrSafeCall( ::poll, fds.data(), fds.size(), -1 ) < 0 )
+            {
+              ERR << "poll failed: " << str::strerror( errno ) << endl;
+              for ( Running & run : running )
+                finish( run );	// waits for the script
+              running.clear();
+              continue;
+            }
+
+            for ( size_t idx = running.size(); idx--; )
+            {
+              if ( not fds[idx].revents )
+                continue;
+              Running & run { running[idx] };
+              char buf[4096];
+              ssize_t n = zyppng::eintrSafeCall( ::read, fds[idx].fd, buf, sizeof(buf) );
+              if ( n > 0 )
+              {
+                run._line.append( buf, n );
+                for ( std::string::size_type pos = run._line.find( '\n' ); pos != std::string::npos; pos = run._line.find( '\n' ) )
+                {
+                  run._job->_output.push_back( run._line.substr( 0, pos+1 ) );
+                  run._line.erase( 0, pos+1 );
+                }
+                continue;
+              }
+              // EOF or error: the script is done
+              finish( run );
+              running.erase( running.begin()+idx );
+            }
+          }
+        }
+
+        /** Log the execution time of a script (history and zypp log). */
+        static void logScriptTime( HistoryLog & historylog_r, const std::string & scriptident_r, Clock::duration elapsed_r )
+        {
+          auto ms { std::chrono::duration_cast<std::chrono::milliseconds>( elapsed_r ).count() };
+          MIL << "TIME " << scriptident_r << ": " << ms << "ms" << endl;
+          historylog_r.comment( str::Format("%1% script finished after %2% ms") % scriptident_r % ms, true /*timestamp*/ );
+        }
+
         /** Lazy create tmpdir on demand. */
         Pathname tmpDir()
         {
@@ -410,6 +617,42 @@ namespace zypp
     //
     ///////////////////////////////////////////////////////////////////
 
+    void RpmPostTransCollector::planScriptJobs( std::vector<ScriptJob> & jobs_r, const std::set<std::string> & parallelPkgs_r )
+    {
+      std::unordered_map<std::string,int> seen;  // script content and argument -> index in jobs_r
+      for ( size_t idx = 0; idx < jobs_r.size(); ++idx )
+      {
+        ScriptJob & job { jobs_r[idx] };
+        job._parallel = parallelPkgs_r.count( job._pkgname );
+
+        std::string key { job._content };
+        key += '\0';
+        key += str::numstring( job._npkgs );
+        const auto & [pos,isnew] { seen.emplace( std::move(key), int(idx) ) };
+        job._duplicateOf = isnew ? -1 : pos->second;
+      }
+    }
+
+    std::vector<std::pair<size_t,size_t>> RpmPostTransCollector::scriptBatches( const std::vector<ScriptJob> & jobs_r )
+    {
+      // Duplicates are not executed, so they don't break a batch.
+      auto batchable = []( const ScriptJob & job_r ) -> bool { return job_r._parallel || job_r._duplicateOf >= 0; };
+
+      std::vector<std::pair<size_t,size_t>> ret;
+      for ( size_t begin = 0; begin < jobs_r.size(); )
+      {
+        size_t end = begin + 1;
+        if ( batchable( jobs_r[begin] ) )
+        {
+          while ( end < jobs_r.size() && batchable( jobs_r[end] ) )
+            ++end;
+        }
+        ret.push_back( { begin, end } );
+        begin = end;
+      }
+      return ret;
+    }
+
     RpmPostTransCollector::RpmPostTransCollector( Pathname root_r )
       : _pimpl( new Impl( std::move(root_r) ) )
     {}
@@ -12,6 +12,11 @@
 #define ZYPP_TARGET_RPMPOSTTRANSCOLLECTOR_H
 
 #include <iosfwd>
+#include <string>
+#include <vector>
+#include <set>
+#include <utility>
+#include <chrono>
 
 #include <zypp/base/PtrTypes.h>
 #include <zypp/Pathname.h>
@@ -57,12 +62,44 @@ namespace zypp
         /** \overload 'remove' does not trigger a %posttrans, but it may trigger %transfiletriggers. */
         void collectPosttransInfo( const std::vector<std::string> & runposttrans_r );
 
-        /** Execute the remembered scripts and/or or dump_posttrans lines. */
+        /** Execute the remembered scripts and/or or dump_posttrans lines.
+         * Identical scripts are executed just once. Consecutive scripts of packages
+         * listed in \ref ZConfig::commit_parallelPosttrans are executed in parallel.
+         * The execution time of each script is written to the \ref HistoryLog.
+         */
         void executeScripts( rpm::RpmDb & rpm_r );
 
         /** Discard all remembered scripts and/or or dump_posttrans lines. */
         void discardScripts();
 
+      public:
+        /** \internal A collected %posttrans script prepared for execution. */
+        struct ScriptJob
+        {
+          std::string _script;          ///< script basename
+          std::string _pkgident;        ///< script basename without tmp file suffix
+          std::string _pkgname;         ///< the package providing the script
+          std::string _content;         ///< the script itself
+          int _npkgs = 0;               ///< argument passed to the script
+          bool _parallel = false;       ///< may run in parallel to other such scripts
+          int _duplicateOf = -1;        ///< index of an identical earlier script, if not executed
+
+          int _ret = 0;                                 ///< exit status
+          std::chrono::steady_clock::duration _elapsed {}; ///< execution time
+          std::vector<std::string> _output;             ///< buffered output if executed in parallel
+        };
+
+        /** \internal Mark the \a jobs_r which are identical to an earlier one (same content
+         * and argument) as duplicate, and those of packages in \a parallelPkgs_r as parallel.
+         */
+        static void planScriptJobs( std::vector<ScriptJob> & jobs_r, const std::set<std::string> & parallelPkgs_r );
+
+        /** \internal Split the planned \a jobs_r into batches <tt>[begin,end)</tt>, executed in order.
+         * A batch is either a single script executed on its own, or a run of consecutive
+         * parallel (or duplicate) scripts which may be executed at the same time.
+         */
+        static std::vector<std::pair<size_t,size_t>> scriptBatches( const std::vector<ScriptJob> & jobs_r );
+
       public:
         class Impl;              ///< Implementation class.
       private:
@@ -15,6 +15,7 @@
 #include <string>
 #include <list>
 #include <set>
+#include <algorithm>
 
 #include <sys/types.h>
 #include <dirent.h>
@@ -24,6 +25,7 @@
 #include <zypp/base/Iterator.h>
 #include <zypp/base/Gettext.h>
 #include <zypp/base/IOStream.h>
+#include <zypp/base/Measure.h>
 #include <zypp/base/Functional.h>
 #include <zypp-core/base/UserRequestException>
 #include <zypp/base/Json.h>
@@ -39,6 +41,7 @@
 #include <zypp/RepoStatus.h>
 #include <zypp/ExternalProgram.h>
 #include <zypp/Repository.h>
+#include <zypp/pool/EstablishCache.h>
 #include <zypp-core/ShutdownLock_p.h>
 
 #include <zypp/ResFilters.h>
@@ -47,6 +50,7 @@
 #include <zypp/target/TargetCallbackReceiver.h>
 #include <zypp/target/rpm/librpmDb.h>
 #include <zypp/target/CommitPackageCache.h>
+#include <zypp/target/CommitHeaps.h>
 #include <zypp/target/RpmPostTransCollector.h>
 
 #include <zypp/parser/ProductFileReader.h>
@@ -67,10 +71,13 @@
 #include <zypp-core/zyppng/rpc/stompframestream.h>
 #include <zypp-core/zyppng/base/private/linuxhelpers_p.h>
 #include <zypp-core/zyppng/base/EventDispatcher>
+#include <zypp-core/zyppng/base/Timer>
 
 #include <shared/commit/CommitMessages.h>
+#include <shared/commit/ProgressRing.h>
 
 #include <zypp/target/rpm/RpmException.h>
+#include <zypp/target/InstalledFilesIndex.h>
 
 #include <zypp/PluginExecutor.h>
 
@@ -81,6 +88,13 @@
 #include <optional>
 
 namespace zypp::env {
+  /** Build the @System solv file calling the external rpmdb2solv tool. */
+  inline bool ZYPP_RPMDB2SOLV()
+  {
+    static bool val = ::getenv( "ZYPP_RPMDB2SOLV" );
+    return val;
+  }
+
   inline bool TRANSACTIONAL_UPDATE()
   {
     static bool val = [](){
@@ -97,6 +111,9 @@ using std::endl;
 extern "C"
 {
 #include <solv/repo_rpmdb.h>
+#include <solv/repo_products.h>
+#include <solv/repo_autopattern.h>
+#include <solv/repo_write.h>
 #include <solv/chksum.h>
 }
 namespace zypp
@@ -106,6 +123,7 @@ namespace zypp
     inline std::string rpmDbStateHash( const Pathname & root_r )
     {
       std::string ret;
+      std::lock_guard<std::recursive_mutex> guard( rpm::librpmDb::globalLock() );
       AutoDispose<void*> state { ::rpm_state_create( sat::Pool::instance().get(), root_r.c_str() ), ::rpm_state_free };
       AutoDispose<Chksum*> chk { ::solv_chksum_create( REPOKEY_TYPE_SHA1 ), []( Chksum *chk ) -> void {
         ::solv_chksum_free( chk, nullptr );
@@ -124,6 +142,69 @@ namespace zypp
     inline RepoStatus rpmDbRepoStatus( const Pathname & root_r )
     { return RepoStatus( rpmDbStateHash( root_r ), Date() ); }
 
+    /** system-hook: Notify the plugins that the set of installed packages has changed. */
+    inline void sendPackageSetChanged()
+    {
+      PluginExecutor plugins;
+      plugins.load( ZConfig::instance().pluginsPath()/"system" );
+      if ( plugins )
+        plugins.send( PluginFrame( "PACKAGESETCHANGED" ) );
+    }
+
+    /** Whether \ref rpmdb2solvInProcess reads the rpmdb at \a dbPath_r.
+     * Libsolv can't be told the dbpath, it uses rpm's current \c %_dbpath macro.
+     * If it differs, <tt>rpmdb2solv -D</tt> must be used instead.
+     */
+    inline bool rpmdb2solvInProcessUsable( const Pathname & dbPath_r )
+    {
+      Pathname macro { rpm::librpmDb::expand( "%{_dbpath}" ) };
+      if ( macro == dbPath_r )
+        return true;
+      MIL << "rpm %_dbpath " << macro << " is not " << dbPath_r << ": using rpmdb2solv" << endl;
+      return false;
+    }
+
+    /** Build the @System solv file \a solv_r in-process, like <tt>rpmdb2solv -X -p proddir_r [oldSolv_r]</tt>.
+     * Libsolv takes the data of all headers whose rpmdb instance id is still
+     * present from \a oldSolv_r, so only the headers added since then are read
+     * from the rpmdb. Callers must check \ref rpmdb2solvInProcessUsable first.
+     * \throws Exception on error
+     */
+    inline void rpmdb2solvInProcess( const Pathname & root_r, const Pathname & proddir_r, const Pathname & oldSolv_r, const Pathname & solv_r )
+    {
+      debug::Measure m( "rpmdb2solv (in-process)" );
+      AutoDispose<::Pool*> pool { ::pool_create(), ::pool_free };
+      if ( ! root_r.empty() )
+        ::pool_set_rootdir( pool, root_r.c_str() );
+      ::Repo * repo = ::repo_create( pool, "@System" );
+      ::Repodata * data = ::repo_add_repodata( repo, 0 );
+
+      AutoFILE reffp { oldSolv_r.empty() ? nullptr : ::fopen( oldSolv_r.c_str(), "re" ) };
+      if ( ! reffp && ! oldSolv_r.empty() )
+        WAR << "Can't open reference " << oldSolv_r << ": " << str::strerror( errno ) << endl;
+
+      if ( ::repo_add_rpmdb_reffp( repo, reffp, REPO_USE_ROOTDIR | REPO_REUSE_REPODATA | REPO_NO_INTERNALIZE ) != 0 )
+        ZYPP_THROW( Exception( str::Str() << "Failed to read rpm database: " << ::pool_errstr( pool ) ) );
+
+      if ( PathInfo( proddir_r ).isDir()
+           && ::repo_add_products( repo, proddir_r.c_str(), REPO_REUSE_REPODATA | REPO_NO_INTERNALIZE ) != 0 )
+        ZYPP_THROW( Exception( str::Str() << "Failed to read products: " << ::pool_errstr( pool ) ) );
+
+      ::repodata_internalize( data );
+      ::repo_add_autopattern( repo, ADD_NO_AUTOPRODUCTS );	// like rpmdb2solv -X
+
+      AutoFILE outfp { ::fopen( solv_r.c_str(), "we" ) };
+      if ( ! outfp )
+        ZYPP_THROW( Exception( str::Str() << "Can't open " << solv_r << ": " << str::strerror( errno ) ) );
+      if ( ::repo_write( repo, outfp ) != 0 )
+        ZYPP_THROW( Exception( str::Str() << "Failed to write " << solv_r << ": " << ::pool_errstr( pool ) ) );
+      FILE * fp = outfp.value();
+      outfp.resetDispose();
+      if ( ::fclose( fp ) != 0 )
+        ZYPP_THROW( Exception( str::Str() << "Failed to write " << solv_r << ": " << str::strerror( errno ) ) );
+      MIL << "Wrote " << solv_r << ": " << repo->nsolvables << " solvables" << endl;
+    }
+
   } // namespace target
 } // namespace
 ///////////////////////////////////////////////////////////////////
@@ -987,6 +1068,8 @@ namespace zypp
     //
     TargetImpl::~TargetImpl()
     {
+      waitForBuildCacheAsync();
+      pool::EstablishCache::forPool( ResPool::instance() ).save();
       _rpm.closeDatabase();
       sigMultiversionSpecChanged();	// HACK: see sigMultiversionSpecChanged
       MIL << "Closed target on " << _root << endl;
@@ -1003,14 +1086,19 @@ namespace zypp
       return Pathname::assertprefix( _root, ZConfig::instance().repoSolvfilesPath() / sat::Pool::instance().systemRepoAlias() );
     }
 
+    std::string TargetImpl::rpmDbCookie() const
+    { return rpmDbStateHash( _root ); }
+
     void TargetImpl::clearCache()
     {
+      waitForBuildCacheAsync();
       Pathname base = solvfilesPath();
       filesystem::recursive_rmdir( base );
     }
 
     bool TargetImpl::buildCache()
     {
+      waitForBuildCacheAsync();
       Pathname base = solvfilesPath();
       Pathname rpmsolv       = base/"solv";
       Pathname rpmsolvcookie = base/"cookie";
@@ -1085,47 +1173,66 @@ namespace zypp
         // Take care we unlink the solvfile on exception
         ManagedFile guard( base, filesystem::recursive_rmdir );
 
-        ExternalProgram::Arguments cmd;
+        int ret = 0;
+        bool built = false;
+        if ( ! env::ZYPP_RPMDB2SOLV() && rpmdb2solvInProcessUsable( rpm().dbPath() ) )
+        {
+          try
+          {
+            rpmdb2solvInProcess( _root, Pathname::assertprefix( _root, "/etc/products.d" ), oldSolvFile, tmpsolv.path() );
+            built = true;
+          }
+          catch ( const Exception & excpt )
+          {
+            ZYPP_CAUGHT( excpt );
+            WAR << "In-process rpmdb conversion failed. Trying rpmdb2solv..." << endl;
+          }
+        }
+
+        if ( ! built )
+        {
+          ExternalProgram::Arguments cmd;
 #ifdef ZYPP_RPMDB2SOLV_PATH
-        cmd.push_back( ZYPP_RPMDB2SOLV_PATH );
+          cmd.push_back( ZYPP_RPMDB2SOLV_PATH );
 #else
-        cmd.push_back( "rpmdb2solv" );
+          cmd.push_back( "rpmdb2solv" );
 #endif
-        if ( ! _root.empty() ) {
-          cmd.push_back( "-r" );
-          cmd.push_back( _root.asString() );
-        }
-        cmd.push_back( "-D" );
-        cmd.push_back( rpm().dbPath().asString() );
-        cmd.push_back( "-X" );	// autogenerate pattern/product/... from -package
-        // bsc#1104415: no more application support // cmd.push_back( "-A" );	// autogenerate application pseudo packages
-        cmd.push_back( "-p" );
-        cmd.push_back( Pathname::assertprefix( _root, "/etc/products.d" ).asString() );
-
-        if ( ! oldSolvFile.empty() )
-          cmd.push_back( oldSolvFile.asString() );
-
-        cmd.push_back( "-o" );
-        cmd.push_back( tmpsolv.path().asString() );
-
-        ExternalProgram prog( cmd, ExternalProgram::Stderr_To_Stdout );
-        std::string errdetail;
-
-        for ( std::string output( prog.receiveLine() ); output.length(); output = prog.receiveLine() ) {
-          WAR << "  " << output;
-          if ( errdetail.empty() ) {
-            errdetail = prog.command();
-            errdetail += '\n';
+          if ( ! _root.empty() ) {
+            cmd.push_back( "-r" );
+            cmd.push_back( _root.asString() );
+          }
+          cmd.push_back( "-D" );
+          cmd.push_back( rpm().dbPath().asString() );
+          cmd.push_back( "-X" );	// autogenerate pattern/product/... from -package
+          // bsc#1104415: no more application support // cmd.push_back( "-A" );	// autogenerate application pseudo packages
+          cmd.push_back( "-p" );
+          cmd.push_back( Pathname::assertprefix( _root, "/etc/products.d" ).asString() );
+
+          if ( ! oldSolvFile.empty() )
+            cmd.push_back( oldSolvFile.asString() );
+
+          cmd.push_back( "-o" );
+          cmd.push_back( tmpsolv.path().asString() );
+
+          ExternalProgram prog( cmd, ExternalProgram::Stderr_To_Stdout );
+          std::string errdetail;
+
+          for ( std::string output( prog.receiveLine() ); output.length(); output = prog.receiveLine() ) {
+            WAR << "  " << output;
+            if ( errdetail.empty() ) {
+              errdetail = prog.command();
+              errdetail += '\n';
+            }
+            errdetail += output;
           }
-          errdetail += output;
-        }
 
-        int ret = prog.close();
-        if ( ret != 0 )
-        {
-          Exception ex(str::form("Failed to cache rpm database (%d).", ret));
-          ex.remember( errdetail );
-          ZYPP_THROW(ex);
+          ret = prog.close();
+          if ( ret != 0 )
+          {
+            Exception ex(str::form("Failed to cache rpm database (%d).", ret));
+            ex.remember( errdetail );
+            ZYPP_THROW(ex);
+          }
         }
 
         ret = filesystem::rename( tmpsolv, rpmsolv );
@@ -1142,12 +1249,7 @@ namespace zypp
 
         // system-hook: Finally send notification to plugins
         if ( root() == "/" )
-        {
-          PluginExecutor plugins;
-          plugins.load( ZConfig::instance().pluginsPath()/"system" );
-          if ( plugins )
-            plugins.send( PluginFrame( "PACKAGESETCHANGED" ) );
-        }
+          sendPackageSetChanged();
       }
       else
       {
@@ -1158,6 +1260,85 @@ namespace zypp
       return build_rpm_solv;
     }
 
+    void TargetImpl::buildCacheAsync()
+    {
+      waitForBuildCacheAsync();
+      if ( env::ZYPP_RPMDB2SOLV() || solvfilesPathIsTemp() || ! rpmdb2solvInProcessUsable( rpm().dbPath() ) )
+      {
+        buildCache();
+        return;
+      }
+
+      Pathname base = solvfilesPath();
+      Pathname rpmsolv       = base/"solv";
+      Pathname rpmsolvcookie = base/"cookie";
+      Pathname proddir       = Pathname::assertprefix( _root, "/etc/products.d" );
+      Pathname indexfile     = installedFilesIndexPath();
+
+      std::string rpmdbcookie { rpmDbCookie() };
+      RepoStatus rpmstatus( RepoStatus( rpmdbcookie, Date() ) && RepoStatus(proddir) );
+      if ( PathInfo(rpmsolv).isExist() && RepoStatus::fromCookieFile(rpmsolvcookie) == rpmstatus )
+        return;	// uptodate
+
+      // Only the headers installed since the solv file was written are read
+      // from the rpmdb. The cookie is written last, so if anything fails, the
+      // next buildCache will notice the outdated solv file and rebuild it.
+      MIL << "Updating " << rpmsolv << " in the background" << endl;
+      _buildCacheAsync = std::async( std::launch::async, [root=_root,base,rpmsolv,rpmsolvcookie,proddir,indexfile,rpmdbcookie,rpmstatus]() -> bool {
+        std::lock_guard<std::recursive_mutex> guard( rpm::librpmDb::globalLock() );
+        // Keep the installed files index (if used) up to date as well.
+        if ( PathInfo(indexfile).isExist() )
+        {
+          try
+          {
+            InstalledFilesIndex::update( root, rpmdbcookie, indexfile );
+          }
+          catch ( const Exception & excpt )
+          {
+            ZYPP_CAUGHT( excpt );
+          }
+        }
+
+        try
+        {
+          filesystem::assert_dir( base );
+          filesystem::TmpFile tmpsolv( filesystem::TmpFile::makeSibling( rpmsolv ) );
+          if ( ! tmpsolv )
+            ZYPP_THROW( Exception( str::form( "Cannot create temporary file under %s.", base.c_str() ) ) );
+
+          rpmdb2solvInProcess( root, proddir, PathInfo(rpmsolv).isExist() ? rpmsolv : Pathname(), tmpsolv.path() );
+
+          if ( filesystem::rename( tmpsolv, rpmsolv ) != 0 )
+            ZYPP_THROW( Exception( "Failed to move cache to final destination" ) );
+          // if this fails, don't bother throwing exceptions
+          filesystem::chmod( rpmsolv, 0644 );
+
+          rpmstatus.saveToCookieFile( rpmsolvcookie );
+          sat::updateSolvFileIndex( rpmsolv );	// content digest for zypper bash completion
+          MIL << "Background update of " << rpmsolv << " done" << endl;
+          return true;
+        }
+        catch ( const Exception & excpt )
+        {
+          ZYPP_CAUGHT( excpt );
+          WAR << "Background update of " << rpmsolv << " failed. It will be rebuilt on next load." << endl;
+        }
+        return false;
+      } );
+    }
+
+    void TargetImpl::waitForBuildCacheAsync() const
+    {
+      if ( _buildCacheAsync.valid() )
+      {
+        MIL << "Waiting for the background solv file update..." << endl;
+        // system-hook: Like buildCache, notify the plugins once the solv file is written.
+        // Plugins are not run from within the worker thread.
+        if ( _buildCacheAsync.get() && root() == "/" )
+          sendPackageSetChanged();
+      }
+    }
+
     void TargetImpl::reload()
     {
         load( false );
@@ -1165,6 +1346,7 @@ namespace zypp
 
     void TargetImpl::unload()
     {
+      pool::EstablishCache::forPool( ResPool::instance() ).save();
       Repository system( sat::Pool::instance().findSystemRepo() );
       if ( system )
         system.eraseFromPool();
@@ -1217,6 +1399,11 @@ namespace zypp
       }
       satpool.rootDir( _root );
 
+      // Established states of Patches etc. are cached along with the solv file.
+      // They are written by unload, commit and when the target is closed.
+      pool::EstablishCache::forPool( ResPool::instance() ).setPersistent( solvfilesPath() / "established",
+                                                                          RepoStatus::fromCookieFile( solvfilesPath() / "cookie" ) );
+
       // (Re)Load the requested locales et al.
       // If the requested locales are empty, we leave the pool untouched
       // to avoid undoing changes the application applied. We expect this
@@ -1313,6 +1500,14 @@ namespace zypp
       bool explicitDryRun = policy_r.dryRun();	// explicit dry run will trigger a fileconflict check, implicit (download-only) not.
 
       ShutdownLock lck("zypp", "Zypp commit running.");
+      waitForBuildCacheAsync();	// don't let rpm modify the database while we read it
+
+      // The established states still match the loaded @System cookie; save them
+      // before the commit changes it, and don't persist them until the next load.
+      pool::EstablishCache & establishCache( pool::EstablishCache::forPool( pool_r ) );
+      establishCache.save();
+      if ( ! policy_r.dryRun() )
+        establishCache.setPersistent( Pathname(), RepoStatus() );
 
       // Fake outstanding YCP fix: Honour restriction to media 1
       // at installation, but install all remaining packages if post-boot.
@@ -1464,12 +1659,10 @@ namespace zypp
         packageCache.setCommitList( steps.begin(), steps.end() );
 
         bool miss = false;
-        if ( policy_r.downloadMode() != DownloadAsNeeded  )
-        {
-          // Preload the cache. Until now this means pre-loading all packages.
-          // Once DownloadInHeaps is fully implemented, this will change and
-          // we may actually have more than one heap.
-          for_( it, steps.begin(), steps.end() )
+        // Preload the cache with the packages of steps [begin_r,end_r).
+        const auto & preloadCache = [&]( ZYppCommitResult::TransactionStepList::iterator begin_r,
+                                         ZYppCommitResult::TransactionStepList::iterator end_r ) {
+          for_( it, begin_r, end_r )
           {
             switch ( it->stepType() )
             {
@@ -1522,12 +1715,79 @@ namespace zypp
             }
           }
           packageCache.preloaded( true ); // try to avoid duplicate infoInCache CBs in commit
-        }
+        };
+
+        // DownloadInHeaps: If the packages exceed the download budget, the transaction
+        // is split into heaps. Each heap is downloaded and committed before the next one.
+        std::vector<std::size_t> heapEnds { steps.size() };
+        if ( policy_r.downloadMode() == DownloadInHeaps && ! policy_r.dryRun() )
+          heapEnds = computeCommitHeaps( steps, result.transaction(), ZConfig::instance().commit_downloadHeapSize() );
+
+        if ( policy_r.downloadMode() != DownloadAsNeeded && heapEnds.size() == 1 )
+          preloadCache( steps.begin(), steps.end() );
 
         if ( miss )
         {
           ERR << "Some packages could not be provided. Aborting commit."<< endl;
         }
+        else if ( heapEnds.size() > 1 )
+        {
+          MIL << "Commit in " << heapEnds.size() << " heaps of " << ZConfig::instance().commit_downloadHeapSize() << endl;
+          if ( ! policy_r.singleTransModeEnabled() )
+            commitFindFileConflicts( policy_r, result );	// as in DownloadAsNeeded mode
+
+          // steps is the todo-list of the commit helpers, so it holds the current heap.
+          // Installed package files are removed from the cache (unless the repo keeps
+          // them), so each heap finds the space of the previous one free.
+          ZYppCommitResult::TransactionStepList allSteps;
+          allSteps.swap( steps );
+          std::size_t heapBegin = 0;
+          for ( std::size_t heap = 0; heap < heapEnds.size(); ++heap )
+          {
+            steps.assign( allSteps.begin() + heapBegin, allSteps.begin() + heapEnds[heap] );
+            heapBegin = heapEnds[heap];
+            MIL << "Commit heap " << heap+1 << "/" << heapEnds.size() << ": " << steps.size() << " steps" << endl;
+
+            packageCache.setCommitList( steps.begin(), steps.end() );
+            try
+            {
+              preloadCache( steps.begin(), steps.end() );
+            }
+            catch ( const TargetAbortedException & excpt_r )
+            {
+              if ( heap )	// log what the previous heaps did
+                logPatchStatusChanges( result.transaction(), *this );
+              ZYPP_RETHROW( excpt_r );
+            }
+            if ( miss )
+            {
+              ERR << "Some packages could not be provided. Aborting commit."<< endl;
+              if ( heap )
+                logPatchStatusChanges( result.transaction(), *this );
+              break;
+            }
+
+            bool lastHeap = ( heap+1 == heapEnds.size() );
+            try
+            {
+              if ( policy_r.singleTransModeEnabled() )
+                commitInSingleTransaction( policy_r, packageCache, result, lastHeap );
+              else
+                commit( policy_r, packageCache, result, lastHeap );
+            }
+            catch ( const TargetAbortedException & excpt_r )
+            {
+              ZYPP_RETHROW( excpt_r );	// the commit helper logged the patch status changes
+            }
+            catch ( const Exception & excpt_r )
+            {
+              if ( heap )	// log what the previous heaps did
+                logPatchStatusChanges( result.transaction(), *this );
+              ZYPP_RETHROW( excpt_r );
+            }
+          }
+          steps.swap( allSteps );
+        }
         else
         {
           if ( ! policy_r.dryRun() )
@@ -1584,10 +1844,14 @@ namespace zypp
 
       ///////////////////////////////////////////////////////////////////
       // Try to rebuild solv file while rpm database is still in cache
+      // (in the background unless the pool is reloaded right away)
       ///////////////////////////////////////////////////////////////////
       if ( ! policy_r.dryRun() )
       {
-        buildCache();
+        if ( policy_r.syncPoolAfterCommit() )
+          buildCache();
+        else
+          buildCacheAsync();
       }
 
       MIL << "TargetImpl::commit(<pool>, " << policy_r << ") returns: " << result << endl;
@@ -1615,7 +1879,8 @@ namespace zypp
 
     void TargetImpl::commit( const ZYppCommitPolicy & policy_r,
                              CommitPackageCache & packageCache_r,
-                             ZYppCommitResult & result_r )
+                             ZYppCommitResult & result_r,
+                             bool lastHeap_r )
     {
       // steps: this is our todo-list
       ZYppCommitResult::TransactionStepList & steps( result_r.rTransactionStepList() );
@@ -1894,8 +2159,10 @@ namespace zypp
 
       // jsc#SLE-5116: Log patch status changes to history
       // NOTE: Should be the last action as it may need to reload
-      // the Target in case of an incomplete transaction.
-      logPatchStatusChanges( result_r.transaction(), *this );
+      // the Target in case of an incomplete transaction. Committing
+      // in heaps, it's done after the last one.
+      if ( lastHeap_r || abort )
+        logPatchStatusChanges( result_r.transaction(), *this );
 
       if ( abort )
       {
@@ -1958,7 +2225,7 @@ namespace zypp
     const callback::UserData::ContentType rpm::TransactionReportSA::contentRpmout( "zypp-rpm","transactionsa" );
     const callback::UserData::ContentType rpm::CleanupPackageReportSA::contentRpmout( "zypp-rpm","cleanupkgsa" );
 
-    void TargetImpl::commitInSingleTransaction(const ZYppCommitPolicy &policy_r, CommitPackageCache &packageCache_r, ZYppCommitResult &result_r)
+    void TargetImpl::commitInSingleTransaction(const ZYppCommitPolicy &policy_r, CommitPackageCache &packageCache_r, ZYppCommitResult &result_r, bool lastHeap_r)
     {
       SendSingleTransReport report; // active throughout the whole rpm transaction
 
@@ -2007,94 +2274,121 @@ namespace zypp
         data.clear();
       });
 
-      // fill the transaction
-      for ( int stepId = 0; (ZYppCommitResult::TransactionStepList::size_type)stepId < steps.size() && !abort ; ++stepId ) {
-        auto &step = steps[stepId];
-        PoolItem citem( step );
-        if ( step.stepType() == sat::Transaction::TRANSACTION_IGNORE ) {
-          if ( citem->isKind<Package>() )
-          {
-            // for packages this means being obsoleted (by rpm)
-            // thius no additional action is needed.
-            step.stepStage( sat::Transaction::STEP_DONE );
-            continue;
+      // fill the transaction: provides the packages (unless preloaded) and passes the
+      // steps to addStep_r. Stops if addStep_r returns false.
+      const auto &fillTransaction = [&]( const std::function<bool( proto::target::TransactionStep && )> &addStep_r ) {
+        for ( int stepId = 0; (ZYppCommitResult::TransactionStepList::size_type)stepId < steps.size() && !abort ; ++stepId ) {
+          auto &step = steps[stepId];
+          PoolItem citem( step );
+          if ( step.stepType() == sat::Transaction::TRANSACTION_IGNORE ) {
+            if ( citem->isKind<Package>() )
+            {
+              // for packages this means being obsoleted (by rpm)
+              // thius no additional action is needed.
+              step.stepStage( sat::Transaction::STEP_DONE );
+              continue;
+            }
           }
-        }
 
-        if ( citem->isKind<Package>() ) {
-          Package::constPtr p = citem->asKind<Package>();
-          if ( citem.status().isToBeInstalled() )
-          {
+          if ( citem->isKind<Package>() ) {
+            Package::constPtr p = citem->asKind<Package>();
+            if ( citem.status().isToBeInstalled() )
+            {
+              try {
+                locCache.value()[stepId] = packageCache_r.get( citem );
+
+                proto::target::InstallStep tStep;
+                tStep.stepId        = stepId;
+                tStep.pathname      = locCache.value()[stepId]->asString();
+                tStep.multiversion  = p->multiversionInstall() ;
+
+                if ( !addStep_r( std::move(tStep) ) )
+                  return;
+              }
+              catch ( const AbortRequestException &e )
+              {
+                WAR << "commit aborted by the user" << endl;
+                abort = true;
+                step.stepStage( sat::Transaction::STEP_ERROR );
+                break;
+              }
+              catch ( const SkipRequestException &e )
+              {
+                ZYPP_CAUGHT( e );
+                WAR << "Skipping package " << p << " in commit" << endl;
+                step.stepStage( sat::Transaction::STEP_ERROR );
+                continue;
+              }
+              catch ( const Exception &e )
+              {
+                // bnc #395704: missing catch causes abort.
+                // TODO see if packageCache fails to handle errors correctly.
+                ZYPP_CAUGHT( e );
+                INT << "Unexpected Error: Skipping package " << p << " in commit" << endl;
+                step.stepStage( sat::Transaction::STEP_ERROR );
+                continue;
+              }
+            } else {
+
+              proto::target::RemoveStep tStep;
+              tStep.stepId  = stepId;
+              tStep.name    = p->name();
+              tStep.version = p->edition().version();
+              tStep.release = p->edition().release();
+              tStep.arch    = p->arch().asString();
+              if ( !addStep_r( std::move(tStep) ) )
+                return;
+
+            }
+          } else if ( citem->isKind<SrcPackage>() && citem.status().isToBeInstalled() ) {
+            // SrcPackage is install-only
+            SrcPackage::constPtr p = citem->asKind<SrcPackage>();
+
             try {
-              locCache.value()[stepId] = packageCache_r.get( citem );
+              // provide on local disk
+              locCache.value()[stepId] = provideSrcPackage( p );
 
               proto::target::InstallStep tStep;
               tStep.stepId        = stepId;
               tStep.pathname      = locCache.value()[stepId]->asString();
-              tStep.multiversion  = p->multiversionInstall() ;
+              tStep.multiversion  = false;
+              if ( !addStep_r( std::move(tStep) ) )
+                return;
 
-              commit.transactionSteps.push_back( std::move(tStep) );
-            }
-            catch ( const AbortRequestException &e )
-            {
-              WAR << "commit aborted by the user" << endl;
-              abort = true;
-              step.stepStage( sat::Transaction::STEP_ERROR );
-              break;
-            }
-            catch ( const SkipRequestException &e )
-            {
-              ZYPP_CAUGHT( e );
-              WAR << "Skipping package " << p << " in commit" << endl;
-              step.stepStage( sat::Transaction::STEP_ERROR );
-              continue;
-            }
-            catch ( const Exception &e )
-            {
-              // bnc #395704: missing catch causes abort.
-              // TODO see if packageCache fails to handle errors correctly.
+            }  catch ( const Exception &e ) {
               ZYPP_CAUGHT( e );
               INT << "Unexpected Error: Skipping package " << p << " in commit" << endl;
               step.stepStage( sat::Transaction::STEP_ERROR );
               continue;
             }
-          } else {
-
-            proto::target::RemoveStep tStep;
-            tStep.stepId  = stepId;
-            tStep.name    = p->name();
-            tStep.version = p->edition().version();
-            tStep.release = p->edition().release();
-            tStep.arch    = p->arch().asString();
-            commit.transactionSteps.push_back(std::move(tStep));
-
-          }
-        } else if ( citem->isKind<SrcPackage>() && citem.status().isToBeInstalled() ) {
-          // SrcPackage is install-only
-          SrcPackage::constPtr p = citem->asKind<SrcPackage>();
-
-          try {
-            // provide on local disk
-            locCache.value()[stepId] = provideSrcPackage( p );
-
-            proto::target::InstallStep tStep;
-            tStep.stepId        = stepId;
-            tStep.pathname      = locCache.value()[stepId]->asString();
-            tStep.multiversion  = false;
-            commit.transactionSteps.push_back(std::move(tStep));
-
-          }  catch ( const Exception &e ) {
-            ZYPP_CAUGHT( e );
-            INT << "Unexpected Error: Skipping package " << p << " in commit" << endl;
-            step.stepStage( sat::Transaction::STEP_ERROR );
-            continue;
           }
         }
+      };
+
+      // If the packages are downloaded as needed, zypp-rpm is started right away and receives
+      // the steps while the remaining packages are still downloading (streamed commit). It reads
+      // the headers and fills the rpm transaction meanwhile, so it is ready to run as soon as
+      // the last package arrives.
+      const auto &isCommitStep = []( const sat::Transaction::Step &step_r ) {
+        PoolItem citem( step_r );
+        if ( citem->isKind<Package>() )
+          return step_r.stepType() != sat::Transaction::TRANSACTION_IGNORE;
+        return citem->isKind<SrcPackage>() && citem.status().isToBeInstalled();
+      };
+
+      if ( !packageCache_r.preloaded() && std::any_of( steps.begin(), steps.end(), isCommitStep ) ) {
+        commit.streamed  = true;
+        commit.stepCount = steps.size();
+      } else {
+        fillTransaction( [&]( proto::target::TransactionStep &&tStep ) {
+          commit.transactionSteps.push_back( std::move(tStep) );
+          return true;
+        });
       }
 
       std::vector<sat::Solvable> successfullyInstalledPackages;
 
-      if ( commit.transactionSteps.size() ) {
+      if ( commit.streamed || commit.transactionSteps.size() ) {
 
         // create the event loop early
         auto loop = zyppng::EventLoop::create();
@@ -2370,6 +2664,7 @@ namespace zypp
         // 1) Size of the commit message , sizeof(zyppng::rpc::HeaderSizeType)
         // 2) The Commit Proto message, directly serialized to the FD, without Envelope
         // 3) 2 writeable FDs that are set up by the parent Process when forking. The first FD is to be used for message sending, the second one for script output
+        // 4) optionally a 3rd FD referring to the shared memory of the ProgressRing, if the Commit message has progressRing set
 
         constexpr std::string_view zyppRpmBinary(ZYPP_RPM_BINARY);
 
@@ -2396,10 +2691,86 @@ namespace zypp
         prog->addFd( messagePipe->writeFd );
         prog->addFd( scriptPipe->writeFd );
 
+        // high frequency events (progress, rpm log lines) are passed via shared memory if possible,
+        // otherwise zypp-rpm sends them as STOMP messages too
+        auto progressRing = proto::target::ProgressRing::create();
+        if ( progressRing ) {
+          prog->addFd( progressRing.fd() );
+          commit.progressRing = true;
+        } else {
+          WAR << "Failed to create the progress ring (" << str::strerror( errno ) << "), zypp-rpm will send all events as messages" << endl;
+        }
+
         // set up the AsyncDataSource to read script output
         if ( !scriptSource->openFds( std::vector<int>{ scriptPipe->readFd } ) )
           ZYPP_THROW( target::rpm::RpmSubprocessException( "Failed to open scriptFD to subprocess" ) );
 
+        // handlers for the high frequency events, received as STOMP message or via the progressRing
+        const auto &handleRpmLog = [&]( const proto::target::RpmLog &p ) {
+          ( p.level >= RPMLOG_ERR     ? L_ERR("zypp-rpm")
+          : p.level >= RPMLOG_WARNING ? L_WAR("zypp-rpm")
+          : L_DBG("zypp-rpm") ) << "[rpm " << p.level << "> " << p.line; // no endl! - readLine does not trim
+          report.sendLoglineRpm( p.line, p.level );
+        };
+
+        const auto &handlePackageProgress = [&]( const proto::target::PackageProgress &p ) {
+          if ( uninstallreport )
+            (*uninstallreport)->progress( p.amount, makeResObject( steps.at( p.stepId ) ));
+          else if ( installreport )
+            (*installreport)->progress( p.amount, makeResObject( steps.at( p.stepId ) ));
+          else
+            ERR << "Received a " << proto::target::PackageProgress::typeName << " message but there is no corresponding report running." << std::endl;
+        };
+
+        const auto &handleCleanupProgress = [&]( const proto::target::CleanupProgress &p ) {
+          if ( !cleanupreport ) {
+            ERR << "Received a CleanupProgress message, but there is no running report. " << std::endl;
+            return;
+          }
+          (*cleanupreport)->progress( p.amount );
+        };
+
+        const auto &handleTransProgress = [&]( const proto::target::TransProgress &p ) {
+          if ( !transactionreport ) {
+            ERR << "Received a TransactionProgress message, but there is no running report. " << std::endl;
+            return;
+          }
+          (*transactionreport)->progress( p.amount );
+        };
+
+        // number of STOMP messages processed so far. Events in the progressRing remember the
+        // number of messages sent before them, they must be handled before the next message.
+        uint32_t processedMessages = 0;
+
+        const auto &drainProgressRing = [&]() {
+          proto::target::ProgressEvent ev;
+          while ( progressRing.pop( ev, processedMessages ) ) {
+            std::visit( [&]( const auto &p ) {
+              using T = std::decay_t<decltype(p)>;
+              if constexpr ( std::is_same_v<T, proto::target::RpmLog> ) {
+                handleRpmLog( p );
+              } else if constexpr ( std::is_same_v<T, proto::target::PackageProgress> ) {
+                if ( p.stepId < steps.size() )
+                  handlePackageProgress( p );
+                else
+                  ERR << "Received invalid stepId: " << p.stepId << " in " << p.typeName << " event from zypp-rpm, ignoring." << std::endl;
+              } else if constexpr ( std::is_same_v<T, proto::target::CleanupProgress> ) {
+                handleCleanupProgress( p );
+              } else {
+                handleTransProgress( p );
+              }
+            }, ev.toMessage() );
+          }
+        };
+
+        // the events are polled, there is no notification on the STOMP channel
+        auto progressRingTimer = zyppng::Timer::create();
+        if ( progressRing ) {
+          progressRingTimer->setSingleShot( false );
+          progressRingTimer->connectFunc( &zyppng::Timer::sigExpired, [&]( zyppng::Timer & ) { drainProgressRing(); } );
+          progressRingTimer->start( 50 );
+        }
+
         const auto &processMessages = [&] ( ) {
 
           // lambda function that parses the passed message type and checks if the stepId is a valid offset
@@ -2420,6 +2791,10 @@ namespace zypp
 
           while ( const auto &m = msgStream->nextMessage() ) {
 
+            // events zypp-rpm issued before sending this message come first
+            drainProgressRing();
+            ++processedMessages;
+
             // due to librpm behaviour we need to make sense of the order of messages we receive
             // because we first get a PackageFinished BEFORE getting a PackageError, same applies to
             // Script related messages. What we do is remember the current step we are in and only close
@@ -2432,10 +2807,17 @@ namespace zypp
                 ERR << "Failed to parse " << proto::target::RpmLog::typeName << " message from zypp-rpm." << std::endl;
                 continue;
               }
-              ( p->level >= RPMLOG_ERR     ? L_ERR("zypp-rpm")
-              : p->level >= RPMLOG_WARNING ? L_WAR("zypp-rpm")
-              : L_DBG("zypp-rpm") ) << "[rpm " << p->level << "> " << p->line; // no endl! - readLine does not trim
-              report.sendLoglineRpm( p->line, p->level );
+              handleRpmLog( *p );
+
+            } else if (  mName == proto::target::HeaderPreread::typeName )  {
+
+              const auto &p = proto::target::HeaderPreread::fromStompMessage (*m);
+              if ( !p ) {
+                ERR << "Failed to parse " << proto::target::HeaderPreread::typeName << " message from zypp-rpm." << std::endl;
+                continue;
+              }
+              MIL << "zypp-rpm read " << p->headers << " package headers using " << p->threads << " threads in " << p->milliseconds << "ms" << std::endl;
+              result_r.setHeaderPrereadStats( { p->headers, p->threads, p->milliseconds } );
 
             } else if (  mName == proto::target::PackageBegin::typeName )  {
               finalizeCurrentReport();
@@ -2470,12 +2852,7 @@ namespace zypp
               if ( !checkMsgWithStepId( p ) )
                 continue;
 
-              if ( uninstallreport )
-                (*uninstallreport)->progress( p->amount, makeResObject( steps.at( p->stepId ) ));
-              else if ( installreport )
-                (*installreport)->progress( p->amount, makeResObject( steps.at( p->stepId ) ));
-              else
-                ERR << "Received a " << mName << " message but there is no corresponding report running." << std::endl;
+              handlePackageProgress( *p );
 
             } else if (  mName == proto::target::PackageError::typeName )  {
               const auto &p = proto::target::PackageError::fromStompMessage(*m);
@@ -2575,12 +2952,7 @@ namespace zypp
                 continue;
               }
 
-              if ( !cleanupreport ) {
-                ERR << "Received a CleanupProgress message, but there is no running report. " << std::endl;
-                continue;
-              }
-
-              (*cleanupreport)->progress( prog->amount );
+              handleCleanupProgress( *prog );
 
             } else if (  mName == proto::target::TransBegin::typeName ) {
               finalizeCurrentReport();
@@ -2605,12 +2977,7 @@ namespace zypp
                 continue;
               }
 
-              if ( !transactionreport ) {
-                ERR << "Received a TransactionProgress message, but there is no running report. " << std::endl;
-                continue;
-              }
-
-              (*transactionreport)->progress( prog->amount );
+              handleTransProgress( *prog );
             } else if ( mName == proto::target::TransactionError::typeName ) {
 
               const auto &error = proto::target::TransactionError::fromStompMessage(*m);
@@ -2674,6 +3041,27 @@ namespace zypp
           ZYPP_THROW( target::rpm::RpmSubprocessException( prog->execError() ) );
         }
 
+        if ( commit.streamed ) {
+          // pass each step to zypp-rpm as soon as its package is available
+          const auto &streamMessage = [&]( const auto &msg ) {
+            if ( !msgStream->sendMessage( msg ) )
+              return false;
+            msgSource->flush();
+            return msgSource->canWrite();
+          };
+
+          bool streamOk = true;
+          fillTransaction( [&]( proto::target::TransactionStep &&tStep ) {
+            proto::target::CommitSteps msg;
+            msg.transactionSteps.push_back( std::move(tStep) );
+            streamOk = streamMessage( msg );
+            return streamOk;
+          });
+
+          if ( !streamOk || !streamMessage( proto::target::CommitStepsDone() ) )
+            ERR << "Failed to stream the commit steps to zypp-rpm." << endl;
+        }
+
         loop->run();
 
         if ( msgStream ) {
@@ -2683,6 +3071,8 @@ namespace zypp
           // make sure to read ALL available messages
           processMessages();
         }
+        progressRingTimer->stop();
+        drainProgressRing();
 
         // we will not receive a new start message , so we need to manually finalize the last report
         finalizeCurrentReport();
@@ -2817,7 +3207,8 @@ namespace zypp
       // jsc#SLE-5116: Log patch status changes to history
       // NOTE: Should be the last action as it may need to reload
       // the Target in case of an incomplete transaction.
-      logPatchStatusChanges( result_r.transaction(), *this );
+      if ( lastHeap_r || abort )
+        logPatchStatusChanges( result_r.transaction(), *this );
 
       if ( abort ) {
         HistoryLog().comment( "Commit was aborted." );
@@ -2829,14 +3220,22 @@ namespace zypp
 
     rpm::RpmDb & TargetImpl::rpm()
     {
+      waitForBuildCacheAsync();	// RpmDb and librpm are not thread-safe
       return _rpm;
     }
 
     bool TargetImpl::providesFile (const std::string & path_str, const std::string & name_str) const
     {
+      waitForBuildCacheAsync();
       return _rpm.hasFile(path_str, name_str);
     }
 
+    std::string TargetImpl::whoOwnsFile (const std::string & path_str) const
+    {
+      waitForBuildCacheAsync();
+      return _rpm.whoOwnsFile (path_str);
+    }
+
     ///////////////////////////////////////////////////////////////////
     namespace
     {
@@ -21,6 +21,7 @@ extern "C"
 #include <iostream>
 #include <unordered_set>
 #include <string>
+#include <vector>
 
 #include <zypp/base/LogTools.h>
 #include <zypp/base/Gettext.h>
@@ -33,6 +34,8 @@ extern "C"
 
 #include <zypp/target/TargetImpl.h>
 #include <zypp/target/CommitPackageCache.h>
+#include <zypp/target/InstalledFilesIndex.h>
+#include <zypp/target/IndexedFileConflicts.h>
 
 #include <zypp/ZYppCallbacks.h>
 
@@ -135,9 +138,11 @@ namespace zypp
           ZYPP_THROW( AbortRequestException() );
 
         FileConflictsCB cb( sat::Pool::instance().get(), progress );
+        sat::Queue indexedNoFilelist;
+        const sat::Queue * noFilelist = &indexedNoFilelist;
         // lambda receives progress trigger and translates into report
         auto sendProgress = [&]( const ProgressData & progress_r )->bool {
-          if ( ! report->progress( progress_r, cb.noFilelist() ) )
+          if ( ! report->progress( progress_r, *noFilelist ) )
           {
             progress.noSend();	// take care progress DTOR does not trigger a final report (2nd exeption)
             ZYPP_THROW( AbortRequestException() );
@@ -146,7 +151,74 @@ namespace zypp
         };
         progress.sendTo( sendProgress );
 
-        unsigned count =
+        // Prefer the installed files index, so no installed header needs to be read.
+        unsigned count = 0;
+        bool indexed = false;
+        {
+          Pathname indexfile { installedFilesIndexPath() };
+          std::string cookie { rpmDbCookie() };
+          std::unique_ptr<InstalledFilesIndex> index { new InstalledFilesIndex( indexfile, cookie ) };
+          if ( ! *index )
+          {
+            try
+            {
+              InstalledFilesIndex::update( _root, cookie, indexfile );
+              index.reset( new InstalledFilesIndex( indexfile, cookie ) );
+            }
+            catch ( const Exception & excpt )
+            {
+              ZYPP_CAUGHT( excpt );
+              WAR << "No installed files index available." << endl;
+            }
+          }
+          if ( *index )
+          {
+            MIL << "Using " << *index << endl;
+            std::string rootdir;
+            if ( const char * root = ::pool_get_rootdir( sat::Pool::instance().get() ) )
+              rootdir = root;
+            IndexedFileConflicts fileconflicts( *index, rootdir );
+
+            // Collect the rpm files here, the pool must not be accessed by the threads.
+            std::vector<IndexedFileConflicts::Candidate> candidates;
+            for ( int i = 0; i < newpkgs; ++i )
+            {
+              sat::Solvable solv( todo[i] );
+              Package::Ptr pkg( make<Package>( solv ) );
+              if ( ! pkg )
+                continue;	// only packages have filelists
+              Pathname localfile( pkg->cachedLocation() );
+              if ( localfile.empty() )
+                indexedNoFilelist.push( solv.id() );
+              else
+                candidates.push_back( { solv.id(), localfile } );
+            }
+            // The installed packages remaining after commit (by rpmdbid)
+            for ( unsigned i = newpkgs; i < todo.size(); ++i )
+            {
+              sat::Solvable solv( todo[i] );
+              if ( ! solv.isSystem() )
+                continue;
+              ::Solvable * s = solv.get();
+              if ( s->repo->rpmdbid && s->repo->rpmdbid[solv.id() - s->repo->start] )
+                fileconflicts.addInstalled( s->repo->rpmdbid[solv.id() - s->repo->start], solv.id() );
+            }
+
+            fileconflicts.readCandidates( candidates, progress, indexedNoFilelist );
+            if ( ! fileconflicts.aliasingInvolved() )
+            {
+              fileconflicts.findConflicts( conflicts );
+              count = conflicts.size();
+              indexed = true;
+            }
+          }
+        }
+
+        if ( ! indexed )
+        {
+          noFilelist = &cb.noFilelist();
+          progress.set( 0 );
+          count =
           ::pool_findfileconflicts( sat::Pool::instance().get(),
                                     todo,
                                     newpkgs,
@@ -154,11 +226,12 @@ namespace zypp
                                     FINDFILECONFLICTS_USE_SOLVABLEFILELIST | FINDFILECONFLICTS_CHECK_DIRALIASING | FINDFILECONFLICTS_USE_ROOTDIR,
                                     &FileConflictsCB::invoke,
                                     &cb );
+        }
         progress.toMax();
         progress.noSend();
 
         (count?WAR:MIL) << "Found " << count << " file conflicts." << endl;
-        if ( ! report->result( progress, cb.noFilelist(), conflicts ) )
+        if ( ! report->result( progress, *noFilelist, conflicts ) )
           ZYPP_THROW( AbortRequestException() );
       }
       catch ( const AbortRequestException & e )
@@ -14,6 +14,7 @@
 
 #include <iosfwd>
 #include <set>
+#include <future>
 
 #include <zypp/base/ReferenceCounted.h>
 #include <zypp/base/NonCopyable.h>
@@ -98,6 +99,13 @@ namespace zypp
 
       Pathname _tmpSolvfilesPath;
 
+      /** The \ref InstalledFilesIndex file (along with the solv file). */
+      Pathname installedFilesIndexPath() const
+      { return solvfilesPath() / "files"; }
+
+      /** Hash of the rpmdb state (the \ref InstalledFilesIndex cookie). */
+      std::string rpmDbCookie() const;
+
     public:
       void load( bool force = true );
 
@@ -108,6 +116,23 @@ namespace zypp
       void clearCache();
 
       bool buildCache();
+
+      /** \ref buildCache in a background thread (after a commit not followed by a \ref load,
+       * i.e. unless \ref ZYppCommitPolicy::syncPoolAfterCommit).
+       * Requires the in-process rpmdb conversion. Any subsequent solv
+       * file or rpmdb access (\ref buildCache, \ref load, \ref clearCache,
+       * \ref rpm, \ref providesFile, \ref whoOwnsFile) waits for it to finish.
+       * Other librpm users wait for the \ref rpm::librpmDb::globalLock held by the thread.
+       * The PACKAGESETCHANGED plugin notification is sent by the thread
+       * waiting for the new solv file, not when starting the update.
+       */
+      void buildCacheAsync();
+
+    private:
+      /** Wait for a running \ref buildCacheAsync to finish and send PACKAGESETCHANGED if the solv file was updated. */
+      void waitForBuildCacheAsync() const;
+
+      mutable std::future<bool> _buildCacheAsync;
       //@}
 
     public:
@@ -145,8 +170,7 @@ namespace zypp
 
       /** Return name of package owning \a path_str
        * or empty string if no installed package owns \a path_str. */
-      std::string whoOwnsFile (const std::string & path_str) const
-      { return _rpm.whoOwnsFile (path_str); }
+      std::string whoOwnsFile (const std::string & path_str) const;
 
       /** \copydoc Target::baseProduct() */
       Product::constPtr baseProduct() const;
@@ -204,15 +228,19 @@ namespace zypp
 
   public:
     private:
-      /** Commit ordered changes (internal helper) */
+      /** Commit ordered changes (internal helper)
+       * Committing in heaps, \a lastHeap_r tells whether it's the last heap.
+       */
       void commit( const ZYppCommitPolicy & policy_r,
                    CommitPackageCache & packageCache_r,
-                   ZYppCommitResult & result_r );
+                   ZYppCommitResult & result_r,
+                   bool lastHeap_r = true );
 
-      /** Commit ordered changes (internal helper) */
+      /** Commit ordered changes (internal helper) \see \ref commit */
       void commitInSingleTransaction( const ZYppCommitPolicy & policy_r,
         CommitPackageCache & packageCache_r,
-        ZYppCommitResult & result_r );
+        ZYppCommitResult & result_r,
+        bool lastHeap_r = true );
 
 
       /** Commit helper checking for file conflicts after download. */
@@ -212,7 +212,7 @@ RpmHeader::~RpmHeader()
 RpmHeader::constPtr RpmHeader::readPackage( const Pathname & path_r,
                                             VERIFICATION verification_r )
 {
-
+  std::lock_guard<std::recursive_mutex> guard( librpmDb::globalLock() );
   librpmDb::globalInit();
   zypp::AutoDispose<rpmts> ts ( ::rpmtsCreate(), ::rpmtsFree );
   unsigned vsflag = RPMVSF_DEFAULT;
@@ -227,6 +227,7 @@ RpmHeader::constPtr RpmHeader::readPackage( const Pathname & path_r,
 
 std::pair<RpmHeader::Ptr, int> RpmHeader::readPackage( rpmts ts_r, const zypp::filesystem::Pathname &path_r )
 {
+  std::lock_guard<std::recursive_mutex> guard( librpmDb::globalLock() );
   PathInfo file( path_r );
   if ( ! file.isFile() )
   {
@@ -58,6 +58,7 @@ public:
 
   D(Pathname root_r, Pathname dbPath_r, bool readonly_r)
     : _root(std::move(root_r)), _dbPath(std::move(dbPath_r)), _ts(0) {
+    std::lock_guard<std::recursive_mutex> guard( librpmDb::globalLock() );
     _error.reset();
     // set %_dbpath macro
     ::addMacro( NULL, "_dbpath", NULL, _dbPath.asString().c_str(), RMIL_CMDLINE );
@@ -83,6 +84,7 @@ public:
   {
     if ( _ts )
     {
+      std::lock_guard<std::recursive_mutex> guard( librpmDb::globalLock() );
       ::rpmtsFree(_ts);
     }
   }
@@ -110,6 +112,7 @@ bool librpmDb::_dbBlocked = true;
 //
 bool librpmDb::globalInit()
 {
+  std::lock_guard<std::recursive_mutex> guard( globalLock() );
   static bool initialized = false;
 
   if ( initialized )
@@ -141,6 +144,7 @@ bool librpmDb::globalInit()
 //
 std::string librpmDb::expand( const std::string & macro_r )
 {
+  std::lock_guard<std::recursive_mutex> guard( globalLock() );
   if ( ! globalInit() )
     return macro_r;  // unexpanded
 
@@ -153,6 +157,12 @@ std::string librpmDb::expand( const std::string & macro_r )
   return ret;
 }
 
+std::recursive_mutex & librpmDb::globalLock()
+{
+  static std::recursive_mutex _mutex;
+  return _mutex;
+}
+
 ///////////////////////////////////////////////////////////////////
 //
 //
@@ -523,6 +533,7 @@ public:
   {
     if ( _mi )
     {
+      std::lock_guard<std::recursive_mutex> guard( librpmDb::globalLock() );
       ::rpmdbFreeIterator( _mi );
     }
   }
@@ -536,6 +547,7 @@ public:
     destroy();
     if ( ! _dbptr )
       return false;
+    std::lock_guard<std::recursive_mutex> guard( librpmDb::globalLock() );
     _mi = ::rpmtsInitIterator( _dbptr->_d._ts, rpmTag(rpmtag), keyp, keylen );
     return _mi;
   }
@@ -548,6 +560,7 @@ public:
   {
     if ( _mi )
     {
+      std::lock_guard<std::recursive_mutex> guard( librpmDb::globalLock() );
       _mi = ::rpmdbFreeIterator( _mi );
       _hptr = 0;
     }
@@ -568,6 +581,7 @@ public:
   {
     if ( !_mi )
       return false;
+    std::lock_guard<std::recursive_mutex> guard( librpmDb::globalLock() );
     Header h = ::rpmdbNextIterator( _mi );
     if ( ! h )
     {
@@ -596,6 +610,7 @@ public:
   {
     if ( ! create( RPMDBI_PACKAGES ) )
       return false;
+    std::lock_guard<std::recursive_mutex> guard( librpmDb::globalLock() );
 #ifdef RPMFILEITERMAX	// since rpm.4.12
     ::rpmdbAppendIterator( _mi, (const unsigned *)&off_r, 1 );
 #else
@@ -606,6 +621,7 @@ public:
 
   unsigned offset()
   {
+    std::lock_guard<std::recursive_mutex> guard( librpmDb::globalLock() );
     return( _mi ? ::rpmdbGetIteratorOffset( _mi ) : 0 );
   }
 
@@ -613,6 +629,7 @@ public:
   {
     if ( !_mi )
       return 0;
+    std::lock_guard<std::recursive_mutex> guard( librpmDb::globalLock() );
     int ret = ::rpmdbGetIteratorCount( _mi );
     return( ret ? ret : -1 ); // -1: sequential access
   }
@@ -13,6 +13,7 @@
 #define librpmDb_h
 
 #include <iosfwd>
+#include <mutex>
 
 #include <zypp/base/ReferenceCounted.h>
 #include <zypp/base/NonCopyable.h>
@@ -124,6 +125,15 @@ public:
    **/
   static std::string expand( const std::string & macro_r );
 
+  /**
+   * Lock serializing the use of librpm's global state (config, macros,
+   * rpmdb and transaction sets), which is not thread-safe. A thread
+   * using librpm besides the main thread (e.g. the background solv file
+   * update) holds it while it runs. The librpm calls made here and in
+   * \ref RpmHeader::readPackage acquire it, so they wait for that thread.
+   **/
+  static std::recursive_mutex & globalLock();
+
   /**
    * @return String '(root_r)sub_r' used in debug output.
    **/
@@ -13,6 +13,7 @@
 #define ZYPP_UI_SELECTABLEIMPL_H
 
 #include <iostream>
+#include <algorithm>
 #include <zypp/base/LogTools.h>
 
 #include <zypp/base/PtrTypes.h>
@@ -65,7 +66,16 @@ namespace zypp
       : _ident( sat::Solvable::SplitIdent( kind_r, name_r ).ident() )
       , _kind( kind_r )
       , _name( name_r )
+      { setItems( begin_r, end_r ); }
+
+      /** Replace the items after the pool content changed.
+       * A userCandidate no longer among the available items is dropped.
+       */
+      template <class TIterator>
+      void setItems( TIterator begin_r, TIterator end_r )
       {
+        _installedItems.clear();
+        _availableItems.clear();
         for_( it, begin_r, end_r )
         {
           if ( it->status().isInstalled() )
@@ -73,6 +83,9 @@ namespace zypp
           else
             _availableItems.insert( *it );
         }
+        if ( _candidate && std::find( _availableItems.begin(), _availableItems.end(), _candidate ) == _availableItems.end() )
+          _candidate = PoolItem();
+        _picklistPtr.reset();
       }
 
     public:
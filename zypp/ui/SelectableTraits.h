@@ -53,30 +53,30 @@ namespace zypp
           if ( lhs.isBlacklisted() != rhs.isBlacklisted() )
             return rhs.isBlacklisted();
 
-          int lprio = lhs->satSolvable().repository().satInternalPriority();
-          int rprio = rhs->satSolvable().repository().satInternalPriority();
+          int lprio = lhs.repository().satInternalPriority();
+          int rprio = rhs.repository().satInternalPriority();
           if ( lprio != rprio )
             return( lprio > rprio );
 
           // arch/noarch changes are ok.
-          if ( lhs->arch() != Arch_noarch && rhs->arch() != Arch_noarch )
+          if ( lhs.arch() != Arch_noarch && rhs.arch() != Arch_noarch )
           {
-            int res = lhs->arch().compare( rhs->arch() );
+            int res = lhs.arch().compare( rhs.arch() );
             if ( res )
               return res > 0;
           }
 
-          int res = lhs->edition().compare( rhs->edition() );
+          int res = lhs.edition().compare( rhs.edition() );
           if ( res )
             return res > 0;
 
-          lprio = lhs->buildtime();
-          rprio = rhs->buildtime();
+          lprio = lhs.buildtime();
+          rprio = rhs.buildtime();
           if ( lprio != rprio )
             return( lprio > rprio );
 
-          lprio = lhs->satSolvable().repository().satInternalSubPriority();
-          rprio = rhs->satSolvable().repository().satInternalSubPriority();
+          lprio = lhs.repository().satInternalSubPriority();
+          rprio = rhs.repository().satInternalSubPriority();
           if ( lprio != rprio )
             return( lprio > rprio );
 
@@ -99,14 +99,14 @@ namespace zypp
         //
         bool operator()( const PoolItem & lhs, const PoolItem & rhs ) const
         {
-          int res = lhs->arch().compare( rhs->arch() );
+          int res = lhs.arch().compare( rhs.arch() );
           if ( res )
             return res > 0;
-          res = lhs->edition().compare( rhs->edition() );
+          res = lhs.edition().compare( rhs.edition() );
           if ( res )
             return res > 0;
-          Date ldate = lhs->installtime();
-          Date rdate = rhs->installtime();
+          Date ldate = lhs.installtime();
+          Date rdate = rhs.installtime();
           if ( ldate != rdate )
             return( ldate > rdate );
 